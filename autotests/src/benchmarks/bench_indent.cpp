@@ -0,0 +1,132 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include <kateconfig.h>
+#include <katedocument.h>
+#include <kateglobal.h>
+#include <katenativeindenter.h>
+#include <kateview.h>
+
+#include <QScopeGuard>
+
+/**
+ * Performance benchmark for the indenters, both the native implementations
+ * and the JavaScript indentation scripts they replace.
+ *
+ * benchmarkFirstIndent measures the first indentation in a fresh process, this includes the
+ * creation of the script engine and loading of the indenter and its libraries.
+ * benchmarkIndent measures the per line/keystroke cost of an already loaded indenter.
+ */
+class IndentBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    IndentBenchmark()
+    {
+        KTextEditor::EditorPrivate::enableUnitTestMode();
+    }
+
+private Q_SLOTS:
+    void benchmarkFirstIndent_data();
+    void benchmarkFirstIndent();
+    void benchmarkIndent_data();
+    void benchmarkIndent();
+};
+
+static constexpr int lines = 10000;
+
+static void indentTestData()
+{
+    QTest::addColumn<QString>("indenter");
+    QTest::addColumn<QString>("highlighting");
+    QTest::addColumn<QString>("block");
+    QTest::addColumn<bool>("native");
+
+    const QString cstyleBlock = QStringLiteral("int foo(int a, int b)\n{\n    if (a < b) {\n        return a;\n    }\n    return b;\n}\n");
+    const QString pythonBlock = QStringLiteral("def foo(a, b):\n    if a < b:\n        return a\n    return b\n\n");
+    QTest::newRow("cstyle") << QStringLiteral("cstyle") << QStringLiteral("C++") << cstyleBlock << true;
+    QTest::newRow("cstyle-script") << QStringLiteral("cstyle") << QStringLiteral("C++") << cstyleBlock << false;
+    QTest::newRow("python") << QStringLiteral("python") << QStringLiteral("Python") << pythonBlock << true;
+    QTest::newRow("python-script") << QStringLiteral("python") << QStringLiteral("Python") << pythonBlock << false;
+}
+
+static void setupDocument(KTextEditor::DocumentPrivate &doc, const QString &indenter, const QString &highlighting, const QString &block)
+{
+    QString text;
+    text.reserve(block.size() * (lines / block.count(QLatin1Char('\n')) + 1));
+    while (text.count(QLatin1Char('\n')) < lines) {
+        text += block;
+    }
+    doc.setText(text);
+    doc.setHighlightingMode(highlighting);
+    doc.config()->setIndentationMode(indenter);
+}
+
+void IndentBenchmark::benchmarkFirstIndent_data()
+{
+    indentTestData();
+}
+
+void IndentBenchmark::benchmarkFirstIndent()
+{
+    QFETCH(QString, indenter);
+    QFETCH(QString, highlighting);
+    QFETCH(QString, block);
+    QFETCH(bool, native);
+
+    KateNativeIndenter::setEnabled(native);
+    const auto restore = qScopeGuard([] {
+        KateNativeIndenter::setEnabled(true);
+    });
+
+    KTextEditor::DocumentPrivate doc;
+    KTextEditor::ViewPrivate view(&doc, nullptr);
+    setupDocument(doc, indenter, highlighting, block);
+
+    // each indenter loads lazily on first use, this run is the only cold one in this process
+    const int line = doc.lines() / 2;
+    QBENCHMARK_ONCE {
+        doc.align(&view, KTextEditor::Range(line, 0, line, 0));
+    }
+}
+
+void IndentBenchmark::benchmarkIndent_data()
+{
+    indentTestData();
+}
+
+void IndentBenchmark::benchmarkIndent()
+{
+    QFETCH(QString, indenter);
+    QFETCH(QString, highlighting);
+    QFETCH(QString, block);
+    QFETCH(bool, native);
+
+    KateNativeIndenter::setEnabled(native);
+    const auto restore = qScopeGuard([] {
+        KateNativeIndenter::setEnabled(true);
+    });
+
+    KTextEditor::DocumentPrivate doc;
+    KTextEditor::ViewPrivate view(&doc, nullptr);
+    setupDocument(doc, indenter, highlighting, block);
+
+    // warm up, loads the indenter
+    const int line = doc.lines() / 2;
+    doc.align(&view, KTextEditor::Range(line, 0, line, 0));
+
+    // one indenter invocation per iteration, like pressing enter
+    QBENCHMARK {
+        doc.align(&view, KTextEditor::Range(line, 0, line, 0));
+    }
+}
+
+QTEST_MAIN(IndentBenchmark)
+
+#include "bench_indent.moc"
@@ -0,0 +1,104 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include <inputmode/kateviinputmode.h>
+#include <katedocument.h>
+#include <kateglobal.h>
+#include <kateview.h>
+#include <vimode/globalstate.h>
+#include <vimode/inputmodemanager.h>
+#include <vimode/keymapper.h>
+#include <vimode/mappings.h>
+
+using namespace KateVi;
+
+/**
+ * Performance benchmark for the vi mode key mapping lookup done for each keypress,
+ * with many mappings like in a large vimrc.
+ */
+class KeyMapperBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    KeyMapperBenchmark()
+    {
+        KTextEditor::EditorPrivate::enableUnitTestMode();
+    }
+
+private Q_SLOTS:
+    void benchmarkMatch_data();
+    void benchmarkMatch();
+    void benchmarkHandleKeypress_data();
+    void benchmarkHandleKeypress();
+};
+
+static void addMappings(Mappings *mappings, int count)
+{
+    mappings->clear(Mappings::NormalModeMapping);
+    for (int i = 0; i < count; ++i) {
+        mappings->add(Mappings::NormalModeMapping, QStringLiteral(",%1").arg(i, 4, 10, QLatin1Char('0')), QStringLiteral("x"), Mappings::Recursive);
+    }
+}
+
+void KeyMapperBenchmark::benchmarkMatch_data()
+{
+    QTest::addColumn<QString>("keys");
+
+    QTest::newRow("none") << QStringLiteral("j");
+    QTest::newRow("partial") << QStringLiteral(",012");
+    QTest::newRow("full") << QStringLiteral(",0123");
+}
+
+void KeyMapperBenchmark::benchmarkMatch()
+{
+    QFETCH(QString, keys);
+
+    Mappings mappings;
+    addMappings(&mappings, 1000);
+
+    bool isFullMapping = false;
+    bool isPartialMapping = false;
+    QBENCHMARK {
+        mappings.match(Mappings::NormalModeMapping, keys, isFullMapping, isPartialMapping);
+    }
+    QCOMPARE(isFullMapping, keys.size() == 5);
+    QCOMPARE(isPartialMapping, keys.size() == 4);
+}
+
+void KeyMapperBenchmark::benchmarkHandleKeypress_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("no mappings") << 0;
+    QTest::newRow("1000 mappings") << 1000;
+}
+
+void KeyMapperBenchmark::benchmarkHandleKeypress()
+{
+    QFETCH(int, count);
+
+    KTextEditor::DocumentPrivate doc;
+    KTextEditor::ViewPrivate view(&doc, nullptr);
+    view.setInputMode(KTextEditor::View::ViInputMode);
+    auto viInputMode = static_cast<KateViInputMode *>(view.currentInputMode());
+    Mappings *mappings = viInputMode->globalState()->mappings();
+    addMappings(mappings, count);
+
+    // a key that is no mapping, like most keypresses while editing
+    KeyMapper *keyMapper = viInputMode->viInputModeManager()->keyMapper();
+    QBENCHMARK {
+        keyMapper->handleKeypress(QLatin1Char('j'));
+    }
+
+    mappings->clear(Mappings::NormalModeMapping);
+}
+
+QTEST_MAIN(KeyMapperBenchmark)
+
+#include "bench_keymapper.moc"
@@ -0,0 +1,80 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include <katedocument.h>
+#include <kateglobal.h>
+#include <kateview.h>
+
+using namespace KTextEditor;
+
+/**
+ * Performance benchmark for typing with many cursors, in many lines
+ * or all in one line.
+ */
+class MulticursorBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    MulticursorBenchmark()
+    {
+        KTextEditor::EditorPrivate::enableUnitTestMode();
+    }
+
+private Q_SLOTS:
+    void benchmarkTypeWithManyCursors_data();
+    void benchmarkTypeWithManyCursors();
+};
+
+void MulticursorBenchmark::benchmarkTypeWithManyCursors_data()
+{
+    QTest::addColumn<int>("cursors");
+    QTest::addColumn<bool>("sameLine");
+
+    QTest::newRow("10k lines") << 10000 << false;
+    QTest::newRow("100k lines") << 100000 << false;
+    QTest::newRow("10k on one line") << 10000 << true;
+    QTest::newRow("100k on one line") << 100000 << true;
+}
+
+void MulticursorBenchmark::benchmarkTypeWithManyCursors()
+{
+    QFETCH(int, cursors);
+    QFETCH(bool, sameLine);
+
+    // like a csv file, a cursor in front of each field
+    QString text;
+    QVector<Cursor> positions;
+    positions.reserve(cursors);
+    for (int i = 0; i < cursors; ++i) {
+        if (sameLine) {
+            positions.append(Cursor(0, text.size()));
+            text += QStringLiteral("field,");
+        } else {
+            positions.append(Cursor(i, 0));
+            text += QStringLiteral("field,field\n");
+        }
+    }
+
+    DocumentPrivate doc;
+    doc.setText(text);
+    ViewPrivate view(&doc, nullptr);
+    view.setCursors(positions);
+    QCOMPARE(view.cursors().size(), cursors);
+
+    QBENCHMARK_ONCE {
+        doc.typeChars(&view, QStringLiteral("x"));
+        view.backspace();
+    }
+    QCOMPARE(doc.text(), text);
+    QCOMPARE(view.cursors().size(), cursors);
+}
+
+QTEST_MAIN(MulticursorBenchmark)
+
+#include "bench_multicursor.moc"
@@ -0,0 +1,66 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include <kateglobal.h>
+#include <kateregexpsearch.h>
+
+/**
+ * Performance benchmark for building the replacements of a replace all,
+ * parsing the replacement pattern once versus once per match.
+ */
+class ReplacementBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    ReplacementBenchmark()
+    {
+        KTextEditor::EditorPrivate::enableUnitTestMode();
+    }
+
+private Q_SLOTS:
+    void benchmarkReplacementTemplate_data();
+    void benchmarkReplacementTemplate();
+};
+
+void ReplacementBenchmark::benchmarkReplacementTemplate_data()
+{
+    QTest::addColumn<bool>("parseOnce");
+
+    QTest::newRow("parse once") << true;
+    QTest::newRow("parse per match") << false;
+}
+
+void ReplacementBenchmark::benchmarkReplacementTemplate()
+{
+    QFETCH(bool, parseOnce);
+
+    // the replacements of 1M matches with back-references, like a replace all over a huge file
+    const QString pattern = QStringLiteral("\\2 = \\u\\1(\\0);\\n");
+    const QStringList capturedTexts = QStringList() << QStringLiteral("value") << QStringLiteral("value") << QStringLiteral("int");
+    const int matches = 1000000;
+
+    qsizetype length = 0;
+    QBENCHMARK_ONCE {
+        if (parseOnce) {
+            const KateRegExpSearch::ReplacementTemplate replacementTemplate(pattern);
+            for (int i = 0; i < matches; ++i) {
+                length += replacementTemplate.build(capturedTexts, i).size();
+            }
+        } else {
+            for (int i = 0; i < matches; ++i) {
+                length += KateRegExpSearch::buildReplacement(pattern, capturedTexts, i).size();
+            }
+        }
+    }
+    QCOMPARE(length, qsizetype(matches) * QStringLiteral("int = Value(value);\n").size());
+}
+
+QTEST_MAIN(ReplacementBenchmark)
+
+#include "bench_replacement.moc"
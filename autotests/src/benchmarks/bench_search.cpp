@@ -23,6 +23,11 @@ int main(int argc, char *argv[])
                                QStringLiteral("iters"),
                                QStringLiteral("0"));
     p.addOption(iterOpt);
+    // search modes, e.g. -i 1000000 -c -w for a case insensitive whole word search on 1M lines
+    QCommandLineOption caseInsensitiveOpt(QStringLiteral("c"), QStringLiteral("Search case insensitive"));
+    p.addOption(caseInsensitiveOpt);
+    QCommandLineOption wholeWordsOpt(QStringLiteral("w"), QStringLiteral("Search whole words only"));
+    p.addOption(wholeWordsOpt);
 
     p.process(app);
     bool ok = false;
@@ -41,7 +46,7 @@ int main(int argc, char *argv[])
     QStringList l;
     l.reserve(linesInText);
     for (int i = 0; i < linesInText; ++i) {
-        l.append(QStringLiteral("This is a long long long sentence."));
+        l.append(QStringLiteral("This is a long Long long sentence, belonging to nobody."));
     }
     doc.setText(l);
 
@@ -49,7 +54,8 @@ int main(int argc, char *argv[])
         w->close();
     });
 
-    bar.setSearchMode(KateSearchBar::SearchMode::MODE_PLAIN_TEXT);
+    bar.setSearchMode(p.isSet(wholeWordsOpt) ? KateSearchBar::SearchMode::MODE_WHOLE_WORDS : KateSearchBar::SearchMode::MODE_PLAIN_TEXT);
+    bar.setMatchCase(!p.isSet(caseInsensitiveOpt));
     bar.setSearchPattern(QStringLiteral("long"));
 
     bar.findAll();
@@ -0,0 +1,85 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include <katedocument.h>
+#include <kateglobal.h>
+#include <kateview.h>
+
+/**
+ * Performance benchmark for undo and redo of large groups, like the ones
+ * created by a replace all in a large document.
+ */
+class UndoBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    UndoBenchmark()
+    {
+        KTextEditor::EditorPrivate::enableUnitTestMode();
+    }
+
+private Q_SLOTS:
+    void benchmarkUndoRedo_data();
+    void benchmarkUndoRedo();
+};
+
+static constexpr int lines = 100000;
+
+void UndoBenchmark::benchmarkUndoRedo_data()
+{
+    QTest::addColumn<bool>("replace");
+    QTest::addColumn<bool>("wrap");
+
+    // one item per line
+    QTest::newRow("insert") << false << false;
+    // two items per line, the removal and the insertion of the replacement
+    QTest::newRow("replace") << true << false;
+    // items that change the line count, always replayed through the document
+    QTest::newRow("wrap") << false << true;
+}
+
+void UndoBenchmark::benchmarkUndoRedo()
+{
+    QFETCH(bool, replace);
+    QFETCH(bool, wrap);
+
+    KTextEditor::DocumentPrivate doc;
+    KTextEditor::ViewPrivate view(&doc, nullptr);
+
+    QString text;
+    text.reserve(lines * 12);
+    for (int i = 0; i < lines; ++i) {
+        text += QStringLiteral("foo bar baz\n");
+    }
+    doc.setText(text);
+
+    // one undo group, like a replace all
+    doc.editStart();
+    for (int line = 0; line < lines; ++line) {
+        if (wrap) {
+            doc.editWrapLine(line * 2, 4);
+        } else if (replace) {
+            doc.editRemoveText(line, 4, 3);
+            doc.editInsertText(line, 4, QStringLiteral("quux"));
+        } else {
+            doc.editInsertText(line, 0, QStringLiteral("x"));
+        }
+    }
+    doc.editEnd();
+    QCOMPARE(doc.undoCount(), 1u);
+
+    QBENCHMARK {
+        doc.undo();
+        doc.redo();
+    }
+}
+
+QTEST_MAIN(UndoBenchmark)
+
+#include "bench_undo.moc"
@@ -15,7 +15,9 @@
 
 #include "kateconfig.h"
 #include "katedocument.h"
+#include "katenativeindenter.h"
 
+#include <QScopeGuard>
 #include <QTest>
 
 #include "testutils.h"
@@ -53,6 +55,21 @@ void IndentTest::testCstyle()
                            << FAILURE("switch13", "pure insanity, whoever wrote this test and expects that to be indented properly should stop writing code"));
 }
 
+void IndentTest::testCstyleScript_data()
+{
+    getTestData(QStringLiteral("cstyle"));
+}
+
+void IndentTest::testCstyleScript()
+{
+    // same data as testCstyle, with the JavaScript indenter instead of the native one
+    KateNativeIndenter::setEnabled(false);
+    const auto restore = qScopeGuard([] {
+        KateNativeIndenter::setEnabled(true);
+    });
+    testCstyle();
+}
+
 void IndentTest::testCppstyle_data()
 {
     getTestData(QStringLiteral("cppstyle"));
@@ -85,6 +102,21 @@ void IndentTest::testPython()
     runTest(ExpectedFailures());
 }
 
+void IndentTest::testPythonScript_data()
+{
+    getTestData(QStringLiteral("python"));
+}
+
+void IndentTest::testPythonScript()
+{
+    // same data as testPython, with the JavaScript indenter instead of the native one
+    KateNativeIndenter::setEnabled(false);
+    const auto restore = qScopeGuard([] {
+        KateNativeIndenter::setEnabled(true);
+    });
+    testPython();
+}
+
 void IndentTest::testJulia_data()
 {
     getTestData(QStringLiteral("julia"));
@@ -17,12 +17,16 @@ private Q_SLOTS:
 
     void testPython_data();
     void testPython();
+    void testPythonScript_data();
+    void testPythonScript();
 
     void testJulia_data();
     void testJulia();
 
     void testCstyle_data();
     void testCstyle();
+    void testCstyleScript_data();
+    void testCstyleScript();
 
     void testCppstyle_data();
     void testCppstyle();
@@ -492,6 +492,42 @@ void KateDocumentTest::testDigest()
     QCOMPARE(docDigest, fileDigest);
 }
 
+void KateDocumentTest::testSaveDigest_data()
+{
+    QTest::addColumn<QString>("block");
+    QTest::addColumn<int>("repeat");
+
+    const QString block = QStringLiteral("line with umlauts \u00e4\u00f6\u00fc\n\tand a tab\n\nand an empty line before\n");
+    QTest::newRow("small") << block << 10;
+    // the size in the digest header is computed upfront, also for characters outside the BMP
+    QTest::newRow("astral") << QStringLiteral("smile \U0001F600 for \u20ac 5\n") << 10;
+    // large enough to be encoded in parallel
+    QTest::newRow("large") << block << 200000;
+}
+
+// saving computes the checksum on the fly, make sure it is the one of the written file
+void KateDocumentTest::testSaveDigest()
+{
+    QFETCH(QString, block);
+    QFETCH(int, repeat);
+
+    KTextEditor::DocumentPrivate doc;
+    doc.setText(block.repeated(repeat));
+
+    QTemporaryFile file(QStringLiteral("testSaveDigest"));
+    QVERIFY(file.open());
+    QVERIFY(doc.saveAs(QUrl::fromLocalFile(file.fileName())));
+    const QByteArray savedDigest = doc.checksum();
+    QVERIFY(!savedDigest.isEmpty());
+
+    QFile saved(file.fileName());
+    QVERIFY(saved.open(QIODevice::ReadOnly));
+    QCOMPARE(saved.readAll(), doc.text().toUtf8());
+
+    QVERIFY(doc.createDigest());
+    QCOMPARE(savedDigest.toHex(), doc.checksum().toHex());
+}
+
 void KateDocumentTest::testModelines()
 {
     // honor document variable indent-width
@@ -726,6 +762,11 @@ void KateDocumentTest::testMatchingBracket_data()
     QTest::addRow("(-before") << QStringLiteral("(\n)") << KTextEditor::Cursor(0, 0) << KTextEditor::Range({0, 0}, {1, 0}) << 10;
     QTest::addRow("(-after") << QStringLiteral("(\n)") << KTextEditor::Cursor(0, 1) << KTextEditor::Range({0, 0}, {1, 0}) << 10;
     QTest::addRow("]-maxlines") << QStringLiteral("[\n\n]") << KTextEditor::Cursor(1, 0) << KTextEditor::Range::invalid() << 1;
+    QTest::addRow("(-nested") << QStringLiteral("(a(b)\n(c)\n)") << KTextEditor::Cursor(0, 0) << KTextEditor::Range({0, 0}, {2, 0}) << -1;
+    QTest::addRow(")-nested") << QStringLiteral("(a(b)\n(c)\n)") << KTextEditor::Cursor(2, 1) << KTextEditor::Range({0, 0}, {2, 0}) << -1;
+    QTest::addRow("{-other-kinds") << QStringLiteral("{ ( ] [ }") << KTextEditor::Cursor(0, 0) << KTextEditor::Range({0, 0}, {0, 8}) << -1;
+    QTest::addRow("{-unmatched") << QStringLiteral("{ {\n}") << KTextEditor::Cursor(0, 0) << KTextEditor::Range::invalid() << -1;
+    QTest::addRow("}-unmatched") << QStringLiteral("{\n} }") << KTextEditor::Cursor(1, 3) << KTextEditor::Range::invalid() << -1;
 }
 
 void KateDocumentTest::testMatchingBracket()
@@ -740,6 +781,58 @@ void KateDocumentTest::testMatchingBracket()
     QCOMPARE(doc.findMatchingBracket(cursor, maxLines), match);
 }
 
+void KateDocumentTest::testMatchingBracketFarAway()
+{
+    // brackets in strings have another attribute and don't count
+    const int lines = 50000;
+    QString text = QStringLiteral("void f() {\n");
+    for (int l = 1; l < lines - 1; ++l) {
+        text += (l % 100 == 0) ? QStringLiteral("    g(\"}\", [] { return (1); });\n") : QStringLiteral("    h(i[0]);\n");
+    }
+    text += QStringLiteral("}");
+
+    KTextEditor::DocumentPrivate doc;
+    doc.setHighlightingMode(QStringLiteral("C++"));
+    doc.setText(text);
+
+    const KTextEditor::Range outer({0, 9}, {lines - 1, 0});
+
+    // a bounded search doesn't highlight the whole document
+    QCOMPARE(doc.findMatchingBracket(outer.start(), -1, 1000), KTextEditor::Range::invalid());
+    QCOMPARE(doc.findMatchingBracket(KTextEditor::Cursor(300, 14), -1, 1000), KTextEditor::Range({300, 14}, {300, 28}));
+
+    QCOMPARE(doc.findMatchingBracket(outer.start()), outer);
+    QCOMPARE(doc.findMatchingBracket(outer.end()), outer);
+    QCOMPARE(doc.findMatchingBracket(KTextEditor::Cursor(300, 14)), KTextEditor::Range({300, 14}, {300, 28}));
+
+    // edits in between are taken into account
+    doc.insertText(KTextEditor::Cursor(lines / 2, 0), QStringLiteral("{"));
+    QCOMPARE(doc.findMatchingBracket(outer.start()), KTextEditor::Range::invalid());
+    QCOMPARE(doc.findMatchingBracket(outer.end()), KTextEditor::Range({lines / 2, 0}, {lines - 1, 0}));
+    doc.insertText(KTextEditor::Cursor(lines / 2 + 1, 0), QStringLiteral("}\n"));
+    QCOMPARE(doc.findMatchingBracket(outer.start()), KTextEditor::Range({0, 9}, {lines, 0}));
+    doc.removeText(KTextEditor::Range({lines / 2, 0}, {lines / 2 + 2, 0}));
+    QCOMPARE(doc.findMatchingBracket(outer.start()), KTextEditor::Range({0, 9}, {lines - 2, 0}));
+}
+
+void KateDocumentTest::testMatchingBracketPerformance()
+{
+    const int lines = 200000;
+    QString text = QStringLiteral("{\n");
+    for (int l = 1; l < lines - 1; ++l) {
+        text += QStringLiteral("    call(a[0], {b, c});\n");
+    }
+    text += QStringLiteral("}");
+
+    KTextEditor::DocumentPrivate doc;
+    doc.setText(text);
+
+    QBENCHMARK {
+        QCOMPARE(doc.findMatchingBracket(KTextEditor::Cursor(0, 0)), KTextEditor::Range({0, 0}, {lines - 1, 0}));
+        QCOMPARE(doc.findMatchingBracket(KTextEditor::Cursor(lines - 1, 0)), KTextEditor::Range({0, 0}, {lines - 1, 0}));
+    }
+}
+
 void KateDocumentTest::testIndentOnPaste()
 {
     KTextEditor::DocumentPrivate doc;
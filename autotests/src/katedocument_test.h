@@ -84,6 +84,8 @@ private Q_SLOTS:
     void testAutoBrackets();
     void testReplaceTabs();
     void testDigest();
+    void testSaveDigest_data();
+    void testSaveDigest();
     void testModelines();
     void testDefStyleNum();
     void testTypeCharsWithSurrogateAndNewLine();
@@ -92,6 +94,8 @@ private Q_SLOTS:
     void testSearch();
     void testMatchingBracket_data();
     void testMatchingBracket();
+    void testMatchingBracketFarAway();
+    void testMatchingBracketPerformance();
     void testIndentOnPaste();
     void testAboutToSave();
     void testKeepUndoOverReload();
@@ -154,3 +154,33 @@ void KateTextBlockTest::testTextRanges()
 
     block.clearLines();
 }
+
+void KateTextBlockTest::testSearchIndexOutdated()
+{
+    TextBuffer buf(nullptr);
+    TextBlock block(&buf, 0);
+
+    block.appendLine(QStringLiteral("hello world"));
+    block.buildSearchIndex();
+    const std::vector<uint> world = TextBlock::searchTrigrams(QStringLiteral("world"));
+    QVERIFY(block.mayContain(world));
+    QVERIFY(!block.searchIndexOutdated());
+
+    // the trigrams of removed text stay in the index
+    QString text;
+    block.removeText(KTextEditor::Range(0, 5, 0, 11), text);
+    QCOMPARE(text, QStringLiteral(" world"));
+    QVERIFY(block.mayContain(world));
+    QVERIFY(!block.searchIndexOutdated());
+
+    // until enough got removed, a rebuild drops them
+    block.insertText(KTextEditor::Cursor(0, 5), QString(2000, QLatin1Char('x')));
+    block.removeText(KTextEditor::Range(0, 5, 0, 2005), text);
+    QVERIFY(block.searchIndexOutdated());
+    block.buildSearchIndex();
+    QVERIFY(!block.searchIndexOutdated());
+    QVERIFY(!block.mayContain(world));
+    QVERIFY(block.mayContain(TextBlock::searchTrigrams(QStringLiteral("hello"))));
+
+    block.clearLines();
+}
@@ -12,6 +12,7 @@
 #include <kateglobal.h>
 #include <kateundomanager.h>
 
+#include <QTemporaryFile>
 #include <QTest>
 
 QTEST_MAIN(ModificationSystemTest)
@@ -733,3 +734,102 @@ void ModificationSystemTest::testNavigation()
     QCOMPARE(doc.findTouchedLine(2, up), 2);
     QCOMPARE(doc.findTouchedLine(3, up), -1);
 }
+
+void ModificationSystemTest::testSave()
+{
+    KTextEditor::DocumentPrivate doc;
+    doc.setText(QStringLiteral("line\n").repeated(1000));
+
+    // save once, now all lines are unmodified
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QVERIFY(doc.saveAs(QUrl::fromLocalFile(file.fileName())));
+    clearModificationFlags(&doc);
+
+    // edit two lines in different blocks and save again, only those lines are saved
+    doc.insertText(Cursor(10, 0), QStringLiteral("first "));
+    doc.insertText(Cursor(900, 0), QStringLiteral("second "));
+    QVERIFY(doc.isLineModified(10));
+    QVERIFY(doc.isLineModified(900));
+    QVERIFY(doc.documentSave());
+
+    for (int line : {10, 900}) {
+        QVERIFY(!doc.isLineModified(line));
+        QVERIFY(doc.isLineSaved(line));
+    }
+    QVERIFY(!doc.isLineModified(500));
+    QVERIFY(!doc.isLineSaved(500));
+
+    // undo leaves the saved state, redo brings it back
+    doc.undo();
+    QVERIFY(doc.isLineModified(10));
+    QVERIFY(doc.isLineModified(900));
+    doc.redo();
+    QVERIFY(doc.isLineSaved(10));
+    QVERIFY(doc.isLineSaved(900));
+}
+
+void ModificationSystemTest::testSaveTwice()
+{
+    KTextEditor::DocumentPrivate doc;
+    doc.setText(QStringLiteral("line\n").repeated(1000));
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QVERIFY(doc.saveAs(QUrl::fromLocalFile(file.fileName())));
+    clearModificationFlags(&doc);
+
+    // a line edited before the previous save and not since is still saved after the next one
+    doc.insertText(Cursor(10, 0), QStringLiteral("first "));
+    QVERIFY(doc.documentSave());
+    doc.insertText(Cursor(900, 0), QStringLiteral("second "));
+    QVERIFY(doc.documentSave());
+    QVERIFY(doc.isLineSaved(10));
+    QVERIFY(doc.isLineSaved(900));
+
+    // also when its group is undone and redone
+    doc.undo();
+    doc.undo();
+    QVERIFY(doc.isLineModified(10));
+    QVERIFY(doc.isLineModified(900));
+    doc.redo();
+    QVERIFY(doc.isLineSaved(10));
+    QVERIFY(doc.isLineModified(900));
+    doc.redo();
+    QVERIFY(doc.isLineSaved(900));
+
+    // saving after undo marks the lines of the undone group modified when it is redone
+    doc.undo();
+    QVERIFY(doc.documentSave());
+    doc.redo();
+    QVERIFY(doc.isLineSaved(10));
+    QVERIFY(doc.isLineModified(900));
+}
+
+void ModificationSystemTest::testSaveWrappedLines()
+{
+    KTextEditor::DocumentPrivate doc;
+    doc.setText(QStringLiteral("line\n").repeated(1000));
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QVERIFY(doc.saveAs(QUrl::fromLocalFile(file.fileName())));
+    clearModificationFlags(&doc);
+
+    // join two lines, then wrap a line often enough to split its block, the edited lines move along
+    doc.removeText(Range(Cursor(703, 4), Cursor(704, 0)));
+    for (int i = 0; i < 200; ++i) {
+        doc.insertText(Cursor(100, 2), QStringLiteral("\n"));
+    }
+    QVERIFY(doc.documentSave());
+
+    for (int line = 100; line <= 301; ++line) {
+        QVERIFY(!doc.isLineModified(line));
+        QVERIFY(doc.isLineSaved(line));
+    }
+    QVERIFY(doc.isLineSaved(903));
+    for (int line : {99, 302, 902, 904}) {
+        QVERIFY(!doc.isLineModified(line));
+        QVERIFY(!doc.isLineSaved(line));
+    }
+}
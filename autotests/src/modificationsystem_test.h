@@ -39,6 +39,10 @@ private Q_SLOTS:
     void testUnWrapLine2Empty();
 
     void testNavigation();
+
+    void testSave();
+    void testSaveTwice();
+    void testSaveWrappedLines();
 };
 
 #endif
@@ -333,6 +333,33 @@ void MulticursorTest::insertAutoBrackets()
     QCOMPARE(doc->text(), QStringLiteral("(hello\n(hello"));
 }
 
+void MulticursorTest::insertRemoveManyCursorsOnLine()
+{
+    auto [doc, view] = createDocAndView(QStringLiteral("a,b,c\nd,e,f"), 0, 0);
+    view->setCursors({Cursor(0, 0), Cursor(0, 2), Cursor(0, 4), Cursor(1, 0), Cursor(1, 2), Cursor(1, 4)});
+    QCOMPARE(view->secondaryCursors().size(), 5);
+    doc->undoManager()->undoSafePoint();
+
+    // all cursors of a line are changed in one edit
+    doc->typeChars(view, QStringLiteral("xy"));
+    QCOMPARE(doc->text(), QStringLiteral("xya,xyb,xyc\nxyd,xye,xyf"));
+    QVector<Cursor> expected = {{0, 2}, {0, 6}, {0, 10}, {1, 2}, {1, 6}, {1, 10}};
+    QCOMPARE(view->cursors(), expected);
+    doc->undoManager()->undoSafePoint();
+
+    view->backspace();
+    QCOMPARE(doc->text(), QStringLiteral("xa,xb,xc\nxd,xe,xf"));
+    expected = {{0, 1}, {0, 4}, {0, 7}, {1, 1}, {1, 4}, {1, 7}};
+    QCOMPARE(view->cursors(), expected);
+    QVERIFY(isSorted(view->secondaryCursors()));
+
+    // undo restores the text in between the cursors, too
+    doc->undo();
+    QCOMPARE(doc->text(), QStringLiteral("xya,xyb,xyc\nxyd,xye,xyf"));
+    doc->undo();
+    QCOMPARE(doc->text(), QStringLiteral("a,b,c\nd,e,f"));
+}
+
 void MulticursorTest::testCreateMultiCursor()
 {
     auto [doc, view] = createDocAndView(QStringLiteral("foo\nbar\nfoo\n"), 0, 0);
@@ -965,4 +992,45 @@ void MulticursorTest::testSetGetSelections()
     }
 }
 
+void MulticursorTest::benchTypeWithManyCursors_data()
+{
+    QTest::addColumn<int>("cursors");
+    QTest::addColumn<bool>("sameLine");
+
+    // larger counts are measured by bench_multicursor
+    QTest::newRow("1k lines") << 1000 << false;
+    QTest::newRow("1k on one line") << 1000 << true;
+}
+
+void MulticursorTest::benchTypeWithManyCursors()
+{
+    QFETCH(int, cursors);
+    QFETCH(bool, sameLine);
+
+    // like a csv file, a cursor in front of each field
+    QString text;
+    QVector<Cursor> positions;
+    positions.reserve(cursors);
+    for (int i = 0; i < cursors; ++i) {
+        if (sameLine) {
+            positions.append(Cursor(0, text.size()));
+            text += QStringLiteral("field,");
+        } else {
+            positions.append(Cursor(i, 0));
+            text += QStringLiteral("field,field\n");
+        }
+    }
+
+    auto [doc, view] = createDocAndView(text, 0, 0);
+    view->setCursors(positions);
+    QCOMPARE(view->cursors().size(), cursors);
+
+    QBENCHMARK_ONCE {
+        doc->typeChars(view, QStringLiteral("x"));
+        view->backspace();
+    }
+    QCOMPARE(doc->text(), text);
+    QCOMPARE(view->cursors().size(), cursors);
+}
+
 // kate: indent-mode cstyle; indent-width 4; replace-tabs on;
@@ -36,6 +36,7 @@ private Q_SLOTS:
     static void keyReturnIndentTest();
     static void wrapSelectionWithCharsTest();
     static void insertAutoBrackets();
+    static void insertRemoveManyCursorsOnLine();
 
     // Movement
     static void moveCharTest();
@@ -59,6 +60,10 @@ private Q_SLOTS:
     // API
     static void testSetGetCursors();
     static void testSetGetSelections();
+
+    // Benchmarks
+    static void benchTypeWithManyCursors_data();
+    static void benchTypeWithManyCursors();
 };
 
 #endif // KATE_VIEW_TEST_H
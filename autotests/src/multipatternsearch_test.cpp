@@ -0,0 +1,131 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "multipatternsearch_test.h"
+#include "moc_multipatternsearch_test.cpp"
+
+#include <katedocument.h>
+#include <kateglobal.h>
+
+#include <QTest>
+
+QTEST_MAIN(MultiPatternSearchTest)
+
+using namespace KTextEditor;
+
+using Matches = QVector<QVector<Range>>;
+
+MultiPatternSearchTest::MultiPatternSearchTest()
+    : QObject()
+{
+    KTextEditor::EditorPrivate::enableUnitTestMode();
+}
+
+static const QStringList patterns = {QStringLiteral("he"), QStringLiteral("she"), QStringLiteral("hers"), QStringLiteral("his")};
+
+static QString text()
+{
+    return QStringLiteral(
+        "she sells sea shells\n"
+        "He said: hers");
+}
+
+void MultiPatternSearchTest::testLiterals()
+{
+    KTextEditor::DocumentPrivate doc;
+    doc.setText(text());
+
+    const Matches expected = {
+        {Range(0, 1, 0, 3), Range(0, 15, 0, 17), Range(1, 9, 1, 11)},
+        {Range(0, 0, 0, 3), Range(0, 14, 0, 17)},
+        {Range(1, 9, 1, 13)},
+        {},
+    };
+    QCOMPARE(doc.searchTexts(doc.documentRange(), patterns), expected);
+}
+
+void MultiPatternSearchTest::testCaseInsensitive()
+{
+    KTextEditor::DocumentPrivate doc;
+    doc.setText(text());
+
+    const Matches expected = {
+        {Range(0, 1, 0, 3), Range(0, 15, 0, 17), Range(1, 0, 1, 2), Range(1, 9, 1, 11)},
+        {Range(0, 0, 0, 3), Range(0, 14, 0, 17)},
+        {Range(1, 9, 1, 13)},
+        {},
+    };
+    QCOMPARE(doc.searchTexts(doc.documentRange(), patterns, CaseInsensitive), expected);
+}
+
+void MultiPatternSearchTest::testWholeWords()
+{
+    KTextEditor::DocumentPrivate doc;
+    doc.setText(text());
+
+    const Matches expected = {
+        {},
+        {Range(0, 0, 0, 3)},
+        {Range(1, 9, 1, 13)},
+        {},
+    };
+    QCOMPARE(doc.searchTexts(doc.documentRange(), patterns, WholeWords), expected);
+}
+
+void MultiPatternSearchTest::testOverlappingMatches()
+{
+    KTextEditor::DocumentPrivate doc;
+    doc.setText(QStringLiteral("aaaaa"));
+
+    // the matches of one pattern don't overlap, the ones of different patterns do
+    const Matches expected = {
+        {Range(0, 0, 0, 2), Range(0, 2, 0, 4)},
+        {Range(0, 0, 0, 1), Range(0, 1, 0, 2), Range(0, 2, 0, 3), Range(0, 3, 0, 4), Range(0, 4, 0, 5)},
+    };
+    QCOMPARE(doc.searchTexts(doc.documentRange(), {QStringLiteral("aa"), QStringLiteral("a")}), expected);
+}
+
+void MultiPatternSearchTest::testRange()
+{
+    KTextEditor::DocumentPrivate doc;
+    doc.setText(text());
+
+    // only matches completely inside the range
+    const Matches expected = {
+        {Range(0, 15, 0, 17)},
+        {Range(0, 14, 0, 17)},
+        {},
+        {},
+    };
+    QCOMPARE(doc.searchTexts(Range(0, 2, 1, 10), patterns), expected);
+}
+
+void MultiPatternSearchTest::testRegularExpressions()
+{
+    KTextEditor::DocumentPrivate doc;
+    doc.setText(text());
+
+    // one alternation, the first pattern wins at the same position
+    const Matches expected = {
+        {Range(0, 0, 0, 3), Range(0, 4, 0, 9), Range(0, 10, 0, 13), Range(0, 14, 0, 20), Range(1, 3, 1, 7)},
+        {Range(1, 9, 1, 11)},
+        {},
+    };
+    QCOMPARE(doc.searchTexts(doc.documentRange(), {QStringLiteral("s\\w+"), QStringLiteral("h(e|i)"), QStringLiteral("(invalid")}, Regex), expected);
+}
+
+void MultiPatternSearchTest::testBackReferences()
+{
+    KTextEditor::DocumentPrivate doc;
+    doc.setText(QStringLiteral("aab abb"));
+
+    // back references can't be combined into one alternation
+    const Matches expected = {
+        {Range(0, 0, 0, 2), Range(0, 5, 0, 7)},
+        {Range(0, 2, 0, 3), Range(0, 5, 0, 6), Range(0, 6, 0, 7)},
+    };
+    QCOMPARE(doc.searchTexts(doc.documentRange(), {QStringLiteral("(\\w)\\1"), QStringLiteral("b")}, Regex), expected);
+}
@@ -0,0 +1,29 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KATE_MULTIPATTERNSEARCH_TEST_H
+#define KATE_MULTIPATTERNSEARCH_TEST_H
+
+#include <QObject>
+
+class MultiPatternSearchTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    MultiPatternSearchTest();
+
+private Q_SLOTS:
+    void testLiterals();
+    void testCaseInsensitive();
+    void testWholeWords();
+    void testOverlappingMatches();
+    void testRange();
+    void testRegularExpressions();
+    void testBackReferences();
+};
+
+#endif
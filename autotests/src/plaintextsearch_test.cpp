@@ -8,9 +8,11 @@
 #include "plaintextsearch_test.h"
 #include "moc_plaintextsearch_test.cpp"
 
+#include <kateconfig.h>
 #include <katedocument.h>
 #include <kateglobal.h>
 #include <kateplaintextsearch.h>
+#include <kateregexpsearch.h>
 
 #include <QTest>
 
@@ -155,3 +157,74 @@ void PlainTextSearchTest::testMultilineSearch()
 
     QCOMPARE(m_search->search(pattern, inputRange, false), forwardResult);
 }
+
+void PlainTextSearchTest::testWholeWords_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<bool>("caseSensitive");
+    QTest::addColumn<bool>("backwards");
+    QTest::addColumn<KTextEditor::Range>("inputRange");
+    QTest::addColumn<KTextEditor::Range>("expectedResult");
+
+    QTest::newRow("forward") << "foo" << true << false << KTextEditor::Range(0, 0, 1, 3) << KTextEditor::Range(0, 18, 0, 21);
+    QTest::newRow("forward, case insensitive") << "foo" << false << false << KTextEditor::Range(0, 0, 1, 3) << KTextEditor::Range(0, 0, 0, 3);
+    QTest::newRow("forward, no whole word") << "foo" << true << false << KTextEditor::Range(0, 4, 0, 18) << KTextEditor::Range::invalid();
+    QTest::newRow("backward") << "foo" << true << true << KTextEditor::Range(0, 0, 1, 3) << KTextEditor::Range(1, 0, 1, 3);
+    QTest::newRow("backward, first line") << "foo" << true << true << KTextEditor::Range(0, 0, 0, 29) << KTextEditor::Range(0, 18, 0, 21);
+    QTest::newRow("backward, case insensitive") << "foo" << false << true << KTextEditor::Range(0, 0, 0, 29) << KTextEditor::Range(0, 26, 0, 29);
+    QTest::newRow("backward, no whole word") << "foo" << true << true << KTextEditor::Range(0, 4, 0, 18) << KTextEditor::Range::invalid();
+    QTest::newRow("non-word first character") << "-bar" << true << false << KTextEditor::Range(0, 0, 1, 3) << KTextEditor::Range(0, 21, 0, 25);
+    QTest::newRow("multi-line") << "FOO\nfoo" << true << false << KTextEditor::Range(0, 0, 1, 3) << KTextEditor::Range(0, 26, 1, 3);
+    QTest::newRow("multi-line, no whole word") << "OO\nfoo" << true << false << KTextEditor::Range(0, 0, 1, 3) << KTextEditor::Range::invalid();
+}
+
+void PlainTextSearchTest::testWholeWords()
+{
+    QFETCH(QString, pattern);
+    QFETCH(bool, caseSensitive);
+    QFETCH(bool, backwards);
+    QFETCH(KTextEditor::Range, inputRange);
+    QFETCH(KTextEditor::Range, expectedResult);
+
+    m_doc->setText(
+        QStringLiteral("Foo foobar barfoo foo-bar FOO\n"
+                       "foo"));
+
+    KatePlainTextSearch search(m_doc, caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive, true);
+    QCOMPARE(search.search(pattern, inputRange, backwards), expectedResult);
+}
+
+void PlainTextSearchTest::testSearchIndex()
+{
+    QStringList lines;
+    for (int i = 0; i < 1000; ++i) {
+        lines.append(QStringLiteral("line %1 of the text").arg(i));
+    }
+    lines[10] = QStringLiteral("needle one");
+    lines[900] = QStringLiteral("Needle two");
+    m_doc->setText(lines);
+    m_doc->config()->setSearchIndex(true);
+
+    const KTextEditor::Range all = m_doc->documentRange();
+    const KTextEditor::Range rest(11, 0, 999, 19);
+    KatePlainTextSearch caseInsensitive(m_doc, Qt::CaseInsensitive, false);
+    QCOMPARE(m_search->search(QStringLiteral("needle"), all), KTextEditor::Range(10, 0, 10, 6));
+    QCOMPARE(m_search->search(QStringLiteral("needle"), rest), KTextEditor::Range::invalid());
+    QCOMPARE(caseInsensitive.search(QStringLiteral("needle"), rest), KTextEditor::Range(900, 0, 900, 6));
+    QCOMPARE(caseInsensitive.search(QStringLiteral("needle"), all, true), KTextEditor::Range(900, 0, 900, 6));
+    QCOMPARE(m_search->search(QStringLiteral("one\nline 11"), all), KTextEditor::Range(10, 7, 11, 7));
+
+    // edits update the index of the blocks
+    m_doc->insertText(KTextEditor::Cursor(500, 0), QStringLiteral("xneedle"));
+    QCOMPARE(m_search->search(QStringLiteral("needle"), rest), KTextEditor::Range(500, 1, 500, 7));
+    m_doc->insertText(KTextEditor::Cursor(600, 0), QStringLiteral("nee\ndle"));
+    QCOMPARE(m_search->search(QStringLiteral("needle"), KTextEditor::Range(501, 0, 999, 19)), KTextEditor::Range::invalid());
+    m_doc->removeText(KTextEditor::Range(600, 3, 601, 0));
+    QCOMPARE(m_search->search(QStringLiteral("needle"), KTextEditor::Range(501, 0, 999, 19)), KTextEditor::Range(600, 0, 600, 6));
+
+    // regular expressions use their literal prefix
+    KateRegExpSearch regExpSearch(m_doc);
+    QCOMPARE(regExpSearch.search(QStringLiteral("^Needle t\\w+"), all).first(), KTextEditor::Range(900, 0, 900, 10));
+    QCOMPARE(regExpSearch.search(QStringLiteral("Needle x?"), all).first(), KTextEditor::Range(900, 0, 900, 7));
+    QCOMPARE(regExpSearch.search(QStringLiteral("Needle x"), all).first(), KTextEditor::Range::invalid());
+}
@@ -40,6 +40,11 @@ private Q_SLOTS:
     void testMultilineSearch_data();
     void testMultilineSearch();
 
+    void testWholeWords_data();
+    void testWholeWords();
+
+    void testSearchIndex();
+
 private:
     KTextEditor::DocumentPrivate *m_doc = nullptr;
     KatePlainTextSearch *m_search = nullptr;
@@ -175,6 +175,34 @@ void RegExpSearchTest::testReplacementCounter()
     QCOMPARE(result, expected);
 }
 
+void RegExpSearchTest::testReplacementTemplate_data()
+{
+    QTest::addColumn<QString>("pattern");
+
+    testNewRow() << QStringLiteral("abc");
+    testNewRow() << QStringLiteral("\\");
+    testNewRow() << QStringLiteral("a\\0b\\1c\\{12}d\\{1");
+    testNewRow() << QStringLiteral("\\0377\\0400\\x00e1\\xFFFg\\n\\t");
+    testNewRow() << QStringLiteral("\\u\\1 \\U\\2\\E \\l\\2\\L\\1\\Eá");
+    testNewRow() << QStringLiteral("\\#\\###-\\2");
+}
+
+void RegExpSearchTest::testReplacementTemplate()
+{
+    QFETCH(QString, pattern);
+
+    // one template for several matches gives what parsing the pattern for each of them gives
+    const KateRegExpSearch::ReplacementTemplate replacementTemplate(pattern);
+    const QList<QStringList> matches = {
+        QStringList() << QStringLiteral("foo bar") << QStringLiteral("foo") << QStringLiteral("bar"),
+        QStringList() << QStringLiteral("Áb cD") << QStringLiteral("Áb") << QStringLiteral("cD"),
+        QStringList() << QStringLiteral("x"),
+    };
+    for (int i = 0; i < matches.size(); ++i) {
+        QCOMPARE(replacementTemplate.build(matches.at(i), i + 9), KateRegExpSearch::buildReplacement(pattern, matches.at(i), i + 9));
+    }
+}
+
 void RegExpSearchTest::testAnchoredRegexp_data()
 {
     QTest::addColumn<QString>("pattern");
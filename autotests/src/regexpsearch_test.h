@@ -31,6 +31,9 @@ private Q_SLOTS:
     void testReplacementCounter_data();
     void testReplacementCounter();
 
+    void testReplacementTemplate_data();
+    void testReplacementTemplate();
+
     void testAnchoredRegexp_data();
     void testAnchoredRegexp();
 
@@ -0,0 +1,163 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "replaceinfiles_test.h"
+#include "moc_replaceinfiles_test.cpp"
+
+#include <katedocument.h>
+#include <kateglobal.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+QTEST_MAIN(ReplaceInFilesTest)
+
+using namespace KTextEditor;
+
+ReplaceInFilesTest::ReplaceInFilesTest()
+    : QObject()
+{
+    KTextEditor::EditorPrivate::enableUnitTestMode();
+}
+
+static QString writeFile(const QTemporaryDir &dir, const QString &name, const QByteArray &content)
+{
+    const QString path = dir.filePath(name);
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size()) {
+        return QString();
+    }
+    return path;
+}
+
+static QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+static QList<Editor::ReplaceResult> waitForResults(QFuture<Editor::ReplaceResult> future)
+{
+    future.waitForFinished();
+    return future.results();
+}
+
+void ReplaceInFilesTest::testDocuments()
+{
+    KTextEditor::DocumentPrivate doc1;
+    doc1.setText(QStringLiteral("foo bar\nfoo foo"));
+    KTextEditor::DocumentPrivate doc2;
+    doc2.setText(QStringLiteral("Foo"));
+
+    const auto results = waitForResults(
+        EditorPrivate::self()->replaceInDocuments({&doc1, &doc2}, {}, QStringLiteral("foo"), QStringLiteral("baz"), KTextEditor::CaseInsensitive));
+    QCOMPARE(results.size(), 2);
+    for (const auto &result : results) {
+        QVERIFY(result.errorString.isEmpty());
+        QCOMPARE(result.replacements, result.document == &doc1 ? 3 : 1);
+    }
+    QCOMPARE(doc1.text(), QStringLiteral("baz bar\nbaz baz"));
+    QCOMPARE(doc2.text(), QStringLiteral("baz"));
+
+    // one undo step per document
+    doc1.undo();
+    QCOMPARE(doc1.text(), QStringLiteral("foo bar\nfoo foo"));
+}
+
+void ReplaceInFilesTest::testFiles()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString file1 = writeFile(dir, QStringLiteral("a.txt"), "foo food\r\nfoo\r\n");
+    const QString file2 = writeFile(dir, QStringLiteral("b.txt"), "bar\n");
+    const QString missing = dir.filePath(QStringLiteral("missing.txt"));
+    QVERIFY(!file1.isEmpty());
+    QVERIFY(!file2.isEmpty());
+
+    auto future = EditorPrivate::self()->replaceInDocuments({}, {file1, file2, missing}, QStringLiteral("foo"), QStringLiteral("x"), KTextEditor::WholeWords);
+    const auto results = waitForResults(future);
+    QCOMPARE(results.size(), 3);
+    QCOMPARE(future.progressValue(), 3);
+    for (const auto &result : results) {
+        QVERIFY(!result.document);
+        if (result.filePath == file1) {
+            QVERIFY(result.errorString.isEmpty());
+            QCOMPARE(result.replacements, 2);
+        } else if (result.filePath == file2) {
+            QVERIFY(result.errorString.isEmpty());
+            QCOMPARE(result.replacements, 0);
+        } else {
+            QCOMPARE(result.filePath, missing);
+            QVERIFY(!result.errorString.isEmpty());
+        }
+    }
+
+    // the end of line mode is kept, unchanged files are left alone
+    QCOMPARE(readFile(file1), QByteArray("x food\r\nx\r\n"));
+    QCOMPARE(readFile(file2), QByteArray("bar\n"));
+}
+
+void ReplaceInFilesTest::testRegularExpression()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString file = writeFile(dir, QStringLiteral("a.txt"), "a=1\nb=2\n");
+    QVERIFY(!file.isEmpty());
+
+    const auto results = waitForResults(
+        EditorPrivate::self()->replaceInDocuments({}, {file}, QStringLiteral("^(\\w)=(\\d)$"), QStringLiteral("\\2=\\1\\n\\#"), KTextEditor::Regex));
+    QCOMPARE(results.size(), 1);
+    QVERIFY(results.first().errorString.isEmpty());
+    QCOMPARE(results.first().replacements, 2);
+
+    // line breaks in the replacement, the counter runs top to bottom
+    QCOMPARE(readFile(file), QByteArray("1=a\n1\n2=b\n2\n"));
+}
+
+void ReplaceInFilesTest::testOpenFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString file = writeFile(dir, QStringLiteral("a.txt"), "foo\n");
+    QVERIFY(!file.isEmpty());
+
+    KTextEditor::DocumentPrivate doc;
+    QVERIFY(doc.openUrl(QUrl::fromLocalFile(file)));
+
+    // the open document is changed instead of the file
+    const auto results = waitForResults(EditorPrivate::self()->replaceInDocuments({}, {file}, QStringLiteral("foo"), QStringLiteral("bar")));
+    QCOMPARE(results.size(), 1);
+    QCOMPARE(results.first().document, &doc);
+    QCOMPARE(results.first().replacements, 1);
+    QCOMPARE(doc.text(), QStringLiteral("bar\n"));
+    QVERIFY(doc.isModified());
+    QCOMPARE(readFile(file), QByteArray("foo\n"));
+}
+
+void ReplaceInFilesTest::testMultiLinePattern()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString file = writeFile(dir, QStringLiteral("a.txt"), "foo\nbar\n");
+    QVERIFY(!file.isEmpty());
+
+    KTextEditor::DocumentPrivate doc;
+    doc.setText(QStringLiteral("foo\nbar"));
+
+    const auto results = waitForResults(
+        EditorPrivate::self()->replaceInDocuments({&doc}, {file}, QStringLiteral("foo\\nbar"), QStringLiteral("baz"), KTextEditor::EscapeSequences));
+    QCOMPARE(results.size(), 2);
+    for (const auto &result : results) {
+        if (result.document) {
+            QCOMPARE(result.replacements, 1);
+        } else {
+            QVERIFY(!result.errorString.isEmpty());
+        }
+    }
+    QCOMPARE(doc.text(), QStringLiteral("baz"));
+    QCOMPARE(readFile(file), QByteArray("foo\nbar\n"));
+}
@@ -0,0 +1,27 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KATE_REPLACEINFILES_TEST_H
+#define KATE_REPLACEINFILES_TEST_H
+
+#include <QObject>
+
+class ReplaceInFilesTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    ReplaceInFilesTest();
+
+private Q_SLOTS:
+    void testDocuments();
+    void testFiles();
+    void testRegularExpression();
+    void testOpenFile();
+    void testMultiLinePattern();
+};
+
+#endif
@@ -113,4 +113,77 @@ void ScriptDocumentTest::testRfind()
     QCOMPARE(cursor, result);
 }
 
+void ScriptDocumentTest::testBulkAccess()
+{
+    QJSEngine engine;
+    KateScriptDocument scriptDoc(&engine);
+    scriptDoc.setDocument(m_doc);
+    m_doc->setText(QStringLiteral("first\n\nthird line\nfourth"));
+
+    // ranges are clamped to the document
+    QCOMPARE(scriptDoc.textLines(-1, 1), QStringList({QStringLiteral("first"), QString()}));
+    QCOMPARE(scriptDoc.textLines(2, 10), QStringList({QStringLiteral("third line"), QStringLiteral("fourth")}));
+    QVERIFY(scriptDoc.textLines(3, 2).isEmpty());
+
+    const QJSValue lengths = scriptDoc.lineLengths(0, 3);
+    QCOMPARE(lengths.property(QStringLiteral("length")).toInt(), 4);
+    QCOMPARE(lengths.property(0).toInt(), 5);
+    QCOMPARE(lengths.property(1).toInt(), 0);
+    QCOMPARE(lengths.property(2).toInt(), 10);
+    QCOMPARE(lengths.property(3).toInt(), 6);
+
+    // one array of (offset, length, attribute) triples per line
+    const QJSValue runs = scriptDoc.attributeRuns(0, 3);
+    QCOMPARE(runs.property(QStringLiteral("length")).toInt(), 4);
+    QCOMPARE(runs.property(0).property(QStringLiteral("length")).toInt() % 3, 0);
+}
+
+void ScriptDocumentTest::testApplyEdits_data()
+{
+    QTest::addColumn<QString>("edits");
+    QTest::addColumn<bool>("applied");
+    QTest::addColumn<QString>("result");
+
+    auto edit = [](int startLine, int startColumn, int endLine, int endColumn, const QString &text) {
+        return QStringLiteral("{range: {start: {line: %1, column: %2}, end: {line: %3, column: %4}}, text: '%5'}")
+            .arg(startLine)
+            .arg(startColumn)
+            .arg(endLine)
+            .arg(endColumn)
+            .arg(text);
+    };
+
+    QTest::newRow("none") << QStringLiteral("[]") << true << QStringLiteral("aaa bbb\nccc ddd");
+    QTest::newRow("replace") << QStringLiteral("[%1, %2]").arg(edit(0, 0, 0, 3, QStringLiteral("x")), edit(1, 4, 1, 7, QStringLiteral("yy"))) << true
+                             << QStringLiteral("x bbb\nccc yy");
+    QTest::newRow("unsorted") << QStringLiteral("[%1, %2]").arg(edit(1, 4, 1, 7, QStringLiteral("yy")), edit(0, 0, 0, 3, QStringLiteral("x"))) << true
+                              << QStringLiteral("x bbb\nccc yy");
+    QTest::newRow("multi line") << QStringLiteral("[%1, %2]").arg(edit(0, 4, 1, 3, QStringLiteral("-")), edit(1, 4, 1, 4, QStringLiteral("\\n"))) << true
+                                << QStringLiteral("aaa - \nddd");
+    QTest::newRow("same position") << QStringLiteral("[%1, %2, %3]")
+                                          .arg(edit(0, 4, 0, 4, QStringLiteral("1")), edit(0, 4, 0, 7, QStringLiteral("B")), edit(0, 4, 0, 4, QStringLiteral("2")))
+                                   << true << QStringLiteral("aaa 12B\nccc ddd");
+    QTest::newRow("overlap") << QStringLiteral("[%1, %2]").arg(edit(0, 0, 0, 5, QStringLiteral("x")), edit(0, 4, 0, 7, QStringLiteral("y"))) << false
+                             << QStringLiteral("aaa bbb\nccc ddd");
+    QTest::newRow("out of range") << QStringLiteral("[%1, %2]").arg(edit(0, 0, 0, 3, QStringLiteral("x")), edit(2, 0, 2, 1, QStringLiteral("y"))) << false
+                                  << QStringLiteral("aaa bbb\nccc ddd");
+}
+
+void ScriptDocumentTest::testApplyEdits()
+{
+    QFETCH(QString, edits);
+    QFETCH(bool, applied);
+    QFETCH(QString, result);
+
+    QJSEngine engine;
+    KateScriptDocument scriptDoc(&engine);
+    scriptDoc.setDocument(m_doc);
+    m_doc->setText(QStringLiteral("aaa bbb\nccc ddd"));
+
+    const QJSValue jsedits = engine.evaluate(edits);
+    QVERIFY(!jsedits.isError());
+    QCOMPARE(scriptDoc.applyEdits(jsedits), applied);
+    QCOMPARE(m_doc->text(), result);
+}
+
 #include "moc_scriptdocument_test.cpp"
@@ -39,6 +39,10 @@ private Q_SLOTS:
     void testRfind_data();
     void testRfind();
 
+    void testBulkAccess();
+    void testApplyEdits_data();
+    void testApplyEdits();
+
 private:
     KTextEditor::DocumentPrivate *m_doc = nullptr;
     KTextEditor::View *m_view = nullptr;
@@ -8,6 +8,12 @@
 // BEGIN Includes
 #include "scripting_test.h"
 
+#include "katecmd.h"
+#include "katecmds.h"
+#include "katedocument.h"
+#include "kateundomanager.h"
+#include "kateview.h"
+
 #include <QTest>
 
 QTEST_MAIN(ScriptingTest)
@@ -30,3 +36,73 @@ void ScriptingTest::bugs()
 {
     runTest(ExpectedFailures());
 }
+
+void ScriptingTest::nativeLineCommands_data()
+{
+    QTest::addColumn<QString>("command");
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<KTextEditor::Range>("selection");
+
+    const QString text = QStringLiteral("b 10\n  a2  \na10\n\nb 10\na 02\t\nA1\n\u00e41\na2 \u3000\nx0010\nx10\n");
+    const QStringList commands = {QStringLiteral("sort"),
+                                  QStringLiteral("sortuniq"),
+                                  QStringLiteral("natsort"),
+                                  QStringLiteral("uniq"),
+                                  QStringLiteral("rtrim"),
+                                  QStringLiteral("join"),
+                                  QStringLiteral("join ', '")};
+    for (const QString &command : commands) {
+        QTest::newRow(qPrintable(command + QLatin1String(" document"))) << command << text << KTextEditor::Range::invalid();
+        QTest::newRow(qPrintable(command + QLatin1String(" selection"))) << command << text << KTextEditor::Range(1, 2, 5, 1);
+    }
+
+    // enough lines to sort in parallel
+    QString manyLines;
+    uint value = 1;
+    for (int i = 0; i < 70000; ++i) {
+        value = value * 1103515245 + 12345;
+        manyLines += QStringLiteral("item %1 v%2\n").arg((value >> 8) % 1000).arg((value >> 16) % 20);
+    }
+    QTest::newRow("sort many lines") << QStringLiteral("sort") << manyLines << KTextEditor::Range::invalid();
+    QTest::newRow("natsort many lines") << QStringLiteral("natsort") << manyLines << KTextEditor::Range::invalid();
+}
+
+void ScriptingTest::nativeLineCommands()
+{
+    QFETCH(QString, command);
+    QFETCH(QString, text);
+    QFETCH(KTextEditor::Range, selection);
+
+    // the native command is used, the one of utils.js stays available as reference and fallback
+    const QString name = command.section(QLatin1Char(' '), 0, 0);
+    QCOMPARE(KateCmd::self()->queryCommand(name), KateCommands::LineCommands::self());
+    KTextEditor::Command *script = KateCommands::LineCommands::scriptCommand(name);
+    QVERIFY(script);
+
+    const auto run = [&](KTextEditor::Command *cmd, QString &result, KTextEditor::Cursor &cursor) {
+        m_document->setText(text);
+        m_view->setCursorPosition(KTextEditor::Cursor(2, 2));
+        m_view->setSelection(selection);
+        m_document->undoManager()->undoSafePoint();
+        QString msg;
+        QVERIFY2(cmd->exec(m_view, command, msg), qPrintable(msg));
+        result = m_document->text();
+        cursor = m_view->cursorPosition();
+        QVERIFY(!m_view->selection());
+    };
+
+    QString expected;
+    KTextEditor::Cursor expectedCursor;
+    run(script, expected, expectedCursor);
+
+    QString actual;
+    KTextEditor::Cursor actualCursor;
+    run(KateCommands::LineCommands::self(), actual, actualCursor);
+
+    QCOMPARE(actual, expected);
+    QCOMPARE(actualCursor, expectedCursor);
+
+    // one undo step
+    m_document->undo();
+    QCOMPARE(m_document->text(), text);
+}
@@ -17,6 +17,9 @@ private Q_SLOTS:
 
     void bugs_data();
     void bugs();
+
+    void nativeLineCommands_data();
+    void nativeLineCommands();
 };
 
 #endif // SCRIPTINGTEST_H
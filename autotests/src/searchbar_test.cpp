@@ -215,6 +215,70 @@ void SearchBarTest::testSetMatchCaseIncremental()
     QCOMPARE(view.selectionRange(), Range(0, 2, 0, 3));
 }
 
+void SearchBarTest::testRefineIncremental()
+{
+    KTextEditor::DocumentPrivate doc;
+    KTextEditor::ViewPrivate view(&doc, nullptr);
+    KateViewConfig config(&view);
+
+    doc.setText(QStringLiteral("fo foo\nbar fob\nfoa"));
+    view.setCursorPosition(Cursor(0, 1));
+    KateSearchBar bar(false, &view, &config);
+
+    // typing the pattern character by character
+    bar.setSearchPattern(QStringLiteral("fo"));
+    QCOMPARE(view.selectionRange(), Range(0, 3, 0, 5));
+    bar.setSearchPattern(QStringLiteral("foo"));
+    QCOMPARE(view.selectionRange(), Range(0, 3, 0, 6));
+    bar.setSearchPattern(QStringLiteral("foob"));
+    QVERIFY(!view.selection());
+    bar.setSearchPattern(QStringLiteral("fooba"));
+    QVERIFY(!view.selection());
+
+    // not an extension, search again
+    bar.setSearchPattern(QStringLiteral("fo"));
+    QCOMPARE(view.selectionRange(), Range(0, 3, 0, 5));
+
+    // refine a wrapped match
+    view.setCursorPosition(Cursor(2, 1));
+    bar.setSearchPattern(QStringLiteral("f"));
+    QCOMPARE(view.selectionRange(), Range(0, 0, 0, 1));
+    bar.setSearchPattern(QStringLiteral("foo"));
+    QCOMPARE(view.selectionRange(), Range(0, 3, 0, 6));
+
+    // the document changed, search again
+    view.setCursorPosition(Cursor(0, 1));
+    bar.setSearchPattern(QStringLiteral("fo"));
+    QCOMPARE(view.selectionRange(), Range(0, 3, 0, 5));
+    doc.insertText(Cursor(0, 2), QStringLiteral("foo"));
+    view.setCursorPosition(Cursor(0, 1));
+    bar.setSearchPattern(QStringLiteral("foo"));
+    QCOMPARE(view.selectionRange(), Range(0, 2, 0, 5));
+}
+
+void SearchBarTest::testIncrementalLargeDocument()
+{
+    KTextEditor::DocumentPrivate doc;
+    KTextEditor::ViewPrivate view(&doc, nullptr);
+    KateViewConfig config(&view);
+
+    QStringList lines(100000, QStringLiteral("some text without the pattern"));
+    lines.append(QStringLiteral("needle"));
+    doc.setText(lines);
+    KateSearchBar bar(false, &view, &config);
+
+    // the search might continue in later time slices
+    bar.setSearchPattern(QStringLiteral("needle"));
+    QTRY_COMPARE(view.selectionRange(), Range(100000, 0, 100000, 6));
+
+    // a new pattern cancels the running search
+    bar.setSearchPattern(QStringLiteral("xyz"));
+    bar.setSearchPattern(QStringLiteral("text"));
+    QTRY_COMPARE(view.selectionRange(), Range(0, 5, 0, 9));
+    bar.setSearchPattern(QStringLiteral("textxyz"));
+    QTRY_VERIFY(!view.selection());
+}
+
 void SearchBarTest::testSetMatchCasePower()
 {
     KTextEditor::DocumentPrivate doc;
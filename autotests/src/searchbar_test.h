@@ -30,6 +30,8 @@ private Q_SLOTS:
     void testFindNextNoNewLineAtEnd();
 
     void testSetMatchCaseIncremental();
+    void testRefineIncremental();
+    void testIncrementalLargeDocument();
 
     void testSetMatchCasePower();
 
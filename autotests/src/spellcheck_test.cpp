@@ -0,0 +1,75 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "spellcheck_test.h"
+#include "moc_spellcheck_test.cpp"
+
+#include <kateglobal.h>
+#include <spellcheck/spellcheck.h>
+
+#include <QTest>
+
+QTEST_MAIN(SpellCheckTest)
+
+SpellCheckTest::SpellCheckTest()
+    : QObject()
+{
+    KTextEditor::EditorPrivate::enableUnitTestMode();
+}
+
+static KateSpellCheckManager *manager()
+{
+    return KTextEditor::EditorPrivate::self()->spellCheckManager();
+}
+
+void SpellCheckTest::init()
+{
+    manager()->clearVerdicts();
+}
+
+void SpellCheckTest::testCachedVerdicts()
+{
+    bool misspelled = false;
+    QVERIFY(!manager()->cachedVerdict(QStringLiteral("hose"), QStringLiteral("en_US"), misspelled));
+
+    manager()->cacheVerdict(QStringLiteral("hose"), QStringLiteral("en_US"), false);
+    manager()->cacheVerdict(QStringLiteral("hose"), QStringLiteral("de_DE"), true);
+
+    // hits are per dictionary
+    QVERIFY(manager()->cachedVerdict(QStringLiteral("hose"), QStringLiteral("en_US"), misspelled));
+    QVERIFY(!misspelled);
+    QVERIFY(manager()->cachedVerdict(QStringLiteral("hose"), QStringLiteral("de_DE"), misspelled));
+    QVERIFY(misspelled);
+    QVERIFY(!manager()->cachedVerdict(QStringLiteral("hose"), QStringLiteral("fr_FR"), misspelled));
+    QVERIFY(!manager()->cachedVerdict(QStringLiteral("Hose"), QStringLiteral("en_US"), misspelled));
+}
+
+void SpellCheckTest::testIgnoredWordDropsVerdict()
+{
+    const QString word = QStringLiteral("katespellchecktestword");
+    manager()->cacheVerdict(word, QStringLiteral("en_US"), true);
+    manager()->cacheVerdict(word, QStringLiteral("de_DE"), true);
+    manager()->cacheVerdict(QStringLiteral("other"), QStringLiteral("en_US"), false);
+
+    // the ignore list isn't per dictionary, the word is dropped for all of them
+    manager()->ignoreWord(word, QStringLiteral("en_US"));
+    bool misspelled = false;
+    QVERIFY(!manager()->cachedVerdict(word, QStringLiteral("en_US"), misspelled));
+    QVERIFY(!manager()->cachedVerdict(word, QStringLiteral("de_DE"), misspelled));
+    QVERIFY(manager()->cachedVerdict(QStringLiteral("other"), QStringLiteral("en_US"), misspelled));
+}
+
+void SpellCheckTest::testClearVerdicts()
+{
+    manager()->cacheVerdict(QStringLiteral("hose"), QStringLiteral("en_US"), false);
+    manager()->cacheVerdict(QStringLiteral("hose"), QStringLiteral("de_DE"), true);
+
+    // e.g. after the default language or the personal dictionary changed
+    manager()->clearVerdicts();
+    bool misspelled = false;
+    QVERIFY(!manager()->cachedVerdict(QStringLiteral("hose"), QStringLiteral("en_US"), misspelled));
+    QVERIFY(!manager()->cachedVerdict(QStringLiteral("hose"), QStringLiteral("de_DE"), misspelled));
+}
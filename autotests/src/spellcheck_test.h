@@ -0,0 +1,26 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KATE_SPELLCHECK_TEST_H
+#define KATE_SPELLCHECK_TEST_H
+
+#include <QObject>
+
+class SpellCheckTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    SpellCheckTest();
+
+private Q_SLOTS:
+    void init();
+    void testCachedVerdicts();
+    void testIgnoredWordDropsVerdict();
+    void testClearVerdicts();
+};
+
+#endif
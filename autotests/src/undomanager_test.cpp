@@ -13,6 +13,7 @@
 #include <kateundomanager.h>
 #include <kateview.h>
 
+#include <QSignalSpy>
 #include <QTest>
 
 QTEST_MAIN(UndoManagerTest)
@@ -250,4 +251,147 @@ void UndoManagerTest::testUndoIndentBug373009()
     delete view;
 }
 
+void UndoManagerTest::testCompactTyping()
+{
+    KTextEditor::DocumentPrivate doc;
+    doc.setText(QStringLiteral("0123456789"));
+
+    // typing, backspace and delete within one undo group
+    doc.editStart();
+    doc.insertText(Cursor(0, 2), QStringLiteral("abc"));
+    doc.removeText(Range(0, 4, 0, 5));
+    doc.removeText(Range(0, 4, 0, 5));
+    doc.removeText(Range(0, 4, 0, 5));
+    doc.editEnd();
+    QCOMPARE(doc.text(), QStringLiteral("01ab456789"));
+
+    doc.undo();
+    QCOMPARE(doc.text(), QStringLiteral("0123456789"));
+    doc.redo();
+    QCOMPARE(doc.text(), QStringLiteral("01ab456789"));
+}
+
+void UndoManagerTest::testMemoryBudget_data()
+{
+    QTest::addColumn<bool>("spillToDisk");
+
+    QTest::newRow("spill") << true;
+    QTest::newRow("drop") << false;
+}
+
+void UndoManagerTest::testMemoryBudget()
+{
+    QFETCH(bool, spillToDisk);
+
+    KTextEditor::DocumentPrivate doc;
+    KateUndoManager *undoManager = doc.undoManager();
+    const qsizetype budget = 1024 * 1024;
+    undoManager->setMemoryBudget(budget, spillToDisk);
+
+    // one undo group per line, the text of all of them doesn't fit into the budget
+    const QString line = QString(1000, QLatin1Char('x')) + QLatin1Char('\n');
+    const int groups = 1000;
+    for (int i = 0; i < groups; ++i) {
+        doc.insertText(doc.documentEnd(), line);
+        undoManager->undoSafePoint();
+    }
+    QVERIFY(undoManager->memoryUsage() <= budget);
+
+    const int undoCount = undoManager->undoCount();
+    if (spillToDisk) {
+        // nothing is lost, the text is read back from disk
+        QCOMPARE(undoCount, groups);
+    } else {
+        QVERIFY(undoCount < groups);
+        QVERIFY(undoCount > 0);
+    }
+
+    while (undoManager->undoCount() > 0) {
+        doc.undo();
+    }
+    QCOMPARE(doc.text(), line.repeated(groups - undoCount));
+
+    while (undoManager->redoCount() > 0) {
+        doc.redo();
+    }
+    QCOMPARE(doc.text(), line.repeated(groups));
+}
+
+void UndoManagerTest::testMergeAfterUndoIntoSpilled()
+{
+    const int lines = 1000;
+    KTextEditor::DocumentPrivate doc;
+    doc.setText(QString(lines - 1, QLatin1Char('\n')));
+    KateUndoManager *undoManager = doc.undoManager();
+    undoManager->clearUndo();
+    undoManager->setMemoryBudget(1024 * 1024, true);
+
+    // alternating insertions and removals without safe points, each edit is its own undo group
+    const QString text(1000, QLatin1Char('x'));
+    for (int i = 0; i < lines; ++i) {
+        doc.insertText(Cursor(i, 0), text);
+        doc.removeText(Range(i, 999, i, 1000));
+    }
+    QVERIFY(undoManager->memoryUsage() <= 1024 * 1024);
+    QCOMPARE(undoManager->undoCount(), uint(2 * lines));
+
+    // the last group is now an old, spilled insertion, typing right after it must not merge into it
+    while (undoManager->undoCount() > 101) {
+        doc.undo();
+    }
+    QCOMPARE(doc.line(49), text.left(999));
+    QCOMPARE(doc.line(50), text);
+    QCOMPARE(doc.line(51), QString());
+    doc.insertText(Cursor(50, 1000), QStringLiteral("y"));
+    QCOMPARE(undoManager->undoCount(), uint(102));
+
+    while (undoManager->undoCount() > 0) {
+        doc.undo();
+    }
+    QCOMPARE(doc.text(), QString(lines - 1, QLatin1Char('\n')));
+
+    while (undoManager->redoCount() > 0) {
+        doc.redo();
+    }
+    QStringList expected(lines);
+    for (int i = 0; i < 50; ++i) {
+        expected[i] = text.left(999);
+    }
+    expected[50] = text + QLatin1Char('y');
+    QCOMPARE(doc.text(), expected.join(QLatin1Char('\n')));
+}
+
+void UndoManagerTest::testReplay()
+{
+    KTextEditor::DocumentPrivate doc;
+    const QString text = QStringLiteral("foo bar\n").repeated(2000);
+    doc.setText(text);
+
+    // one large group of changes within lines, undo and redo replay it in one go
+    doc.editStart();
+    for (int line = 0; line < 2000; ++line) {
+        doc.editRemoveText(line, 0, 3);
+        doc.editInsertText(line, 0, QStringLiteral("quux"));
+    }
+    doc.editEnd();
+    const QString replaced = QStringLiteral("quux bar\n").repeated(2000);
+    QCOMPARE(doc.text(), replaced);
+
+    QSignalSpy replayed(&doc, &KTextEditor::DocumentPrivate::textReplayed);
+    QSignalSpy removed(&doc, &KTextEditor::DocumentPrivate::textRemoved);
+    QSignalSpy changed(&doc, &KTextEditor::Document::textChanged);
+
+    doc.undo();
+    QCOMPARE(doc.text(), text);
+    QCOMPARE(replayed.count(), 1);
+    QCOMPARE(replayed.first().at(1).value<KTextEditor::LineRange>(), KTextEditor::LineRange(0, 1999));
+    QCOMPARE(removed.count(), 0);
+    QCOMPARE(changed.count(), 1);
+
+    doc.redo();
+    QCOMPARE(doc.text(), replaced);
+    QCOMPARE(replayed.count(), 2);
+    QCOMPARE(changed.count(), 2);
+}
+
 #include "moc_undomanager_test.cpp"
@@ -25,6 +25,11 @@ private Q_SLOTS:
     void testSelectionUndo();
     void testUndoWordWrapBug301367();
     void testUndoIndentBug373009();
+    void testCompactTyping();
+    void testMemoryBudget_data();
+    void testMemoryBudget();
+    void testMergeAfterUndoIntoSpilled();
+    void testReplay();
 
 private:
     class TestDocument;
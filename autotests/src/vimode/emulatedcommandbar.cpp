@@ -1919,6 +1919,24 @@ void EmulatedCommandBarTest::EmulatedCommandBarTests()
     DoTest("foo\nbar\nxyz\nbaz", "jVj:delete\\enter", "foo\nbaz");
     DoTest("foo\nbar\nxyz\nbaz", "j2:delete\\enter", "foo\nbaz");
 
+    // :global, :vglobal and :normal.
+    DoTest("foo\nbar\nfoo2\nbaz", ":g/foo/d\\enter", "bar\nbaz");
+    DoTest("foo\nbar\nfoo2\nbaz", ":global/foo/d\\enter", "bar\nbaz");
+    DoTest("foo\nbar\nfoo2\nbaz", ":v/foo/d\\enter", "foo\nfoo2");
+    DoTest("foo\nbar\nfoo2\nbaz", ":g!/foo/d\\enter", "foo\nfoo2");
+    DoTest("foo\nbar\nfoo2\nbaz", ":2,$g/foo/d\\enter", "foo\nbar\nbaz");
+    DoTest("foo\nbar\nfoo2\nbaz", ":g#o2#d\\enter", "foo\nbar\nbaz");
+    DoTest("a/b\nab\nc", ":g/a\\\\/b/d\\enter", "ab\nc");
+    DoTest("foo\nfoo\nbar", ":g/foo/j\\enter", "foo foo\nbar");
+    DoTest("x\nx\ny\nz", ":g/x/.,+1d\\enter", "y\nz");
+    DoTest("foo\nbar\nfoo", ":g/foo/normal Ay\\enter", "fooy\nbar\nfooy");
+    DoTest("foo\nbar\nfoo", ":g/foo/normal Ay\\enteru", "foo\nbar\nfoo");
+    DoTest("foo\nbar\nxyz", ":%norm Ax\\enter", "foox\nbarx\nxyzx");
+    DoTest("foo\nbar\nxyz", ":2,3normal! dd\\enter", "foo");
+    DoTest("foo\nbar\nxyz", "j:norm iab\\enter", "foo\nabbar\nxyz");
+    DoTest("foo\nbar\nxyz", ":%norm ix\\enteru", "foo\nbar\nxyz");
+    DoTest("foo\nbar", ":%norm d\\enter", "foo\nbar");
+
     // Test that 0 is accepted as a line index (and treated as 1) in a range specifier
     DoTest("bar\nbar\nbar", ":0,$s/bar/foo/g\\enter", "foo\nfoo\nfoo");
     DoTest("bar\nbar\nbar", ":1,$s/bar/foo/g\\enter", "foo\nfoo\nfoo");
@@ -647,6 +647,43 @@ void HlSearchTest::highlightModeTests()
         BeginTest(text);
         FinishTest(text.toUtf8().constData());
     }
+    // test that scrolling reuses the highlights of the lines no longer visible
+    {
+        QString text = QStringLiteral("foo bar xyz\n\n\n\n\nfoo ab bar x");
+        BeginTest(text);
+        auto vr = kate_view->visibleRange();
+        // ensure that last line is not visible
+        QVERIFY(vr.end().line() < 4);
+
+        TestPressKey(QStringLiteral("/bar\\enter"));
+        Kate::TextRange *highlight = nullptr;
+        {
+            QVector<Kate::TextRange *> ranges = rangesOnLine(0);
+            QCOMPARE(ranges.size(), rangesInitial.size() + 1);
+            highlight = ranges[0];
+        }
+
+        kate_view->bottom();
+        {
+            QVector<Kate::TextRange *> ranges = rangesOnLine(0);
+            QCOMPARE(ranges.size(), rangesInitial.size());
+            ranges = rangesOnLine(5);
+            QCOMPARE(ranges.size(), rangesInitial.size() + 1);
+            QCOMPARE(ranges[0], highlight);
+            TestHighlight(*ranges[0], {5, 7}, {5, 10}, searchHighlightColor);
+        }
+
+        kate_view->top();
+        {
+            QVector<Kate::TextRange *> ranges = rangesOnLine(0);
+            QCOMPARE(ranges.size(), rangesInitial.size() + 1);
+            QCOMPARE(ranges[0], highlight);
+            TestHighlight(*ranges[0], {0, 4}, {0, 7}, searchHighlightColor);
+            ranges = rangesOnLine(5);
+            QCOMPARE(ranges.size(), rangesInitial.size());
+        }
+        FinishTest(text.toUtf8().constData());
+    }
     // test that no endless loop is triggered
     {
         QString text = QStringLiteral("foo bar xyz\nabc def\nghi jkl\nmno pqr\nstu vwx\nfoo ab bar x");
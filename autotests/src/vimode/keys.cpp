@@ -47,6 +47,34 @@ void KeysTest::MappingTests()
         QVERIFY(!vi_global->mappings()->isRecursive(Mappings::NormalModeMapping, QStringLiteral("a")));
     }
 
+    {
+        // Check the lookup of full and partial mappings, also after replacing and removing mappings.
+        clearAllMappings();
+        Mappings *mappings = vi_global->mappings();
+        bool isFullMapping = false;
+        bool isPartialMapping = false;
+
+        mappings->add(Mappings::NormalModeMapping, QStringLiteral("'1"), QStringLiteral("x"), Mappings::Recursive);
+        mappings->add(Mappings::NormalModeMapping, QStringLiteral("'12"), QStringLiteral("x"), Mappings::Recursive);
+        mappings->add(Mappings::NormalModeMapping, QStringLiteral("'12"), QStringLiteral("y"), Mappings::Recursive);
+        mappings->match(Mappings::NormalModeMapping, QStringLiteral("'"), isFullMapping, isPartialMapping);
+        QVERIFY(!isFullMapping && isPartialMapping);
+        mappings->match(Mappings::NormalModeMapping, QStringLiteral("'1"), isFullMapping, isPartialMapping);
+        QVERIFY(isFullMapping && isPartialMapping);
+        mappings->match(Mappings::NormalModeMapping, QStringLiteral("'12"), isFullMapping, isPartialMapping);
+        QVERIFY(isFullMapping && !isPartialMapping);
+        mappings->match(Mappings::NormalModeMapping, QStringLiteral("'2"), isFullMapping, isPartialMapping);
+        QVERIFY(!isFullMapping && !isPartialMapping);
+        mappings->match(Mappings::InsertModeMapping, QStringLiteral("'1"), isFullMapping, isPartialMapping);
+        QVERIFY(!isFullMapping && !isPartialMapping);
+
+        mappings->remove(Mappings::NormalModeMapping, QStringLiteral("'12"));
+        mappings->match(Mappings::NormalModeMapping, QStringLiteral("'1"), isFullMapping, isPartialMapping);
+        QVERIFY(isFullMapping && !isPartialMapping);
+        mappings->match(Mappings::NormalModeMapping, QStringLiteral("'12"), isFullMapping, isPartialMapping);
+        QVERIFY(!isFullMapping && !isPartialMapping);
+    }
+
     clearAllMappings();
 
     vi_global->mappings()->add(Mappings::NormalModeMapping, QStringLiteral("'"), QStringLiteral("<esc>ihello<esc>^aworld<esc>"), Mappings::Recursive);
@@ -778,6 +806,45 @@ void KeysTest::MacroTests()
     clearAllMacros();
     DoTest("foo", "qcrXql@c", "XXo");
 
+    // A counted replay is one undo step, the view follows the cursor once it is done.
+    clearAllMacros();
+    {
+        QString text;
+        for (int i = 0; i < 200; i++) {
+            text += QStringLiteral("foo\n");
+        }
+        BeginTest(text);
+        TestPressKey(QStringLiteral("qarXjq199@a"));
+        QVERIFY(!kate_view->updatesDeferred());
+        QCOMPARE(kate_document->line(199), QStringLiteral("Xoo"));
+        QCOMPARE(kate_view->cursorPosition().line(), 200);
+        QCOMPARE(kate_view->visibleRange().end().line(), 200);
+        kate_document->undo();
+        QCOMPARE(kate_document->line(1), QStringLiteral("foo"));
+        QCOMPARE(kate_document->line(0), QStringLiteral("Xoo"));
+        FinishTest(kate_document->text().toUtf8().constData());
+    }
+
+    // Motions relative to the window see the view scrolled by the previous replayed keys.
+    clearAllMacros();
+    {
+        QString text;
+        for (int i = 0; i < 200; i++) {
+            text += QStringLiteral("foo\n");
+        }
+        BeginTest(text);
+        TestPressKey(QStringLiteral("LjLjLjLj"));
+        const int expectedLine = kate_view->cursorPosition().line();
+        QVERIFY(kate_view->visibleRange().start().line() > 0);
+        FinishTest(text.toUtf8().constData());
+
+        BeginTest(text);
+        TestPressKey(QStringLiteral("qaLjq3@a"));
+        QCOMPARE(kate_view->cursorPosition().line(), expectedLine);
+        QVERIFY(kate_view->visibleRange().contains(kate_view->cursorPosition()));
+        FinishTest(text.toUtf8().constData());
+    }
+
     // Re-recording a macro should only clear that macro.
     clearAllMacros();
     DoTest("foo 123", "qaraqqbrbqqbrBqw@a", "Boo a23");
@@ -1532,6 +1532,15 @@ void ModesTest::CommandSedTests()
     // https://bugs.kde.org/show_bug.cgi?id=235862
     DoTest("try\n\nalso\nfoo", "\\:/r/,/o/s/^/ha/\\", "hatry\nha\nhaalso\nfoo");
     DoTest("much\nmuch\nmuch\nmuch", "\\:.,.+2s/much/try/\\", "try\ntry\ntry\nmuch");
+
+    // empty matches over several lines, the last line ends the search range
+    DoTest("ab\nab\nab", "\\:%s/b*/x/g\\", "xaxx\nxaxx\nxax");
+    DoTest("ab\nab\nab", "\\:%s/b*/x/\\", "xab\nxab\nxab");
+
+    // enough lines to compute the replacements in parallel, undone in one step
+    const QString manyLines = QStringLiteral("foo bar\n").repeated(5000) + QStringLiteral("foo");
+    DoTest2(__LINE__, __FILE__, manyLines, QStringLiteral("\\:%s/o/0/g\\"), QStringLiteral("f00 bar\n").repeated(5000) + QStringLiteral("f00"));
+    DoTest2(__LINE__, __FILE__, manyLines, QStringLiteral("\\:%s/o/0/g\\u"), manyLines);
 }
 
 void ModesTest::CommandDeleteTests()
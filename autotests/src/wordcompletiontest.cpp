@@ -8,9 +8,13 @@
 
 #include <kateglobal.h>
 #include <katewordcompletion.h>
+#include <katewordindex.h>
 #include <ktexteditor/editor.h>
 #include <ktexteditor/view.h>
 
+#include <KActionCollection>
+
+#include <QAction>
 #include <QTest>
 
 QTEST_MAIN(WordCompletionTest)
@@ -97,3 +101,78 @@ void WordCompletionTest::benchWordRetrievalDistinct()
         QCOMPARE(m.allMatches(v.get(), KTextEditor::Range()).size(), count);
     }
 }
+
+// the latency of the word completion in a document with 1M lines, once its word index is built
+static const int hugeDocumentLines = 1000000;
+
+void WordCompletionTest::benchWordRetrievalAfterEditHugeDocument()
+{
+    QStringList s;
+    s.reserve(hugeDocumentLines);
+    for (int i = 0; i < hugeDocumentLines; i++) {
+        s.append(QLatin1String("HelloWorld") + QString::number(i % 1000) + QLatin1String(" foo_bar"));
+    }
+    m_doc->setText(s);
+
+    std::unique_ptr<KTextEditor::View> v(m_doc->createView(nullptr));
+    QCOMPARE(KateWordCompletionModel::allMatches(v.get(), KTextEditor::Range()).size(), 1001);
+
+    // the edits only change the index of the lines they touch
+    const int line = hugeDocumentLines / 2;
+    QBENCHMARK {
+        m_doc->insertText(KTextEditor::Cursor(line, 0), QStringLiteral("Inserted\n"));
+        QCOMPARE(KateWordCompletionModel::allMatches(v.get(), KTextEditor::Range()).size(), 1002);
+        m_doc->removeText(KTextEditor::Range(line, 0, line + 1, 0));
+        QCOMPARE(KateWordCompletionModel::allMatches(v.get(), KTextEditor::Range()).size(), 1001);
+    }
+}
+
+void WordCompletionTest::benchReuseWordAboveHugeDocument()
+{
+    QStringList s;
+    s.reserve(hugeDocumentLines + 1);
+    s.append(QStringLiteral("UniqueWord"));
+    for (int i = 1; i < hugeDocumentLines; i++) {
+        s.append(QLatin1String("HelloWorld") + QString::number(i % 1000));
+    }
+    s.append(QStringLiteral("Uni"));
+    m_doc->setText(s);
+
+    std::unique_ptr<KTextEditor::View> v(m_doc->createView(nullptr));
+    QAction *reuseWordAbove = v->actionCollection()->action(QStringLiteral("doccomplete_bw"));
+    QVERIFY(reuseWordAbove);
+
+    // the only candidate is 1M lines above the cursor, the index jumps there
+    const int line = hugeDocumentLines;
+    const auto reuse = [&]() {
+        v->setCursorPosition(KTextEditor::Cursor(line, 0));
+        v->setCursorPosition(KTextEditor::Cursor(line, 3));
+        reuseWordAbove->trigger();
+        const QString completed = m_doc->line(line);
+        m_doc->removeText(KTextEditor::Range(line, 3, line, completed.size()));
+        return completed;
+    };
+
+    // the first one builds the index
+    QCOMPARE(reuse(), QStringLiteral("UniqueWord"));
+    QBENCHMARK {
+        QCOMPARE(reuse(), QStringLiteral("UniqueWord"));
+    }
+    QCOMPARE(m_doc->line(line), QStringLiteral("Uni"));
+}
+
+void WordCompletionTest::testWordCharacters()
+{
+    // the same characters as \w
+    QVERIFY(KateWordIndex::isWordCharacter(QLatin1Char('a')));
+    QVERIFY(KateWordIndex::isWordCharacter(QChar(0x00e9))); // e with acute
+    QVERIFY(KateWordIndex::isWordCharacter(QLatin1Char('7')));
+    QVERIFY(KateWordIndex::isWordCharacter(QLatin1Char('_')));
+    QVERIFY(KateWordIndex::isWordCharacter(QChar(0x203f))); // undertie, connector punctuation
+    QVERIFY(KateWordIndex::isWordCharacter(QChar(0x0301))); // combining acute accent, non-spacing mark
+    QVERIFY(KateWordIndex::isWordCharacter(QChar(0x0903))); // devanagari visarga, spacing mark
+    QVERIFY(!KateWordIndex::isWordCharacter(QChar(0x00b2))); // superscript two, other number
+    QVERIFY(!KateWordIndex::isWordCharacter(QChar(0x2166))); // roman numeral seven, letter number
+    QVERIFY(!KateWordIndex::isWordCharacter(QLatin1Char('-')));
+    QVERIFY(!KateWordIndex::isWordCharacter(QLatin1Char(' ')));
+}
@@ -24,6 +24,11 @@ private Q_SLOTS:
     void benchWordRetrievalSame();
     void benchWordRetrievalMixed();
 
+    void benchWordRetrievalAfterEditHugeDocument();
+    void benchReuseWordAboveHugeDocument();
+
+    void testWordCharacters();
+
 private:
     KTextEditor::Document *m_doc;
 };
@@ -9,8 +9,16 @@
 #include "katetextcursor.h"
 #include "katetextrange.h"
 
+#include <algorithm>
+
 namespace Kate
 {
+static inline uint trigramBit(char16_t a, char16_t b, char16_t c)
+{
+    const uint hash = (uint(a) * 0x9E3779B1u) ^ (uint(b) * 0x85EBCA77u) ^ (uint(c) * 0xC2B2AE3Du);
+    return (hash ^ (hash >> 16)) % TextBlock::SearchIndexBits;
+}
+
 TextBlock::TextBlock(TextBuffer *buffer, int startLine)
     : m_buffer(buffer)
     , m_startLine(startLine)
@@ -49,11 +57,149 @@ TextLine TextBlock::line(int line) const
 void TextBlock::appendLine(const QString &textOfLine)
 {
     m_lines.push_back(std::make_shared<Kate::TextLineData>(textOfLine));
+    indexText(textOfLine);
+    invalidateBrackets();
 }
 
 void TextBlock::clearLines()
 {
     m_lines.clear();
+    m_editedLines.clear();
+    m_searchIndex.reset();
+    invalidateBrackets();
+}
+
+void TextBlock::buildSearchIndex()
+{
+    m_searchIndex = std::make_unique<std::bitset<SearchIndexBits>>();
+    m_searchIndexRemovals = 0;
+    for (const auto &line : m_lines) {
+        indexText(line->text());
+    }
+}
+
+bool TextBlock::searchIndexOutdated() const
+{
+    // a rebuild doesn't help as long as nothing got removed, e.g. if long lines saturate the index
+    if (!m_searchIndex || m_searchIndexRemovals == 0) {
+        return false;
+    }
+
+    static constexpr int maxRemovals = 1024;
+    static constexpr std::size_t saturatedBits = SearchIndexBits / 4 * 3;
+    return m_searchIndexRemovals >= maxRemovals || m_searchIndex->count() >= saturatedBits;
+}
+
+void TextBlock::indexText(QStringView text)
+{
+    if (!m_searchIndex || text.size() < 3) {
+        return;
+    }
+
+    // case folded, the index serves case sensitive and insensitive searches
+    char16_t a = QChar::toCaseFolded(text[0].unicode());
+    char16_t b = QChar::toCaseFolded(text[1].unicode());
+    for (qsizetype i = 2; i < text.size(); ++i) {
+        const char16_t c = QChar::toCaseFolded(text[i].unicode());
+        m_searchIndex->set(trigramBit(a, b, c));
+        a = b;
+        b = c;
+    }
+}
+
+bool TextBlock::mayContain(const std::vector<uint> &trigrams) const
+{
+    if (!m_searchIndex) {
+        return true;
+    }
+    return std::all_of(trigrams.begin(), trigrams.end(), [this](uint bit) {
+        return m_searchIndex->test(bit);
+    });
+}
+
+std::vector<uint> TextBlock::searchTrigrams(QStringView text)
+{
+    std::vector<uint> trigrams;
+    for (qsizetype i = 2; i < text.size(); ++i) {
+        trigrams.push_back(trigramBit(QChar::toCaseFolded(text[i - 2].unicode()),
+                                      QChar::toCaseFolded(text[i - 1].unicode()),
+                                      QChar::toCaseFolded(text[i].unicode())));
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+static QChar openingBracket(QChar bracket)
+{
+    switch (bracket.unicode()) {
+    case ')':
+        return QLatin1Char('(');
+    case '}':
+        return QLatin1Char('{');
+    case ']':
+        return QLatin1Char('[');
+    }
+    return bracket;
+}
+
+std::vector<TextBlock::Bracket> TextBlock::brackets() const
+{
+    std::vector<Bracket> brackets;
+    for (int line = 0; line < lines(); ++line) {
+        const TextLine &textLine = m_lines[line];
+        const QString &text = textLine->text();
+        for (int column = 0; column < text.size(); ++column) {
+            switch (text[column].unicode()) {
+            case '(':
+            case ')':
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+                brackets.push_back({line, column, text[column], textLine->attribute(column)});
+            }
+        }
+    }
+    return brackets;
+}
+
+const TextBlock::BracketSummary *TextBlock::bracketSummary(QChar open, short attribute)
+{
+    if (!m_bracketSummaries) {
+        m_bracketSummaries = std::make_unique<std::vector<BracketSummary>>();
+
+        // per summary the minimum of the sums before each bracket, the maximum suffix is the sum minus it
+        std::vector<int> minBefore;
+        for (const Bracket &bracket : brackets()) {
+            const QChar bracketOpen = openingBracket(bracket.character);
+            auto it = std::find_if(m_bracketSummaries->begin(), m_bracketSummaries->end(), [&](const BracketSummary &summary) {
+                return summary.open == bracketOpen && summary.attribute == bracket.attribute;
+            });
+            if (it == m_bracketSummaries->end()) {
+                m_bracketSummaries->push_back({bracketOpen, bracket.attribute});
+                minBefore.push_back(0);
+                it = m_bracketSummaries->end() - 1;
+            }
+
+            int &before = minBefore[it - m_bracketSummaries->begin()];
+            before = qMin(before, it->delta);
+            it->delta += (bracket.character == bracketOpen) ? 1 : -1;
+            it->minPrefix = qMin(it->minPrefix, it->delta);
+        }
+
+        for (size_t i = 0; i < m_bracketSummaries->size(); ++i) {
+            BracketSummary &summary = (*m_bracketSummaries)[i];
+            summary.maxSuffix = qMax(0, summary.delta - minBefore[i]);
+        }
+    }
+
+    for (const auto &summary : *m_bracketSummaries) {
+        if (summary.open == open && summary.attribute == attribute) {
+            return &summary;
+        }
+    }
+    return nullptr;
 }
 
 void TextBlock::text(QString &text) const
@@ -73,6 +219,10 @@ void TextBlock::wrapLine(const KTextEditor::Cursor position, int fixStartLinesSt
 {
     // calc internal line
     int line = position.line() - startLine();
+    moveEditedLines(line + 1, 1);
+    markLineEdited(line);
+    markLineEdited(line + 1);
+    invalidateBrackets();
 
     // get text
     QString &text = m_lines.at(line)->textReadWrite();
@@ -180,6 +330,7 @@ void TextBlock::unwrapLine(int line, TextBlock *previousBlock, int fixStartLines
 {
     // calc internal line
     line = line - startLine();
+    invalidateBrackets();
 
     // two possiblities: either first line of this block or later line
     if (line == 0) {
@@ -193,6 +344,9 @@ void TextBlock::unwrapLine(int line, TextBlock *previousBlock, int fixStartLines
         TextLine newFirst = previousBlock->m_lines.back();
         m_lines[0] = newFirst;
         previousBlock->m_lines.erase(previousBlock->m_lines.begin() + (previousBlock->lines() - 1));
+        previousBlock->moveEditedLines(lastLineOfPreviousBlock, -1);
+        previousBlock->invalidateBrackets();
+        markLineEdited(0);
 
         const int oldSizeOfPreviousLine = newFirst->text().size();
         if (oldFirst->length() > 0) {
@@ -203,6 +357,9 @@ void TextBlock::unwrapLine(int line, TextBlock *previousBlock, int fixStartLines
             newFirst->markAsModified(true);
         }
 
+        // the line is new to this block
+        indexText(newFirst->text());
+
         // patch startLine of this block
         --m_startLine;
 
@@ -279,10 +436,15 @@ void TextBlock::unwrapLine(int line, TextBlock *previousBlock, int fixStartLines
     }
 
     // easy: just move text to previous line and remove current one
+    moveEditedLines(line, -1);
+    markLineEdited(line - 1);
     const int oldSizeOfPreviousLine = m_lines.at(line - 1)->length();
     const int sizeOfCurrentLine = m_lines.at(line)->length();
     if (sizeOfCurrentLine > 0) {
         m_lines.at(line - 1)->textReadWrite().append(m_lines.at(line)->text());
+
+        // only the trigrams across the junction are new
+        indexText(QStringView(m_lines.at(line - 1)->text()).mid(qMax(0, oldSizeOfPreviousLine - 2), 4));
     }
 
     const bool lineChanged = (oldSizeOfPreviousLine > 0 && m_lines.at(line - 1)->markedAsModified())
@@ -351,6 +513,8 @@ void TextBlock::insertText(const KTextEditor::Cursor position, const QString &te
 {
     // calc internal line
     int line = position.line() - startLine();
+    markLineEdited(line);
+    invalidateBrackets();
 
     // get text
     QString &textOfLine = m_lines.at(line)->textReadWrite();
@@ -363,6 +527,8 @@ void TextBlock::insertText(const KTextEditor::Cursor position, const QString &te
 
     // insert text
     textOfLine.insert(position.column(), text);
+    const int indexStart = qMax(0, position.column() - 2);
+    indexText(QStringView(textOfLine).mid(indexStart, position.column() - indexStart + text.size() + 2));
 
     // notify the text history
     m_buffer->history().insertText(position, text.size(), oldLength);
@@ -417,9 +583,19 @@ void TextBlock::insertText(const KTextEditor::Cursor position, const QString &te
 }
 
 void TextBlock::removeText(KTextEditor::Range range, QString &removedText)
+{
+    // get text which will be removed
+    removedText = m_lines.at(range.start().line() - startLine())->string(range.start().column(), range.end().column() - range.start().column());
+
+    removeText(range);
+}
+
+void TextBlock::removeText(KTextEditor::Range range)
 {
     // calc internal line
     int line = range.start().line() - startLine();
+    markLineEdited(line);
+    invalidateBrackets();
 
     // get text
     QString &textOfLine = m_lines.at(line)->textReadWrite();
@@ -431,12 +607,11 @@ void TextBlock::removeText(KTextEditor::Range range, QString &removedText)
     Q_ASSERT(range.end().column() >= 0);
     Q_ASSERT(range.end().column() <= textOfLine.size());
 
-    // get text which will be removed
-    removedText = textOfLine.mid(range.start().column(), range.end().column() - range.start().column());
-
     // remove text
     textOfLine.remove(range.start().column(), range.end().column() - range.start().column());
     m_lines.at(line)->markAsModified(true);
+    indexText(QStringView(textOfLine).mid(qMax(0, range.start().column() - 2), 4));
+    m_searchIndexRemovals += range.end().column() - range.start().column();
 
     // notify the text history
     m_buffer->history().removeText(range, oldLength);
@@ -485,6 +660,197 @@ void TextBlock::removeText(KTextEditor::Range range, QString &removedText)
     }
 }
 
+void TextBlock::insertText(const std::vector<KTextEditor::Cursor> &positions, const QString &text)
+{
+    // calc internal line
+    const int bufferLine = positions.front().line();
+    const int line = bufferLine - startLine();
+    markLineEdited(line);
+    invalidateBrackets();
+
+    // get text
+    QString &textOfLine = m_lines.at(line)->textReadWrite();
+    const int oldLength = textOfLine.size();
+    m_lines.at(line)->markAsModified(true);
+
+    // build the new line in one go, inserting at each position would move the rest of the line every time
+    QString newText;
+    newText.reserve(oldLength + int(positions.size()) * text.size());
+    int copied = 0;
+    for (const KTextEditor::Cursor position : positions) {
+        Q_ASSERT(position.line() == bufferLine);
+        Q_ASSERT(position.column() >= copied);
+        Q_ASSERT(position.column() <= oldLength);
+        newText += QStringView(textOfLine).mid(copied, position.column() - copied);
+        newText += text;
+        copied = position.column();
+    }
+    newText += QStringView(textOfLine).mid(copied);
+    textOfLine = std::move(newText);
+
+    // index and notify the text history like single insertions from the front
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        const int shift = int(i) * text.size();
+        const int column = positions[i].column() + shift;
+        const int indexStart = qMax(0, column - 2);
+        indexText(QStringView(textOfLine).mid(indexStart, column - indexStart + text.size() + 2));
+        m_buffer->history().insertText(KTextEditor::Cursor(bufferLine, column), text.size(), oldLength + shift);
+    }
+
+    // cursor and range handling below
+
+    // no cursors in this block, no work to do..
+    if (m_cursors.empty()) {
+        return;
+    }
+
+    // move all cursors on the line by the text inserted in front of them
+    // remember all ranges modified, optimize for the standard case of a few ranges
+    QVarLengthArray<TextRange *, 32> changedRanges;
+    for (TextCursor *cursor : m_cursors) {
+        // skip cursors not on this line!
+        if (cursor->lineInBlock() != line) {
+            continue;
+        }
+
+        // an insertion at the column of the cursor only moves it if it moves on insert
+        const int column = cursor->column();
+        const auto behind = cursor->m_moveOnInsert ? std::upper_bound(positions.begin(),
+                                                                      positions.end(),
+                                                                      column,
+                                                                      [](int value, KTextEditor::Cursor position) {
+                                                                          return value < position.column();
+                                                                      })
+                                                   : std::lower_bound(positions.begin(), positions.end(), column, [](KTextEditor::Cursor position, int value) {
+                                                         return position.column() < value;
+                                                     });
+        const int insertions = behind - positions.begin();
+        if (insertions == 0) {
+            continue;
+        }
+
+        // patch column of cursor
+        if (cursor->m_column <= oldLength) {
+            cursor->m_column += insertions * text.size();
+        }
+
+        // special handling if cursor behind the real line, e.g. non-wrapping cursor in block selection mode
+        else if (cursor->m_column < textOfLine.size()) {
+            cursor->m_column = textOfLine.size();
+        }
+
+        // remember range, if any, avoid double insert
+        // we only need to trigger checkValidity later if the range has feedback or might be invalidated
+        auto range = cursor->kateRange();
+        if (range && !range->isValidityCheckRequired() && (range->feedback() || range->start().line() == range->end().line())) {
+            range->setValidityCheckRequired();
+            changedRanges.push_back(range);
+        }
+    }
+
+    // we might need to invalidate ranges or notify about their changes
+    // checkValidity might trigger delete of the range!
+    for (TextRange *range : std::as_const(changedRanges)) {
+        range->checkValidity(range->toLineRange());
+    }
+}
+
+void TextBlock::removeText(const std::vector<KTextEditor::Range> &ranges, QStringList &removedTexts)
+{
+    // calc internal line
+    const int bufferLine = ranges.front().start().line();
+    const int line = bufferLine - startLine();
+    markLineEdited(line);
+    invalidateBrackets();
+
+    // get text
+    QString &textOfLine = m_lines.at(line)->textReadWrite();
+    const int oldLength = textOfLine.size();
+
+    // build the new line in one go, remember the removed text and how much is removed in front of each range
+    QString newText;
+    newText.reserve(oldLength);
+    removedTexts.clear();
+    removedTexts.reserve(ranges.size());
+    std::vector<int> removedBefore;
+    removedBefore.reserve(ranges.size());
+    int copied = 0;
+    for (const KTextEditor::Range &range : ranges) {
+        Q_ASSERT(range.start().line() == bufferLine && range.end().line() == bufferLine);
+        Q_ASSERT(range.start().column() >= copied);
+        Q_ASSERT(range.end().column() <= oldLength);
+        removedBefore.push_back(copied - newText.size());
+        newText += QStringView(textOfLine).mid(copied, range.start().column() - copied);
+        removedTexts.append(textOfLine.mid(range.start().column(), range.columnWidth()));
+        copied = range.end().column();
+    }
+    newText += QStringView(textOfLine).mid(copied);
+    m_searchIndexRemovals += oldLength - newText.size();
+    textOfLine = std::move(newText);
+    m_lines.at(line)->markAsModified(true);
+
+    // index and notify the text history like single removals from the back
+    int lineLength = oldLength;
+    for (std::size_t i = ranges.size(); i-- > 0;) {
+        m_buffer->history().removeText(ranges[i], lineLength);
+        lineLength -= ranges[i].columnWidth();
+    }
+    for (std::size_t i = 0; i < ranges.size(); ++i) {
+        const int column = ranges[i].start().column() - removedBefore[i];
+        indexText(QStringView(textOfLine).mid(qMax(0, column - 2), 4));
+    }
+
+    // cursor and range handling below
+
+    // no cursors in this block, no work to do..
+    if (m_cursors.empty()) {
+        return;
+    }
+
+    // move all cursors on the line which has the text removed
+    // remember all ranges modified, optimize for the standard case of a few ranges
+    QVarLengthArray<TextRange *, 32> changedRanges;
+    for (TextCursor *cursor : m_cursors) {
+        // skip cursors not on this line!
+        if (cursor->lineInBlock() != line) {
+            continue;
+        }
+
+        // the first range not completely in front of the cursor
+        const int column = cursor->column();
+        const auto it = std::lower_bound(ranges.begin(), ranges.end(), column, [](const KTextEditor::Range &range, int value) {
+            return range.end().column() < value;
+        });
+        const std::size_t index = it - ranges.begin();
+
+        // patch column of cursor, a cursor inside a removed range moves to its start
+        int newColumn = column;
+        if (it != ranges.end() && column > it->start().column()) {
+            newColumn = it->start().column() - removedBefore[index];
+        } else if (index > 0) {
+            newColumn = column - (removedBefore[index - 1] + ranges[index - 1].columnWidth());
+        }
+        if (newColumn == column) {
+            continue;
+        }
+        cursor->m_column = newColumn;
+
+        // remember range, if any, avoid double insert
+        // we only need to trigger checkValidity later if the range has feedback or might be invalidated
+        auto range = cursor->kateRange();
+        if (range && !range->isValidityCheckRequired() && (range->feedback() || range->start().line() == range->end().line())) {
+            range->setValidityCheckRequired();
+            changedRanges.push_back(range);
+        }
+    }
+
+    // we might need to invalidate ranges or notify about their changes
+    // checkValidity might trigger delete of the range!
+    for (TextRange *range : std::as_const(changedRanges)) {
+        range->checkValidity(range->toLineRange());
+    }
+}
+
 void TextBlock::debugPrint(int blockIndex) const
 {
     // print all blocks
@@ -512,6 +878,29 @@ TextBlock *TextBlock::splitBlock(int fromLine)
     }
     m_lines.resize(fromLine);
 
+    // the edited lines of the second half move along
+    const auto firstMovedLine = std::lower_bound(m_editedLines.begin(), m_editedLines.end(), fromLine);
+    for (auto it = firstMovedLine; it != m_editedLines.end(); ++it) {
+        newBlock->m_editedLines.push_back(*it - fromLine);
+    }
+    m_editedLines.erase(firstMovedLine, m_editedLines.end());
+
+    // the index of the whole block is a superset for both halves, the lines of the other half count as removed
+    if (m_searchIndex) {
+        newBlock->m_searchIndex = std::make_unique<std::bitset<SearchIndexBits>>(*m_searchIndex);
+        int movedCharacters = 0;
+        for (const auto &movedLine : newBlock->m_lines) {
+            movedCharacters += movedLine->length();
+        }
+        int keptCharacters = 0;
+        for (const auto &keptLine : m_lines) {
+            keptCharacters += keptLine->length();
+        }
+        newBlock->m_searchIndexRemovals = m_searchIndexRemovals + keptCharacters;
+        m_searchIndexRemovals += movedCharacters;
+    }
+    invalidateBrackets();
+
     // move cursors
     for (auto it = m_cursors.begin(); it != m_cursors.end();) {
         auto cursor = *it;
@@ -556,6 +945,12 @@ void TextBlock::mergeBlock(TextBlock *targetBlock)
     }
     m_cursors.clear();
 
+    // the edited lines move along, behind the ones of the target
+    for (int line : m_editedLines) {
+        targetBlock->m_editedLines.push_back(line + targetBlock->lines());
+    }
+    m_editedLines.clear();
+
     // move lines
     targetBlock->m_lines.reserve(targetBlock->lines() + lines());
     for (size_t i = 0; i < m_lines.size(); ++i) {
@@ -563,6 +958,17 @@ void TextBlock::mergeBlock(TextBlock *targetBlock)
     }
     m_lines.clear();
 
+    // the merged block only has an index if both had one
+    if (targetBlock->m_searchIndex && m_searchIndex) {
+        *targetBlock->m_searchIndex |= *m_searchIndex;
+        targetBlock->m_searchIndexRemovals += m_searchIndexRemovals;
+    } else {
+        targetBlock->m_searchIndex.reset();
+    }
+    m_searchIndex.reset();
+    targetBlock->invalidateBrackets();
+    invalidateBrackets();
+
     // fix ALL ranges!
     // copy is necessary as update range may modify the uncached ranges
     std::vector<TextRange *> allRanges;
@@ -600,6 +1006,8 @@ void TextBlock::deleteBlockContent()
 
     // kill lines
     m_lines.clear();
+    m_editedLines.clear();
+    invalidateBrackets();
 }
 
 void TextBlock::clearBlockContent(TextBlock *targetBlock)
@@ -624,6 +1032,8 @@ void TextBlock::clearBlockContent(TextBlock *targetBlock)
 
     // kill lines
     m_lines.clear();
+    m_editedLines.clear();
+    invalidateBrackets();
 }
 
 QVector<TextRange *> TextBlock::rangesForLine(int line, KTextEditor::View *view, bool rangesWithAttributeOnly) const
@@ -661,12 +1071,33 @@ QVector<TextRange *> TextBlock::rangesForLine(int line, KTextEditor::View *view,
 
 void TextBlock::markModifiedLinesAsSaved()
 {
-    // mark all modified lines as saved
-    for (auto &textLine : m_lines) {
+    // mark the modified lines as saved, only edited ones can be modified
+    for (int line : m_editedLines) {
+        const TextLine &textLine = m_lines.at(line);
         if (textLine->markedAsModified()) {
             textLine->markAsSavedOnDisk(true);
         }
     }
+    m_editedLines.clear();
+}
+
+void TextBlock::markLineEdited(int line)
+{
+    const auto it = std::lower_bound(m_editedLines.begin(), m_editedLines.end(), line);
+    if (it == m_editedLines.end() || *it != line) {
+        m_editedLines.insert(it, line);
+    }
+}
+
+void TextBlock::moveEditedLines(int line, int delta)
+{
+    auto it = std::lower_bound(m_editedLines.begin(), m_editedLines.end(), line);
+    if (delta < 0) {
+        it = m_editedLines.erase(it, std::lower_bound(it, m_editedLines.end(), line - delta));
+    }
+    for (; it != m_editedLines.end(); ++it) {
+        *it += delta;
+    }
 }
 
 void TextBlock::updateRange(TextRange *range)
@@ -9,10 +9,14 @@
 
 #include "katetextline.h"
 
+#include <bitset>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <QSet>
+#include <QStringList>
 #include <QVarLengthArray>
 #include <QVector>
 
@@ -96,6 +100,112 @@ public:
      */
     void clearLines();
 
+    /**
+     * Number of bits of the trigram filter of the search index.
+     */
+    static constexpr std::size_t SearchIndexBits = 4096;
+
+    /**
+     * Build the search index of this block from all its lines.
+     * The index is a filter over the case folded trigrams of the lines: it can have false
+     * positives but no false negatives. Edits keep an existing index up-to-date.
+     */
+    void buildSearchIndex();
+
+    /**
+     * Should the search index be built again?
+     * Edits only add trigrams, the ones of removed text stay set. The index is outdated after
+     * enough characters got removed or if it is saturated after some removals.
+     * @return search index available but outdated
+     */
+    bool searchIndexOutdated() const;
+
+    /**
+     * Drop the search index of this block.
+     */
+    void clearSearchIndex()
+    {
+        m_searchIndex.reset();
+    }
+
+    /**
+     * Has this block a search index?
+     * @return search index available?
+     */
+    bool hasSearchIndex() const
+    {
+        return bool(m_searchIndex);
+    }
+
+    /**
+     * Might some line of this block contain a text with the given trigrams?
+     * Always true without a search index.
+     * @param trigrams trigrams of the searched text, see searchTrigrams()
+     * @return block might contain the text
+     */
+    bool mayContain(const std::vector<uint> &trigrams) const;
+
+    /**
+     * The trigrams of @p text to check with mayContain(), empty for texts shorter than 3 characters.
+     * @param text searched text
+     * @return sorted trigrams without duplicates
+     */
+    static std::vector<uint> searchTrigrams(QStringView text);
+
+    /**
+     * A bracket (){}[] of a line of this block.
+     */
+    struct Bracket {
+        // line in the block
+        int line;
+        int column;
+        QChar character;
+        // attribute value of the column, only brackets with the same attribute match
+        short attribute;
+    };
+
+    /**
+     * The brackets of the lines of this block in document order, read from the lines on each call.
+     * The attributes of the lines must be up-to-date.
+     * @return brackets of this block
+     */
+    std::vector<Bracket> brackets() const;
+
+    /**
+     * Summary of the brackets of one kind and attribute in this block, counting the opening
+     * bracket as +1 and the closing one as -1 in document order.
+     */
+    struct BracketSummary {
+        // opening bracket character of the kind
+        QChar open;
+        // attribute value of the brackets
+        short attribute;
+        // sum over all brackets
+        int delta = 0;
+        // minimum of the sums from the start of the block up to each bracket, at most 0
+        int minPrefix = 0;
+        // maximum of the sums from each bracket up to the end of the block, at least 0
+        int maxSuffix = 0;
+    };
+
+    /**
+     * Summary of the brackets of the kind of @p open with the attribute @p attribute.
+     * The summaries are computed from the brackets of the lines on first use, the attributes
+     * of the lines must be up-to-date then, see invalidateBrackets().
+     * @param open opening bracket character
+     * @param attribute attribute value of the brackets
+     * @return summary, nullptr if the block contains no such bracket
+     */
+    const BracketSummary *bracketSummary(QChar open, short attribute);
+
+    /**
+     * Drop the bracket summaries, done on edits and if the attributes of the lines changed.
+     */
+    void invalidateBrackets()
+    {
+        m_bracketSummaries.reset();
+    }
+
     /**
      * Number of lines in this block.
      * @return number of lines
@@ -140,6 +250,28 @@ public:
      */
     void removeText(KTextEditor::Range range, QString &removedText);
 
+    /**
+     * Remove text at given range, without retrieving the removed text.
+     * @param range range of text to remove, must be on one line only.
+     */
+    void removeText(KTextEditor::Range range);
+
+    /**
+     * Insert text at several positions of one line, like insertText() for each position
+     * from the front, but the line is changed only once.
+     * @param positions positions on one line, sorted and distinct, valid before the insertion
+     * @param text text to insert at each position
+     */
+    void insertText(const std::vector<KTextEditor::Cursor> &positions, const QString &text);
+
+    /**
+     * Remove several ranges of one line, like removeText() for each range
+     * from the back, but the line is changed only once.
+     * @param ranges ranges on one line, sorted and not overlapping
+     * @param removedTexts will be filled with the removed text of each range
+     */
+    void removeText(const std::vector<KTextEditor::Range> &ranges, QStringList &removedTexts);
+
     /**
      * Debug output, print whole block content with line numbers and line length
      * @param blockIndex index of this block in buffer
@@ -195,6 +327,7 @@ public:
 
     /**
      * Flag all modified text lines as saved on disk.
+     * Only the lines edited since the last call are looked at.
      */
     void markModifiedLinesAsSaved();
 
@@ -245,6 +378,26 @@ public:
         }
     }
 
+private:
+    /**
+     * Add the trigrams of @p text to the search index, if any.
+     * @param text text of a line or of a part of it
+     */
+    void indexText(QStringView text);
+
+    /**
+     * Remember that the line @p line of this block was edited since the last markModifiedLinesAsSaved().
+     * @param line line relative to this block
+     */
+    void markLineEdited(int line);
+
+    /**
+     * Move the remembered edited lines from @p line on by @p delta, for lines inserted or removed in front of them.
+     * @param line first line to move, relative to this block
+     * @param delta number of lines, for negative values the lines in between are forgotten
+     */
+    void moveEditedLines(int line, int delta);
+
 private:
     /**
      * parent text buffer
@@ -257,6 +410,12 @@ private:
      */
     std::vector<Kate::TextLine> m_lines;
 
+    /**
+     * Lines edited since the last markModifiedLinesAsSaved(), relative to this block, sorted.
+     * The undo manager only changes the modification flags of lines it edits.
+     */
+    std::vector<int> m_editedLines;
+
     /**
      * Startline of this block
      */
@@ -283,6 +442,23 @@ private:
      * This contains all the ranges that are not cached.
      */
     QVarLengthArray<TextRange *, 1> m_uncachedRanges;
+
+    /**
+     * Search index, a filter of the trigrams of all lines, nullptr if not built.
+     * Edits only add trigrams, the filter is a superset after removals, see searchIndexOutdated().
+     */
+    std::unique_ptr<std::bitset<SearchIndexBits>> m_searchIndex;
+
+    /**
+     * Characters removed from the lines of this block since the search index was built,
+     * their trigrams might still be set in the index.
+     */
+    int m_searchIndexRemovals = 0;
+
+    /**
+     * Bracket summaries for each bracket kind and attribute found, nullptr if not computed.
+     */
+    std::unique_ptr<std::vector<BracketSummary>> m_bracketSummaries;
 };
 
 }
@@ -30,6 +30,10 @@
 #include <QFileInfo>
 #include <QStringEncoder>
 #include <QTemporaryFile>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <optional>
 
 #if HAVE_KAUTH
 #include "katesecuretextbuffer_p.h"
@@ -64,6 +68,11 @@ TextBuffer::TextBuffer(KTextEditor::DocumentPrivate *parent, bool alwaysUseKAuth
     , m_lineLengthLimit(4096)
     , m_alwaysUseKAuthForSave(alwaysUseKAuth)
 {
+    // build the search index in small batches to keep the ui responsive
+    m_searchIndexTimer.setSingleShot(true);
+    m_searchIndexTimer.setInterval(10);
+    connect(&m_searchIndexTimer, &QTimer::timeout, this, &TextBuffer::buildSearchIndexBatch);
+
     // create initial state
     clear();
 }
@@ -144,6 +153,12 @@ void TextBuffer::clear()
     // clear edit history
     m_history.clear();
 
+    // index the new content later, e.g. after a load
+    m_searchIndexProgress = 0;
+    if (m_searchIndexEnabled) {
+        m_searchIndexTimer.start();
+    }
+
     // we got cleared
     Q_EMIT cleared();
 }
@@ -383,6 +398,17 @@ void TextBuffer::insertText(const KTextEditor::Cursor position, const QString &t
 }
 
 void TextBuffer::removeText(KTextEditor::Range range)
+{
+    // skip work, if no text to remove
+    if (range.isEmpty()) {
+        return;
+    }
+
+    // retrieve the text to remove, this will assert on invalid line
+    removeText(range, line(range.start().line())->string(range.start().column(), range.end().column() - range.start().column()));
+}
+
+void TextBuffer::removeText(KTextEditor::Range range, const QString &removedText)
 {
     // debug output for REAL low-level debugging
     BUFFER_DEBUG << "removeText" << range;
@@ -405,9 +431,9 @@ void TextBuffer::removeText(KTextEditor::Range range)
     // get block, this will assert on invalid line
     int blockIndex = blockForLine(range.start().line());
 
-    // let the block handle the removeText, retrieve removed text
-    QString text;
-    m_blocks.at(blockIndex)->removeText(range, text);
+    // let the block handle the removeText, the removed text is known
+    Q_ASSERT(removedText.size() == range.end().column() - range.start().column());
+    m_blocks.at(blockIndex)->removeText(range);
 
     // remember changes
     ++m_revision;
@@ -422,9 +448,93 @@ void TextBuffer::removeText(KTextEditor::Range range)
     }
 
     // emit signal about done change
-    Q_EMIT textRemoved(range, text);
+    Q_EMIT textRemoved(range, removedText);
     if (m_document) {
-        Q_EMIT m_document->KTextEditor::Document::textRemoved(m_document, range, text);
+        Q_EMIT m_document->KTextEditor::Document::textRemoved(m_document, range, removedText);
+    }
+}
+
+void TextBuffer::insertText(const std::vector<KTextEditor::Cursor> &positions, const QString &text)
+{
+    // debug output for REAL low-level debugging
+    BUFFER_DEBUG << "insertText" << positions.size() << text;
+
+    // only allowed if editing transaction running
+    Q_ASSERT(m_editingTransactions > 0);
+
+    // skip work, if no text to insert
+    if (positions.empty() || text.isEmpty()) {
+        return;
+    }
+
+    // get block, this will assert on invalid line
+    const int line = positions.front().line();
+    int blockIndex = blockForLine(line);
+
+    // let the block handle the insertText
+    m_blocks.at(blockIndex)->insertText(positions, text);
+
+    // remember changes
+    m_revision += positions.size();
+
+    // update changed line interval
+    if (line < m_editingMinimalLineChanged || m_editingMinimalLineChanged == -1) {
+        m_editingMinimalLineChanged = line;
+    }
+
+    if (line > m_editingMaximalLineChanged) {
+        m_editingMaximalLineChanged = line;
+    }
+
+    // emit signal about done changes, from the front, each position shifted by the text inserted before
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        const KTextEditor::Cursor position(line, positions[i].column() + int(i) * text.size());
+        Q_EMIT textInserted(position, text);
+        if (m_document) {
+            Q_EMIT m_document->KTextEditor::Document::textInserted(m_document, position, text);
+        }
+    }
+}
+
+void TextBuffer::removeText(const std::vector<KTextEditor::Range> &ranges)
+{
+    // debug output for REAL low-level debugging
+    BUFFER_DEBUG << "removeText" << ranges.size();
+
+    // only allowed if editing transaction running
+    Q_ASSERT(m_editingTransactions > 0);
+
+    // skip work, if no text to remove
+    if (ranges.empty()) {
+        return;
+    }
+
+    // get block, this will assert on invalid line
+    const int line = ranges.front().start().line();
+    int blockIndex = blockForLine(line);
+
+    // let the block handle the removeText, retrieve removed texts
+    QStringList texts;
+    m_blocks.at(blockIndex)->removeText(ranges, texts);
+
+    // remember changes
+    m_revision += ranges.size();
+
+    // update changed line interval
+    if (line < m_editingMinimalLineChanged || m_editingMinimalLineChanged == -1) {
+        m_editingMinimalLineChanged = line;
+    }
+
+    if (line > m_editingMaximalLineChanged) {
+        m_editingMaximalLineChanged = line;
+    }
+
+    // emit signal about done changes, from the back, there the ranges are still valid
+    for (std::size_t i = ranges.size(); i-- > 0;) {
+        Q_EMIT textRemoved(ranges[i], texts.at(i));
+        if (m_document) {
+            Q_EMIT m_document->KTextEditor::Document::textRemoved(m_document, ranges[i], texts.at(i));
+        }
     }
 }
 
@@ -531,6 +641,141 @@ void TextBuffer::balanceBlock(int index)
     m_blocks.erase(m_blocks.begin() + index);
 }
 
+void TextBuffer::setSearchIndexEnabled(bool enabled)
+{
+    if (m_searchIndexEnabled == enabled) {
+        return;
+    }
+
+    m_searchIndexEnabled = enabled;
+    m_searchIndexProgress = 0;
+    if (enabled) {
+        m_searchIndexTimer.start();
+        return;
+    }
+
+    m_searchIndexTimer.stop();
+    for (TextBlock *block : std::as_const(m_blocks)) {
+        block->clearSearchIndex();
+    }
+}
+
+void TextBuffer::buildSearchIndexBatch()
+{
+    // ~16k lines per batch
+    constexpr int blocksPerBatch = 256;
+
+    int built = 0;
+    for (; m_searchIndexProgress < m_blocks.size(); ++m_searchIndexProgress) {
+        TextBlock *block = m_blocks[m_searchIndexProgress];
+        if (block->hasSearchIndex()) {
+            continue;
+        }
+
+        if (built == blocksPerBatch) {
+            m_searchIndexTimer.start();
+            return;
+        }
+        block->buildSearchIndex();
+        ++built;
+    }
+}
+
+int TextBuffer::searchCandidateLine(int line, int lastLine, const std::vector<uint> &trigrams)
+{
+    if (!m_searchIndexEnabled || trigrams.empty()) {
+        return line;
+    }
+
+    const int step = (lastLine < line) ? -1 : 1;
+    for (int index = blockForLine(line); index >= 0 && index < (int)m_blocks.size(); index += step) {
+        TextBlock *block = m_blocks[index];
+        if (!block->hasSearchIndex() || block->searchIndexOutdated()) {
+            block->buildSearchIndex();
+        }
+
+        const int blockLastLine = block->startLine() + block->lines() - 1;
+        if (block->lines() > 0 && block->mayContain(trigrams)) {
+            return (step > 0) ? qMax(line, block->startLine()) : qMin(line, blockLastLine);
+        }
+
+        // the next block is out of range
+        if ((step > 0) ? (blockLastLine >= lastLine) : (block->startLine() <= lastLine)) {
+            break;
+        }
+    }
+    return -1;
+}
+
+KTextEditor::Cursor TextBuffer::findMatchingBracket(const KTextEditor::Cursor position,
+                                                    QChar bracket,
+                                                    QChar opposite,
+                                                    bool forward,
+                                                    short attribute,
+                                                    int minLine,
+                                                    int maxLine,
+                                                    const std::function<bool(int)> &prepareLines)
+{
+    // the bracket itself is open, found if this drops to zero
+    int nesting = 1;
+
+    const QChar open = forward ? bracket : opposite;
+    const int step = forward ? 1 : -1;
+    for (int index = blockForLine(position.line()); index >= 0 && index < int(m_blocks.size()); index += step) {
+        TextBlock *block = m_blocks[index];
+        const int blockFirstLine = block->startLine();
+        const int blockLastLine = blockFirstLine + block->lines() - 1;
+        if (forward ? (blockFirstLine > maxLine) : (blockLastLine < minLine)) {
+            break;
+        }
+        if (!prepareLines(blockLastLine)) {
+            break;
+        }
+
+        // skip whole blocks in range that can't contain the match, the nesting doesn't drop to zero anywhere in them
+        if (forward ? (blockFirstLine > position.line() && blockLastLine <= maxLine) : (blockLastLine < position.line() && blockFirstLine >= minLine)) {
+            const TextBlock::BracketSummary *summary = block->bracketSummary(open, attribute);
+            if (!summary) {
+                continue;
+            }
+            if (forward ? (nesting + summary->minPrefix > 0) : (nesting - summary->maxSuffix > 0)) {
+                nesting += forward ? summary->delta : -summary->delta;
+                continue;
+            }
+        }
+
+        const std::vector<TextBlock::Bracket> brackets = block->brackets();
+        const int count = int(brackets.size());
+        for (int i = 0; i < count; ++i) {
+            const TextBlock::Bracket &candidate = brackets[forward ? i : count - 1 - i];
+            const KTextEditor::Cursor candidatePosition(blockFirstLine + candidate.line, candidate.column);
+            if ((forward ? candidatePosition <= position : candidatePosition >= position) || candidatePosition.line() < minLine
+                || candidatePosition.line() > maxLine || candidate.attribute != attribute) {
+                continue;
+            }
+            if (candidate.character == bracket) {
+                ++nesting;
+            } else if (candidate.character == opposite && --nesting == 0) {
+                return candidatePosition;
+            }
+        }
+    }
+
+    return KTextEditor::Cursor::invalid();
+}
+
+void TextBuffer::invalidateBrackets(int startLine, int endLine)
+{
+    if (startLine > endLine || startLine < 0 || endLine >= lines()) {
+        return;
+    }
+
+    const int lastIndex = blockForLine(endLine);
+    for (int index = blockForLine(startLine); index <= lastIndex; ++index) {
+        m_blocks.at(index)->invalidateBrackets();
+    }
+}
+
 void TextBuffer::debugPrint(const QString &title) const
 {
     // print header with title
@@ -756,9 +1001,85 @@ bool TextBuffer::save(const QString &filename)
     return true;
 }
 
-bool TextBuffer::saveBuffer(const QString &filename, KCompressionDevice &saveFile)
+namespace
+{
+/**
+ * A run of consecutive blocks that is encoded in one go when saving.
+ */
+struct SaveChunk {
+    size_t firstBlock = 0;
+    size_t lastBlock = 0;
+    qsizetype characters = 0;
+    qsizetype bytes = -1;
+};
+
+// characters per chunk, large enough to make each write a big one
+constexpr qsizetype saveChunkSize = 1024 * 1024;
+
+// below this size, spinning up threads costs more than it saves
+constexpr qsizetype parallelSaveSize = 8 * saveChunkSize;
+
+/**
+ * Size of @p text encoded with @p encoding, without byte order mark, -1 if only the encoder knows.
+ * Lone surrogates might be counted wrong, the written size has to be checked.
+ */
+qsizetype encodedSize(QStringView text, QStringConverter::Encoding encoding)
+{
+    switch (encoding) {
+    case QStringConverter::Utf8: {
+        qsizetype size = text.size();
+        for (const QChar c : text) {
+            // two bytes more from U+0800 on, surrogates take two each, four for the pair
+            if (c.unicode() >= 0x80) {
+                size += (c.unicode() >= 0x800 && !c.isSurrogate()) ? 2 : 1;
+            }
+        }
+        return size;
+    }
+    case QStringConverter::Utf16:
+    case QStringConverter::Utf16LE:
+    case QStringConverter::Utf16BE:
+        return text.size() * 2;
+    case QStringConverter::Utf32:
+    case QStringConverter::Utf32LE:
+    case QStringConverter::Utf32BE:
+        return (text.size() - std::count_if(text.begin(), text.end(), [](QChar c) {
+                    return c.isLowSurrogate();
+                }))
+            * 4;
+    case QStringConverter::Latin1:
+        return text.size();
+    default:
+        return -1;
+    }
+}
+
+/**
+ * Size of the byte order mark written for @p encoding.
+ */
+qsizetype byteOrderMarkSize(QStringConverter::Encoding encoding)
 {
-    QStringEncoder encoder(m_textCodec.toUtf8().constData(), generateByteOrderMark() ? QStringConverter::Flag::WriteBom : QStringConverter::Flag::Default);
+    switch (encoding) {
+    case QStringConverter::Utf8:
+        return 3;
+    case QStringConverter::Utf16:
+    case QStringConverter::Utf16LE:
+    case QStringConverter::Utf16BE:
+        return 2;
+    case QStringConverter::Utf32:
+    case QStringConverter::Utf32LE:
+    case QStringConverter::Utf32BE:
+        return 4;
+    default:
+        return 0;
+    }
+}
+}
+
+bool TextBuffer::saveBuffer(const QString &filename, KCompressionDevice &saveFile, QByteArray &savedDigest)
+{
+    const QByteArray codec = m_textCodec.toUtf8();
+    const QStringConverter::Flags flags = generateByteOrderMark() ? QStringConverter::Flag::WriteBom : QStringConverter::Flag::Default;
 
     // our loved eol string ;)
     QString eol = QStringLiteral("\n");
@@ -768,25 +1089,147 @@ bool TextBuffer::saveBuffer(const QString &filename, KCompressionDevice &saveFil
         eol = QStringLiteral("\r");
     }
 
-    // just dump the lines out ;)
-    for (int i = 0; i < m_lines; ++i) {
-        // dump current line
-        saveFile.write(encoder.encode(line(i)->text()));
+    // split the blocks into chunks of about saveChunkSize characters
+    std::vector<SaveChunk> chunks;
+    qsizetype totalCharacters = 0;
+    for (size_t blockIndex = 0; blockIndex < m_blocks.size(); ++blockIndex) {
+        if (chunks.empty() || chunks.back().characters >= saveChunkSize) {
+            chunks.push_back(SaveChunk{blockIndex, blockIndex, 0, -1});
+        }
+        const TextBlock *block = m_blocks[blockIndex];
+        qsizetype characters = 0;
+        for (int line = block->startLine(); line < block->startLine() + block->lines(); ++line) {
+            characters += block->lineLength(line) + ((line + 1) < m_lines ? eol.size() : 0);
+        }
+        chunks.back().lastBlock = blockIndex;
+        chunks.back().characters += characters;
+        totalCharacters += characters;
+    }
 
-        // append correct end of line string
-        if ((i + 1) < m_lines) {
-            saveFile.write(encoder.encode(eol));
+    // call the given function for each line of a chunk, with the end of line string if one follows
+    const auto forEachLine = [this, &eol](const SaveChunk &chunk, const auto &function) {
+        for (size_t blockIndex = chunk.firstBlock; blockIndex <= chunk.lastBlock; ++blockIndex) {
+            const TextBlock *block = m_blocks[blockIndex];
+            for (int line = block->startLine(); line < block->startLine() + block->lines(); ++line) {
+                function(block->line(line)->text(), (line + 1) < m_lines ? QStringView(eol) : QStringView());
+            }
         }
+    };
+
+    // encode one chunk into the given buffer, one allocation per chunk instead of two per line, the buffers get reused
+    const auto encodeChunk = [&forEachLine](const SaveChunk &chunk, QStringEncoder &encoder, QByteArray &data) {
+        data.resize(encoder.requiredSpace(chunk.characters));
+        char *const begin = data.data();
+        char *out = begin;
+        forEachLine(chunk, [&encoder, &out](const QString &text, QStringView eol) {
+            // dump current line, encoding nothing would still emit the bom
+            if (!text.isEmpty()) {
+                out = encoder.appendToBuffer(out, text);
+            }
 
-        // early out on stream errors
-        if (saveFile.error() != QFileDevice::NoError) {
-            return false;
+            // append correct end of line string
+            if (!eol.isEmpty()) {
+                out = encoder.appendToBuffer(out, eol);
+            }
+        });
+        // requiredSpace() is up to three bytes per character for UTF-8, the capacity stays for the next chunk
+        data.truncate(out - begin);
+    };
+
+    // the built-in encodings are stateless beside the bom, chunks of those can be encoded independently,
+    // all others (and the locale dependent system encoding) get encoded sequentially
+    const auto encoding = QStringConverter::encodingForName(codec.constData());
+    const bool parallel = totalCharacters >= parallelSaveSize && encoding && *encoding != QStringConverter::System;
+    QThreadPool pool;
+
+    // if we write the plain file, compute the git blob hash of it on the fly, no need to read it back later,
+    // the hash starts with the size, the built-in encodings allow to compute it upfront without encoding
+    const bool computeDigest = saveFile.compressionType() == KCompressionDevice::None && encoding && encodedSize(QStringView(), *encoding) >= 0;
+    QCryptographicHash digest(QCryptographicHash::Sha1);
+    qsizetype expectedSize = 0;
+    if (computeDigest) {
+        const auto computeSize = [&forEachLine, &encoding](SaveChunk &chunk) {
+            chunk.bytes = 0;
+            forEachLine(chunk, [&chunk, &encoding](const QString &text, QStringView eol) {
+                chunk.bytes += encodedSize(text, *encoding) + encodedSize(eol, *encoding);
+            });
+        };
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            if (parallel) {
+                pool.start([&computeSize, &chunks, i] {
+                    computeSize(chunks[i]);
+                });
+            } else {
+                computeSize(chunks[i]);
+            }
+        }
+        pool.waitForDone();
+
+        for (const SaveChunk &chunk : chunks) {
+            expectedSize += chunk.bytes;
         }
+        if (expectedSize > 0 && flags.testFlag(QStringConverter::Flag::WriteBom)) {
+            expectedSize += byteOrderMarkSize(*encoding);
+        }
+        const QString header = QStringLiteral("blob %1").arg(expectedSize);
+        digest.addData(QByteArray(header.toLatin1() + '\0'));
     }
 
     // TODO: this only writes bytes when there is text. This is a fine optimization for most cases, but this makes saving
     // an empty file with the BOM set impossible (results to an empty file with 0 bytes, no BOM)
 
+    // encode a batch of chunks while the previous one is written, only these two batches are kept in memory
+    const size_t batchSize = parallel ? size_t(std::max(1, pool.maxThreadCount())) : 1;
+    std::vector<QByteArray> buffers(2 * batchSize);
+    std::optional<QStringEncoder> sequentialEncoder;
+    if (!parallel) {
+        sequentialEncoder.emplace(codec.constData(), flags);
+    }
+    const auto encodeBatch = [&](size_t firstChunk) {
+        QByteArray *batchBuffers = buffers.data() + (firstChunk / batchSize % 2) * batchSize;
+        for (size_t i = firstChunk; i < std::min(firstChunk + batchSize, chunks.size()); ++i) {
+            QByteArray *data = batchBuffers + (i - firstChunk);
+            if (parallel) {
+                pool.start([&, i, data] {
+                    QStringEncoder encoder(*encoding, i == 0 ? flags : QStringConverter::Flag::Default);
+                    encodeChunk(chunks[i], encoder, *data);
+                });
+            } else {
+                encodeChunk(chunks[i], *sequentialEncoder, *data);
+            }
+        }
+    };
+
+    // just dump the chunks out ;)
+    qsizetype writtenSize = 0;
+    encodeBatch(0);
+    for (size_t firstChunk = 0; firstChunk < chunks.size(); firstChunk += batchSize) {
+        pool.waitForDone();
+        if (parallel && firstChunk + batchSize < chunks.size()) {
+            encodeBatch(firstChunk + batchSize);
+        }
+
+        const QByteArray *batchBuffers = buffers.data() + (firstChunk / batchSize % 2) * batchSize;
+        for (size_t i = firstChunk; i < std::min(firstChunk + batchSize, chunks.size()); ++i) {
+            const QByteArray &data = batchBuffers[i - firstChunk];
+            saveFile.write(data);
+            if (computeDigest) {
+                digest.addData(data);
+            }
+            writtenSize += data.size();
+
+            // early out on stream errors, after the encoding still running is done
+            if (saveFile.error() != QFileDevice::NoError) {
+                pool.waitForDone();
+                return false;
+            }
+        }
+
+        if (!parallel && firstChunk + batchSize < chunks.size()) {
+            encodeBatch(firstChunk + batchSize);
+        }
+    }
+
     // close the file, we might want to read from underlying buffer below
     saveFile.close();
 
@@ -796,6 +1239,8 @@ bool TextBuffer::saveBuffer(const QString &filename, KCompressionDevice &saveFil
         return false;
     }
 
+    // an empty digest tells the document to compute it from the written file, also if the size computed upfront was off
+    savedDigest = computeDigest && writtenSize == expectedSize ? digest.result() : QByteArray();
     return true;
 }
 
@@ -820,10 +1265,12 @@ TextBuffer::SaveResult TextBuffer::saveBufferUnprivileged(const QString &filenam
         return SaveResult::MissingPermissions;
     }
 
-    if (!saveBuffer(filename, *saveFile)) {
+    QByteArray savedDigest;
+    if (!saveBuffer(filename, *saveFile, savedDigest)) {
         return SaveResult::Failed;
     }
 
+    setDigest(savedDigest);
     return SaveResult::Success;
 }
 
@@ -860,7 +1307,8 @@ bool TextBuffer::saveBufferEscalated(const QString &filename)
         return false;
     }
 
-    if (!saveBuffer(filename, *saveFile)) {
+    QByteArray savedDigest;
+    if (!saveBuffer(filename, *saveFile, savedDigest)) {
         return false;
     }
 
@@ -914,6 +1362,8 @@ bool TextBuffer::saveBufferEscalated(const QString &filename)
         }
     }
 
+    // only now the file on disk has the saved content
+    setDigest(savedDigest);
     return true;
 #else
     Q_UNUSED(filename);
@@ -9,8 +9,11 @@
 #include <QObject>
 #include <QSet>
 #include <QString>
+#include <QTimer>
 #include <QVector>
 
+#include <functional>
+
 #include "katetextblock.h"
 #include "katetexthistory.h"
 #include <ktexteditor_export.h>
@@ -359,6 +362,29 @@ public:
      */
     virtual void removeText(KTextEditor::Range range);
 
+    /**
+     * Remove text at given range, like removeText() for callers that already know the removed text.
+     * The text isn't copied from the line again.
+     * @param range range of text to remove, must be on one line only.
+     * @param removedText the text in @p range
+     */
+    void removeText(KTextEditor::Range range, const QString &removedText);
+
+    /**
+     * Insert text at several positions of one line, e.g. typing with many cursors. The line is changed once,
+     * the signals are emitted for each position like for insertText() from the front.
+     * @param positions positions on one line, sorted and distinct
+     * @param text text to insert at each position
+     */
+    void insertText(const std::vector<KTextEditor::Cursor> &positions, const QString &text);
+
+    /**
+     * Remove several ranges of one line, e.g. erasing with many cursors. The line is changed once,
+     * the signals are emitted for each range like for removeText() from the back.
+     * @param ranges non-empty ranges on one line, sorted and not overlapping
+     */
+    void removeText(const std::vector<KTextEditor::Range> &ranges);
+
     /**
      * TextHistory of this buffer
      * @return text history for this buffer
@@ -368,6 +394,63 @@ public:
         return m_history;
     }
 
+    /**
+     * Enable or disable the search index of the blocks, see TextBlock::buildSearchIndex().
+     * Once enabled, the index is built block by block when the event loop is idle.
+     * @param enabled enable the search index?
+     */
+    void setSearchIndexEnabled(bool enabled);
+
+    /**
+     * Is the search index enabled?
+     * @return search index enabled?
+     */
+    bool searchIndexEnabled() const
+    {
+        return m_searchIndexEnabled;
+    }
+
+    /**
+     * First line from @p line on towards @p lastLine that might contain a text with the given trigrams.
+     * Skips all blocks that can't contain it according to their search index and builds the
+     * missing indexes on the way. Without search index, this is @p line itself.
+     * @param line line to start at, must be valid
+     * @param lastLine last line to consider, searches backwards if before @p line
+     * @param trigrams trigrams of the searched text, see TextBlock::searchTrigrams()
+     * @return candidate line or -1 if no line up to @p lastLine can contain the text
+     */
+    int searchCandidateLine(int line, int lastLine, const std::vector<uint> &trigrams);
+
+    /**
+     * Find the bracket matching the one at @p position, considering only brackets with the attribute @p attribute.
+     * Whole blocks without a match are skipped using their bracket summaries, see TextBlock::bracketSummary().
+     * @param position position of the bracket to match
+     * @param bracket the bracket at @p position
+     * @param opposite the matching bracket
+     * @param forward search forward, @p bracket is an opening one?
+     * @param attribute attribute value of the brackets that count
+     * @param minLine first line to search
+     * @param maxLine last line to search
+     * @param prepareLines called before the brackets of all lines up to the given one are read, e.g. to highlight them,
+     *                     returns false if their attributes aren't available, the search gives up then
+     * @return position of the matching bracket, invalid if there is none between @p minLine and @p maxLine
+     */
+    KTextEditor::Cursor findMatchingBracket(const KTextEditor::Cursor position,
+                                            QChar bracket,
+                                            QChar opposite,
+                                            bool forward,
+                                            short attribute,
+                                            int minLine,
+                                            int maxLine,
+                                            const std::function<bool(int)> &prepareLines);
+
+    /**
+     * Drop the bracket summaries of the blocks of the given lines, to be called if their attributes changed.
+     * @param startLine first line
+     * @param endLine last line
+     */
+    void invalidateBrackets(int startLine, int endLine);
+
 Q_SIGNALS:
     /**
      * Buffer got cleared. This is emitted when constructor or load have called clear() internally,
@@ -479,13 +562,17 @@ private:
     void markModifiedLinesAsSaved();
 
     /**
-     * Save the current buffer content to the given already opened device
+     * Save the current buffer content to the given already opened device.
+     * Large buffers are encoded in parallel, only a few encoded chunks are kept in memory.
+     * For uncompressed files in one of the built-in encodings the digest is computed
+     * from the written bytes, otherwise it is empty.
      *
      * @param filename path name for display/debugging purposes
      * @param saveFile open device to write the buffer to
+     * @param savedDigest digest of the written content, to be set by the caller once the file is in place
      */
     KTEXTEDITOR_NO_EXPORT
-    bool saveBuffer(const QString &filename, KCompressionDevice &saveFile);
+    bool saveBuffer(const QString &filename, KCompressionDevice &saveFile, QByteArray &savedDigest);
 
     /**
      * Attempt to save the buffer content in the given filename location using
@@ -501,6 +588,12 @@ private:
     KTEXTEDITOR_NO_EXPORT
     bool saveBufferEscalated(const QString &filename);
 
+    /**
+     * Build the search index for the next batch of blocks without one.
+     */
+    KTEXTEDITOR_NO_EXPORT
+    void buildSearchIndexBatch();
+
 public:
     /**
      * Gets the document to which this buffer is bound.
@@ -669,6 +762,21 @@ private:
      */
     bool m_alwaysUseKAuthForSave;
 
+    /**
+     * Search index enabled?
+     */
+    bool m_searchIndexEnabled = false;
+
+    /**
+     * Blocks before this index got their search index built by buildSearchIndexBatch().
+     */
+    size_t m_searchIndexProgress = 0;
+
+    /**
+     * Timer to build the search index in the background
+     */
+    QTimer m_searchIndexTimer;
+
     /**
      * For copying QBuffer -> QTemporaryFile while saving document in privileged mode
      */
@@ -12,6 +12,7 @@
 #include "kateglobal.h"
 #include "katerenderer.h"
 #include "kateview.h"
+#include "katewordindex.h"
 
 #include <ktexteditor/movingrange.h>
 #include <ktexteditor/range.h>
@@ -188,7 +189,7 @@ void KateWordCompletionModel::completionInvoked(KTextEditor::View *view, const K
 }
 
 /**
- * Scan throughout the entire document for possible completions,
+ * Collect the possible completions from the word index of the document,
  * ignoring any dublets and words shorter than configured and/or
  * reasonable minimum length.
  */
@@ -197,32 +198,45 @@ QStringList KateWordCompletionModel::allMatches(KTextEditor::View *view, const K
     QSet<QString> result;
     const int minWordSize = qMax(2, qobject_cast<KTextEditor::ViewPrivate *>(view)->config()->wordCompletionMinimalWordLength());
     const auto cursorPosition = view->cursorPosition();
-    const int lines = view->document()->lines();
-    const auto document = view->document();
-    for (int line = 0; line < lines; line++) {
-        const QString &text = document->line(line);
-        int wordBegin = 0;
-        int offset = 0;
-        const int end = text.size();
-        const bool cursorLine = cursorPosition.line() == line;
-        while (offset < end) {
-            const QChar c = text.at(offset);
-            // increment offset when at line end, so we take the last character too
-            if ((!c.isLetterOrNumber() && c != QLatin1Char('_')) || (offset == end - 1 && offset++)) {
-                if (offset - wordBegin > minWordSize && (line != range.end().line() || offset != range.end().column())) {
-                    // don't add the word we are inside with cursor!
-                    if (!cursorLine || (cursorPosition.column() < wordBegin || cursorPosition.column() > offset)) {
-                        result.insert(text.mid(wordBegin, offset - wordBegin));
-                    }
-                }
-                wordBegin = offset + 1;
+    const auto document = static_cast<KTextEditor::DocumentPrivate *>(view->document());
+
+    // the index doesn't know where the words are, the lines with the words to skip are read here,
+    // a word of the index is only added if it is on other lines, too
+    QList<int> skippedLines = {cursorPosition.line()};
+    if (range.end().line() != cursorPosition.line()) {
+        skippedLines.append(range.end().line());
+    }
+    QHash<QString, int> skippedLinesWithWord;
+    for (const int line : std::as_const(skippedLines)) {
+        if (line < 0 || line >= document->lines()) {
+            continue;
+        }
+        const QString text = document->line(line);
+        QSet<QString> lineWords;
+        KateWordIndex::forEachWord(text, [&](int wordBegin, int length) {
+            if (length < KateWordIndex::minimalWordLength) {
+                return;
             }
-            if (c.isSpace()) {
-                wordBegin = offset + 1;
+            const QString word = text.mid(wordBegin, length);
+            lineWords.insert(word);
+            const int wordEnd = wordBegin + length;
+            if (length > minWordSize && (line != range.end().line() || wordEnd != range.end().column())) {
+                // don't add the word we are inside with cursor!
+                if (line != cursorPosition.line() || (cursorPosition.column() < wordBegin || cursorPosition.column() > wordEnd)) {
+                    result.insert(word);
+                }
             }
-            offset += 1;
+        });
+        for (const QString &word : std::as_const(lineWords)) {
+            ++skippedLinesWithWord[word];
         }
     }
+
+    document->wordIndex()->forEachWord([&](const QString &word, int lines) {
+        if (word.size() > minWordSize && lines > skippedLinesWithWord.value(word)) {
+            result.insert(word);
+        }
+    });
     return result.values();
 }
 
@@ -399,8 +413,19 @@ void KateWordCompletionView::complete(bool fw)
         connect(m_view, &KTextEditor::View::cursorPositionChanged, this, &KateWordCompletionView::slotCursorMoved);
     }
 
-    const QRegularExpression wordRegEx(QLatin1String("\\b") + doc->text(d->dcRange) + QLatin1String("(\\w+)"), QRegularExpression::UseUnicodePropertiesOption);
+    const QString prefix = doc->text(d->dcRange);
+    const QRegularExpression wordRegEx(QLatin1String("\\b") + prefix + QLatin1String("(\\w+)"), QRegularExpression::UseUnicodePropertiesOption);
     int pos(0);
+
+    // the next line to search, the word index skips all lines without a word to complete the prefix to
+    KateWordIndex *wordIndex = static_cast<KTextEditor::DocumentPrivate *>(doc)->wordIndex();
+    const auto nextLine = [&]() {
+        if (prefix.isEmpty()) {
+            const int l = d->dcCursor.line() + inc;
+            return (l < 0 || l >= doc->lines()) ? -1 : l;
+        }
+        return wordIndex->nextLineWithPrefix(prefix, d->dcCursor.line(), fw);
+    };
     QString ln = doc->line(d->dcCursor.line());
 
     while (true) {
@@ -438,13 +463,12 @@ void KateWordCompletionView::complete(bool fw)
 
                 else {
                     if (pos == 0) {
-                        if (d->dcCursor.line() > 0) {
-                            int l = d->dcCursor.line() + inc;
-                            ln = doc->line(l);
-                            d->dcCursor.setPosition(l, ln.length());
-                        } else {
+                        const int l = nextLine();
+                        if (l < 0) {
                             return;
                         }
+                        ln = doc->line(l);
+                        d->dcCursor.setPosition(l, ln.length());
                     }
 
                     else {
@@ -456,11 +480,11 @@ void KateWordCompletionView::complete(bool fw)
 
         else { // no match
             // qCDebug(LOG_KTE)<<"NO MATCH";
-            if ((!fw && d->dcCursor.line() == 0) || (fw && d->dcCursor.line() >= doc->lines())) {
+            const int l = nextLine();
+            if (l < 0) {
                 return;
             }
 
-            int l = d->dcCursor.line() + inc;
             ln = doc->line(l);
             d->dcCursor.setPosition(l, fw ? 0 : ln.length());
         }
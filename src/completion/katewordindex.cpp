@@ -0,0 +1,264 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "katewordindex.h"
+
+#include "katedocument.h"
+
+#include <ktexteditor/linerange.h>
+
+#include <algorithm>
+
+KateWordIndex::KateWordIndex(KTextEditor::DocumentPrivate *document)
+    : m_document(document)
+{
+    connect(document, &KTextEditor::DocumentPrivate::textInsertedRange, this, &KateWordIndex::textInserted);
+    connect(document, &KTextEditor::DocumentPrivate::textRemoved, this, [this](KTextEditor::Document *document, KTextEditor::Range range, const QString &) {
+        textRemoved(document, range);
+    });
+    connect(document, &KTextEditor::DocumentPrivate::textReplayed, this, &KateWordIndex::textReplayed);
+    connect(document, &KTextEditor::DocumentPrivate::aboutToInvalidateMovingInterfaceContent, this, &KateWordIndex::invalidate);
+}
+
+int KateWordIndex::nextLineWithPrefix(const QString &prefix, int line, bool forward)
+{
+    update(true);
+
+    int nearest = -1;
+    for (auto it = m_sortedWords.lower_bound(prefix); it != m_sortedWords.end() && it->first.startsWith(prefix); ++it) {
+        if (it->first.size() == prefix.size()) {
+            continue;
+        }
+
+        const std::vector<int> &lines = it->second->lines;
+        if (forward) {
+            const auto next = std::upper_bound(lines.begin(), lines.end(), line);
+            if (next != lines.end() && (nearest < 0 || *next < nearest)) {
+                nearest = *next;
+            }
+        } else {
+            const auto next = std::lower_bound(lines.begin(), lines.end(), line);
+            if (next != lines.begin() && *(next - 1) > nearest) {
+                nearest = *(next - 1);
+            }
+        }
+    }
+    return nearest;
+}
+
+void KateWordIndex::update(bool lineLists)
+{
+    // the line count is checked in case the document changed without telling us
+    if (!m_built || m_lines.size() != size_t(m_document->lines())) {
+        build();
+    }
+
+    if (m_scanForDirtyLines) {
+        for (int line = 0; line < int(m_lines.size()); ++line) {
+            if (m_lines[line].dirty) {
+                reindexLine(line);
+            }
+        }
+        m_scanForDirtyLines = false;
+    } else {
+        for (int line : m_dirtyLines) {
+            if (m_lines[line].dirty) {
+                reindexLine(line);
+            }
+        }
+    }
+    m_dirtyLines.clear();
+
+    if (lineLists && !m_lineListsValid) {
+        for (auto &word : m_words) {
+            word.second.lines.clear();
+            word.second.lines.reserve(word.second.lineCount);
+        }
+        for (int line = 0; line < int(m_lines.size()); ++line) {
+            for (Word *word : m_lines[line].words) {
+                word->lines.push_back(line);
+            }
+        }
+        m_lineListsValid = true;
+    }
+}
+
+void KateWordIndex::build()
+{
+    m_sortedWords.clear();
+    m_words.clear();
+    m_lines.clear();
+    m_lines.resize(m_document->lines());
+    m_built = true;
+    m_dirtyLines.clear();
+    m_scanForDirtyLines = true;
+    m_lineListsValid = false;
+}
+
+void KateWordIndex::reindexLine(int line)
+{
+    Line &indexLine = m_lines[line];
+    const QString text = m_document->line(line);
+
+    std::vector<Word *> words;
+    forEachWord(text, [&](int start, int length) {
+        if (length >= minimalWordLength) {
+            words.push_back(addWord(QStringView(text).mid(start, length)));
+        }
+    });
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+
+    // added words count now, so none of the words still on the line is dropped below
+    for (Word *word : words) {
+        if (!std::binary_search(indexLine.words.begin(), indexLine.words.end(), word)) {
+            ++word->lineCount;
+            if (m_lineListsValid) {
+                word->lines.insert(std::lower_bound(word->lines.begin(), word->lines.end(), line), line);
+            }
+        }
+    }
+    for (Word *word : indexLine.words) {
+        if (!std::binary_search(words.begin(), words.end(), word)) {
+            if (m_lineListsValid) {
+                word->lines.erase(std::lower_bound(word->lines.begin(), word->lines.end(), line));
+            }
+            releaseWord(word);
+        }
+    }
+
+    indexLine.words = std::move(words);
+    indexLine.dirty = false;
+}
+
+void KateWordIndex::releaseWord(Word *word)
+{
+    if (--word->lineCount == 0) {
+        const QString text = *word->text;
+        m_sortedWords.erase(text);
+        m_words.erase(text);
+    }
+}
+
+KateWordIndex::Word *KateWordIndex::addWord(QStringView text)
+{
+    const QString key = text.toString();
+    auto it = m_words.find(key);
+    if (it == m_words.end()) {
+        it = m_words.emplace(key, Word()).first;
+        it->second.text = &it->first;
+        m_sortedWords.emplace(it->first, &it->second);
+    }
+    return &it->second;
+}
+
+void KateWordIndex::markDirty(int line)
+{
+    if (!m_lines[line].dirty) {
+        m_lines[line].dirty = true;
+        trackDirtyLine(line);
+    }
+}
+
+void KateWordIndex::trackDirtyLine(int line)
+{
+    if (m_scanForDirtyLines) {
+        return;
+    }
+
+    // the list is shifted on line insertions and removals, beyond some size a scan is cheaper
+    static constexpr size_t maxDirtyLines = 4096;
+    if (m_dirtyLines.size() == maxDirtyLines) {
+        m_dirtyLines.clear();
+        m_scanForDirtyLines = true;
+        return;
+    }
+    m_dirtyLines.push_back(line);
+}
+
+void KateWordIndex::textInserted(KTextEditor::Document *, KTextEditor::Range range)
+{
+    if (!m_built) {
+        return;
+    }
+
+    // the lines after the first one of the range are new
+    const int startLine = range.start().line();
+    const int insertedLines = range.end().line() - startLine;
+    if (startLine >= int(m_lines.size())) {
+        invalidate();
+        return;
+    }
+    if (insertedLines > 0) {
+        m_lines.insert(m_lines.begin() + startLine + 1, insertedLines, Line());
+        m_lineListsValid = false;
+        for (int &line : m_dirtyLines) {
+            if (line > startLine) {
+                line += insertedLines;
+            }
+        }
+        for (int line = startLine + 1; line <= startLine + insertedLines; ++line) {
+            trackDirtyLine(line);
+        }
+    }
+    markDirty(startLine);
+}
+
+void KateWordIndex::textRemoved(KTextEditor::Document *, KTextEditor::Range range)
+{
+    if (!m_built) {
+        return;
+    }
+
+    // the lines after the first one of the range are gone, the rest of the last one is now in the first
+    const int startLine = range.start().line();
+    const int removedLines = range.end().line() - startLine;
+    if (startLine + removedLines >= int(m_lines.size())) {
+        invalidate();
+        return;
+    }
+    if (removedLines > 0) {
+        for (int line = startLine + 1; line <= startLine + removedLines; ++line) {
+            for (Word *word : m_lines[line].words) {
+                releaseWord(word);
+            }
+        }
+        m_lines.erase(m_lines.begin() + startLine + 1, m_lines.begin() + startLine + removedLines + 1);
+        m_lineListsValid = false;
+
+        const auto removed = std::remove_if(m_dirtyLines.begin(), m_dirtyLines.end(), [&](int line) {
+            return line > startLine && line <= startLine + removedLines;
+        });
+        m_dirtyLines.erase(removed, m_dirtyLines.end());
+        for (int &line : m_dirtyLines) {
+            if (line > startLine) {
+                line -= removedLines;
+            }
+        }
+    }
+    markDirty(startLine);
+}
+
+void KateWordIndex::textReplayed(KTextEditor::Document *, KTextEditor::LineRange lineRange)
+{
+    if (!m_built) {
+        return;
+    }
+
+    for (int line = lineRange.start(); line <= std::min(lineRange.end(), int(m_lines.size()) - 1); ++line) {
+        markDirty(line);
+    }
+}
+
+void KateWordIndex::invalidate()
+{
+    // after a reload or clear the whole index is built again
+    m_sortedWords.clear();
+    m_words.clear();
+    m_lines.clear();
+    m_dirtyLines.clear();
+    m_built = false;
+}
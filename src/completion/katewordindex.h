@@ -0,0 +1,156 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KATE_WORDINDEX_H
+#define KATE_WORDINDEX_H
+
+#include <ktexteditor/range.h>
+
+#include <QObject>
+#include <QString>
+#include <QStringView>
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace KTextEditor
+{
+class Document;
+class DocumentPrivate;
+class LineRange;
+}
+
+/**
+ * Index of the words of a document for the word completion: each word with
+ * the sorted list of the lines it occurs in.
+ *
+ * The index is built on first use, from then on the edits of the document
+ * only mark the changed lines, they are read again on the next query.
+ * Lines inserted or removed shift the line lists, these are rebuilt from the
+ * words of the lines on the next query that needs them, without reading the
+ * document again.
+ */
+class KateWordIndex : public QObject
+{
+public:
+    explicit KateWordIndex(KTextEditor::DocumentPrivate *document);
+
+    /**
+     * Words shorter than this aren't indexed.
+     */
+    static constexpr int minimalWordLength = 2;
+
+    /**
+     * Call @p func with the start and the length of each word of @p text,
+     * the words the index consists of, runs of word characters.
+     */
+    template<typename Func>
+    static void forEachWord(QStringView text, Func func)
+    {
+        int wordBegin = -1;
+        for (int offset = 0; offset <= text.size(); ++offset) {
+            if (offset < text.size() && isWordCharacter(text[offset])) {
+                if (wordBegin < 0) {
+                    wordBegin = offset;
+                }
+            } else if (wordBegin >= 0) {
+                func(wordBegin, offset - wordBegin);
+                wordBegin = -1;
+            }
+        }
+    }
+
+    /**
+     * Is @p c a word character, as "\\w" matches them in Unicode regular expressions:
+     * letters, decimal digits, marks and connector punctuation like the underscore.
+     */
+    static bool isWordCharacter(QChar c)
+    {
+        if (c.isLetter()) {
+            return true;
+        }
+        switch (c.category()) {
+        case QChar::Number_DecimalDigit:
+        case QChar::Mark_NonSpacing:
+        case QChar::Mark_SpacingCombining:
+        case QChar::Mark_Enclosing:
+        case QChar::Punctuation_Connector:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * Call @p func with each indexed word and the number of lines it occurs in.
+     */
+    template<typename Func>
+    void forEachWord(Func func)
+    {
+        update(false);
+        for (const auto &word : m_sortedWords) {
+            func(*word.second->text, word.second->lineCount);
+        }
+    }
+
+    /**
+     * The nearest line after @p line (before for @p forward = false) that contains
+     * a word longer than @p prefix starting with @p prefix.
+     * @return the line or -1 if there is none
+     */
+    int nextLineWithPrefix(const QString &prefix, int line, bool forward);
+
+private:
+    struct Word {
+        const QString *text = nullptr;
+        // number of lines with the word, always up-to-date
+        int lineCount = 0;
+        // sorted lines with the word, only valid if m_lineListsValid
+        std::vector<int> lines;
+    };
+
+    struct Line {
+        // the words of the line, each once, sorted by address
+        std::vector<Word *> words;
+        // to be read again, new lines are
+        bool dirty = true;
+    };
+
+    /**
+     * Build the index or read the dirty lines again, with @p lineLists also
+     * bring the line lists of the words up-to-date.
+     */
+    void update(bool lineLists);
+    void build();
+    void reindexLine(int line);
+    void releaseWord(Word *word);
+    Word *addWord(QStringView text);
+    void markDirty(int line);
+    void trackDirtyLine(int line);
+
+    void textInserted(KTextEditor::Document *, KTextEditor::Range range);
+    void textRemoved(KTextEditor::Document *, KTextEditor::Range range);
+    void textReplayed(KTextEditor::Document *, KTextEditor::LineRange lineRange);
+    void invalidate();
+
+private:
+    KTextEditor::DocumentPrivate *const m_document;
+
+    std::unordered_map<QString, Word> m_words;
+    std::map<QStringView, Word *> m_sortedWords;
+    std::vector<Line> m_lines;
+
+    // the dirty lines in no particular order, unless m_scanForDirtyLines
+    std::vector<int> m_dirtyLines;
+    // too many dirty lines to track them, all lines are checked for the flag
+    bool m_scanForDirtyLines = false;
+
+    bool m_built = false;
+    bool m_lineListsValid = false;
+};
+
+#endif
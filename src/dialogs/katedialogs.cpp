@@ -341,6 +341,9 @@ void KateSpellCheckConfigTab::apply()
     KateDocumentConfig::global()->setOnTheFlySpellCheck(settings.value(QStringLiteral("checkerEnabledByDefault"), false).toBool());
     KateDocumentConfig::global()->configEnd();
 
+    // the words known to be misspelled or not may have changed with the language or word lists
+    KTextEditor::EditorPrivate::self()->spellCheckManager()->clearVerdicts();
+
     const auto docs = KTextEditor::EditorPrivate::self()->kateDocuments();
     for (KTextEditor::DocumentPrivate *doc : docs) {
         doc->refreshOnTheFlyCheck();
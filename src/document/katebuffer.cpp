@@ -237,6 +237,11 @@ bool KateBuffer::saveFile(const QString &m_file)
     return true;
 }
 
+bool KateBuffer::isHighlighted(int line) const
+{
+    return !m_highlight || m_highlight->noHighlighting() || line < m_lineHighlighted;
+}
+
 void KateBuffer::ensureHighlighted(int line, int lookAhead)
 {
     // valid line at all?
@@ -373,6 +378,9 @@ void KateBuffer::doHighlight(int startLine, int endLine, bool invalidate)
         }
     }
 
+    // the attributes of the lines changed, the bracket summaries of their blocks are outdated
+    invalidateBrackets(startLine, current_line - 1);
+
     // perhaps we need to adjust the maximal highlighted line
     int oldHighlighted = m_lineHighlighted;
     if (ctxChanged || current_line > m_lineHighlighted) {
@@ -182,6 +182,14 @@ public:
      */
     void ensureHighlighted(int line, int lookAhead = 64);
 
+    /**
+     * Is the highlighting of the given line @p line up-to-date?
+     * Always true without highlighting.
+     * @param line line to check
+     * @return true if @ref ensureHighlighted has nothing to do for @p line
+     */
+    bool isHighlighted(int line) const;
+
     /**
      * Return the total number of lines in the buffer.
      */
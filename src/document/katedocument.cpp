@@ -35,6 +35,7 @@
 #include "kateundomanager.h"
 #include "katevariableexpansionmanager.h"
 #include "kateview.h"
+#include "katewordindex.h"
 #include "printing/kateprinter.h"
 #include "spellcheck/ontheflycheck.h"
 #include "spellcheck/prefixstore.h"
@@ -74,12 +75,16 @@
 #include <QMap>
 #include <QMimeDatabase>
 #include <QProcess>
+#include <QPromise>
 #include <QRegularExpression>
 #include <QStandardPaths>
 #include <QTemporaryFile>
 #include <QTextStream>
+#include <QThreadPool>
 
+#include <algorithm>
 #include <cmath>
+#include <memory>
 
 // END  includes
 
@@ -218,6 +223,7 @@ KTextEditor::DocumentPrivate::DocumentPrivate(const KPluginMetaData &data, bool
     m_modOnHdTimer.setSingleShot(true);
     m_modOnHdTimer.setInterval(200);
     connect(&m_modOnHdTimer, &QTimer::timeout, this, &KTextEditor::DocumentPrivate::slotDelayedHandleModOnHd);
+    connect(&m_modOnHdVerification, &QFutureWatcherBase::finished, this, &KTextEditor::DocumentPrivate::slotModOnHdVerified);
 
     // Setup auto reload stuff
     m_autoReloadMode = new KToggleAction(i18n("Auto Reload Document"), this);
@@ -1346,7 +1352,7 @@ bool KTextEditor::DocumentPrivate::editRemoveText(int line, int col, int len)
     m_editLastChangeStartCursor = KTextEditor::Cursor(line, col);
 
     // remove text from line
-    m_buffer->removeText(KTextEditor::Range(m_editLastChangeStartCursor, KTextEditor::Cursor(line, col + len)));
+    m_buffer->removeText(KTextEditor::Range(m_editLastChangeStartCursor, KTextEditor::Cursor(line, col + len)), oldText);
 
     Q_EMIT textRemoved(this, KTextEditor::Range(line, col, line, col + len), oldText);
 
@@ -1355,6 +1361,159 @@ bool KTextEditor::DocumentPrivate::editRemoveText(int line, int col, int len)
     return true;
 }
 
+bool KTextEditor::DocumentPrivate::editInsertText(const std::vector<KTextEditor::Cursor> &positions, const QString &s)
+{
+    Q_ASSERT(std::is_sorted(positions.begin(), positions.end()));
+
+    if (!isReadWrite()) {
+        return false;
+    }
+
+    // nothing to do, do nothing!
+    if (positions.empty() || s.isEmpty()) {
+        return true;
+    }
+
+    editStart();
+
+    // line breaks can't be inserted into one line, from the back the positions stay valid
+    if (s.contains(QLatin1Char('\n'))) {
+        for (auto it = positions.rbegin(); it != positions.rend(); ++it) {
+            insertText(*it, s);
+        }
+        editEnd();
+        return true;
+    }
+
+    std::vector<KTextEditor::Cursor> positionsOfLine;
+    for (std::size_t i = 0; i < positions.size();) {
+        const int line = positions[i].line();
+        positionsOfLine.clear();
+        for (; i < positions.size() && positions[i].line() == line; ++i) {
+            if (positions[i].column() >= 0 && (positionsOfLine.empty() || positionsOfLine.back() != positions[i])) {
+                positionsOfLine.push_back(positions[i]);
+            }
+        }
+
+        const int length = lineLength(line);
+        if (line < 0 || length < 0 || positionsOfLine.empty()) {
+            continue;
+        }
+
+        // pad the line for positions behind its end, like editInsertText()
+        if (positionsOfLine.back().column() > length) {
+            editInsertText(line, length, QString(positionsOfLine.back().column() - length, QLatin1Char(' ')));
+        }
+
+        // the undo manager sees the insertions one after the other from the front, the first before the line changes
+        const int count = positionsOfLine.size();
+        m_undoManager->slotTextInserted(line, positionsOfLine.front().column(), s);
+        m_buffer->insertText(positionsOfLine, s);
+        for (int k = 1; k < count; ++k) {
+            m_undoManager->slotTextInserted(line, positionsOfLine[k].column() + k * s.size(), s);
+        }
+
+        // remember last change cursor
+        m_editLastChangeStartCursor = KTextEditor::Cursor(line, positionsOfLine.back().column() + (count - 1) * s.size());
+
+        for (int k = 0; k < count; ++k) {
+            const int column = positionsOfLine[k].column() + k * s.size();
+            Q_EMIT textInsertedRange(this, KTextEditor::Range(line, column, line, column + s.size()));
+        }
+    }
+
+    editEnd();
+
+    return true;
+}
+
+bool KTextEditor::DocumentPrivate::editRemoveText(const std::vector<KTextEditor::Range> &ranges)
+{
+    Q_ASSERT(std::is_sorted(ranges.begin(), ranges.end(), [](const KTextEditor::Range &l, const KTextEditor::Range &r) {
+        return l.start() < r.start();
+    }));
+
+    if (!isReadWrite()) {
+        return false;
+    }
+
+    // nothing to do, do nothing!
+    if (ranges.empty()) {
+        return true;
+    }
+
+    editStart();
+
+    std::vector<KTextEditor::Range> rangesOfLine;
+    for (std::size_t i = 0; i < ranges.size();) {
+        const int line = ranges[i].start().line();
+        const Kate::TextLine l = plainKateTextLine(line);
+
+        // don't try to remove what's not there
+        rangesOfLine.clear();
+        for (; i < ranges.size() && ranges[i].start().line() == line; ++i) {
+            Q_ASSERT(ranges[i].onSingleLine());
+            if (!l) {
+                continue;
+            }
+            const KTextEditor::Range range(line, qMax(0, ranges[i].start().column()), line, qMin(ranges[i].end().column(), l->length()));
+            if (range.isEmpty() || (!rangesOfLine.empty() && range.start() < rangesOfLine.back().end())) {
+                continue;
+            }
+            rangesOfLine.push_back(range);
+        }
+        if (rangesOfLine.empty()) {
+            continue;
+        }
+
+        // the undo manager sees the removals one after the other from the back, the first before the line changes
+        const QString oldText = l->text();
+        const auto removedText = [&oldText](KTextEditor::Range range) {
+            return oldText.mid(range.start().column(), range.columnWidth());
+        };
+        m_undoManager->slotTextRemoved(line, rangesOfLine.back().start().column(), removedText(rangesOfLine.back()));
+        m_buffer->removeText(rangesOfLine);
+        for (std::size_t k = rangesOfLine.size() - 1; k-- > 0;) {
+            m_undoManager->slotTextRemoved(line, rangesOfLine[k].start().column(), removedText(rangesOfLine[k]));
+        }
+
+        // remember last change cursor
+        m_editLastChangeStartCursor = rangesOfLine.front().start();
+
+        for (std::size_t k = rangesOfLine.size(); k-- > 0;) {
+            Q_EMIT textRemoved(this, rangesOfLine[k], removedText(rangesOfLine[k]));
+        }
+    }
+
+    editEnd();
+
+    return true;
+}
+
+void KTextEditor::DocumentPrivate::replayInsertText(int line, int col, const QString &s)
+{
+    // verbose debug
+    EDIT_DEBUG << "replayInsertText" << line << col << s;
+
+    Q_ASSERT(editSessionNumber > 0);
+    Q_ASSERT(col >= 0 && col <= lineLength(line));
+
+    m_editLastChangeStartCursor = KTextEditor::Cursor(line, col);
+    m_buffer->insertText(m_editLastChangeStartCursor, s);
+}
+
+void KTextEditor::DocumentPrivate::replayRemoveText(int line, int col, const QString &oldText)
+{
+    // verbose debug
+    EDIT_DEBUG << "replayRemoveText" << line << col << oldText;
+
+    Q_ASSERT(editSessionNumber > 0);
+    Q_ASSERT(col >= 0 && col + oldText.size() <= lineLength(line));
+
+    m_editLastChangeStartCursor = KTextEditor::Cursor(line, col);
+    m_buffer->removeText(KTextEditor::Range(m_editLastChangeStartCursor, KTextEditor::Cursor(line, col + oldText.size())), oldText);
+}
+
 bool KTextEditor::DocumentPrivate::editMarkLineAutoWrapped(int line, bool autowrapped)
 {
     // verbose debug
@@ -2574,8 +2733,10 @@ bool KTextEditor::DocumentPrivate::saveFile()
         return false;
     }
 
-    // update the checksum
-    createDigest();
+    // update the checksum, unless the buffer already computed it while saving
+    if (checksum().isEmpty()) {
+        createDigest();
+    }
 
     // add m_file again to dirwatch
     activateDirWatch();
@@ -3096,7 +3257,7 @@ void KTextEditor::DocumentPrivate::typeChars(KTextEditor::ViewPrivate *view, QSt
         const QChar openBracket = matchingStartBracket(typedChar);
         if (!openBracket.isNull()) {
             KTextEditor::Cursor curPos = view->cursorPosition();
-            if ((characterAt(curPos) == typedChar) && findMatchingBracket(curPos, 123 /*Which value may best?*/).isValid()) {
+            if ((characterAt(curPos) == typedChar) && findMatchingBracket(curPos, -1, InteractiveBracketHighlightLimit).isValid()) {
                 // Do nothing
                 view->cursorRight();
                 return;
@@ -3237,13 +3398,23 @@ void KTextEditor::DocumentPrivate::typeChars(KTextEditor::ViewPrivate *view, QSt
         const auto &sc = view->secondaryCursors();
         const bool hasClosingBracket = !closingBracket.isNull();
         const QString closingChar = closingBracket;
-        for (const auto &c : sc) {
-            insertText(c.cursor(), chars);
-            const auto pos = c.cursor();
-            const auto nextChar = view->document()->text({pos, pos + Cursor{0, 1}}).trimmed();
-            if (hasClosingBracket && !skipAutoBrace(closingBracket, pos) && (nextChar.isEmpty() || !nextChar.at(0).isLetterOrNumber())) {
-                insertText(c.cursor(), closingChar);
-                c.pos->setPosition(pos);
+        if (!hasClosingBracket) {
+            // the same text at all cursors, each line is changed once
+            std::vector<KTextEditor::Cursor> positions;
+            positions.reserve(sc.size());
+            for (const auto &c : sc) {
+                positions.push_back(c.cursor());
+            }
+            editInsertText(positions, chars);
+        } else {
+            for (const auto &c : sc) {
+                insertText(c.cursor(), chars);
+                const auto pos = c.cursor();
+                const auto nextChar = view->document()->text({pos, pos + Cursor{0, 1}}).trimmed();
+                if (!skipAutoBrace(closingBracket, pos) && (nextChar.isEmpty() || !nextChar.at(0).isLetterOrNumber())) {
+                    insertText(c.cursor(), closingChar);
+                    c.pos->setPosition(pos);
+                }
             }
         }
         view->completionWidget()->setIgnoreBufferSignals(false);
@@ -3514,6 +3685,45 @@ KTextEditor::Cursor KTextEditor::DocumentPrivate::backspaceAtCursor(KTextEditor:
     }
 }
 
+std::vector<KTextEditor::Range> KTextEditor::DocumentPrivate::backspaceRanges(KTextEditor::ViewPrivate *view) const
+{
+    // composed characters need the layout of each line
+    std::vector<KTextEditor::Range> ranges;
+    if (view->config()->backspaceRemoveComposed()) {
+        return ranges;
+    }
+
+    // only if backspaceAtCursor() would just remove the character in front of each secondary cursor
+    const auto &secondaryCursors = view->secondaryCursors();
+    ranges.reserve(secondaryCursors.size());
+    for (const auto &c : secondaryCursors) {
+        const KTextEditor::Cursor pos = c.cursor();
+        const Kate::TextLine textLine = m_buffer->plainLine(pos.line());
+        if (!textLine || pos.column() <= 0 || pos.column() > textLine->length()) {
+            return {};
+        }
+
+        // backspace indents with only spaces in front of the cursor
+        if (config()->backspaceIndents()) {
+            const int firstChar = textLine->firstChar();
+            if (firstChar < 0 || firstChar >= pos.column()) {
+                return {};
+            }
+        }
+
+        // move to left of surrogate pair
+        KTextEditor::Cursor begin(pos.line(), pos.column() - 1);
+        if (!isValidTextPosition(begin)) {
+            begin.setColumn(pos.column() - 2);
+        }
+        if (!ranges.empty() && begin < ranges.back().end()) {
+            return {};
+        }
+        ranges.emplace_back(begin, pos);
+    }
+    return ranges;
+}
+
 void KTextEditor::DocumentPrivate::backspace(KTextEditor::ViewPrivate *view)
 {
     if (!view->config()->persistentSelection() && view->hasSelections()) {
@@ -3536,10 +3746,16 @@ void KTextEditor::DocumentPrivate::backspace(KTextEditor::ViewPrivate *view)
     // Handle multi cursors
     const auto &multiCursors = view->secondaryCursors();
     view->completionWidget()->setIgnoreBufferSignals(true);
-    for (const auto &c : multiCursors) {
-        const auto newPos = backspaceAtCursor(view, c.cursor());
-        if (newPos.isValid()) {
-            c.pos->setPosition(newPos);
+    const std::vector<KTextEditor::Range> ranges = backspaceRanges(view);
+    if (!ranges.empty()) {
+        // the same removal at all cursors, each line is changed once, the cursors move to the start of their range
+        editRemoveText(ranges);
+    } else {
+        for (const auto &c : multiCursors) {
+            const auto newPos = backspaceAtCursor(view, c.cursor());
+            if (newPos.isValid()) {
+                c.pos->setPosition(newPos);
+            }
         }
     }
     view->completionWidget()->setIgnoreBufferSignals(false);
@@ -4510,12 +4726,8 @@ void KTextEditor::DocumentPrivate::repaintViews(bool paintOnlyDirty)
    match it. Otherwise if the character to the right of the cursor is a
    bracket, match it. Otherwise, don't match anything.
 */
-KTextEditor::Range KTextEditor::DocumentPrivate::findMatchingBracket(const KTextEditor::Cursor start, int maxLines)
+KTextEditor::Range KTextEditor::DocumentPrivate::findMatchingBracket(const KTextEditor::Cursor start, int maxLines, int highlightLimit)
 {
-    if (maxLines < 0) {
-        return KTextEditor::Range::invalid();
-    }
-
     Kate::TextLine textLine = m_buffer->plainLine(start.line());
     if (!textLine) {
         return KTextEditor::Range::invalid();
@@ -4546,43 +4758,40 @@ KTextEditor::Range KTextEditor::DocumentPrivate::findMatchingBracket(const KText
         return KTextEditor::Range::invalid();
     }
 
-    const int searchDir = isStartBracket(bracket) ? 1 : -1;
-    uint nesting = 0;
-
-    const int minLine = qMax(range.start().line() - maxLines, 0);
-    const int maxLine = qMin(range.start().line() + maxLines, documentEnd().line());
+    const bool forward = isStartBracket(bracket);
+    const int minLine = (maxLines < 0) ? 0 : qMax(range.start().line() - maxLines, 0);
+    const int maxLine = (maxLines < 0) ? lastLine() : qMin(range.start().line() + maxLines, lastLine());
 
-    range.setEnd(range.start());
-    KTextEditor::DocumentCursor cursor(this);
-    cursor.setPosition(range.start());
-    int validAttr = kateTextLine(cursor.line())->attribute(cursor.column());
-
-    while (cursor.line() >= minLine && cursor.line() <= maxLine) {
-        if (!cursor.move(searchDir)) {
-            return KTextEditor::Range::invalid();
-        }
+    // only brackets with the same attribute match, e.g. none in strings or comments for one in code
+    const short validAttr = kateTextLine(range.start().line())->attribute(range.start().column());
 
-        Kate::TextLine textLine = kateTextLine(cursor.line());
-        if (textLine->attribute(cursor.column()) == validAttr) {
-            // Check for match
-            QChar c = textLine->at(cursor.column());
-            if (c == opposite) {
-                if (nesting == 0) {
-                    if (searchDir > 0) { // forward
-                        range.setEnd(cursor.toCursor());
-                    } else {
-                        range.setStart(cursor.toCursor());
-                    }
-                    return range;
-                }
-                nesting--;
-            } else if (c == bracket) {
-                nesting++;
+    // first line the search may not highlight, known once it reaches lines not highlighted yet
+    int highlightEnd = -1;
+    const auto prepareLines = [this, highlightLimit, &highlightEnd](int line) {
+        if (highlightLimit >= 0 && !m_buffer->isHighlighted(line)) {
+            if (highlightEnd < 0) {
+                highlightEnd = line + highlightLimit;
+            }
+            if (line >= highlightEnd) {
+                return false;
             }
         }
+        m_buffer->ensureHighlighted(line);
+        return true;
+    };
+
+    const KTextEditor::Cursor match = m_buffer->findMatchingBracket(range.start(), bracket, opposite, forward, validAttr, minLine, maxLine, prepareLines);
+    if (!match.isValid()) {
+        return KTextEditor::Range::invalid();
     }
 
-    return KTextEditor::Range::invalid();
+    if (forward) {
+        range.setEnd(match);
+    } else {
+        range.setEnd(range.start());
+        range.setStart(match);
+    }
+    return range;
 }
 
 // helper: remove \r and \n from visible document name (bug #170876)
@@ -4800,12 +5009,8 @@ void KTextEditor::DocumentPrivate::onModOnHdReload()
 
 void KTextEditor::DocumentPrivate::autoReloadToggled(bool b)
 {
+    // the verdict about changes on disk triggers the reload, see slotModOnHdVerified()
     m_autoReloadMode->setChecked(b);
-    if (b) {
-        connect(&m_modOnHdTimer, &QTimer::timeout, this, &DocumentPrivate::onModOnHdAutoReload);
-    } else {
-        disconnect(&m_modOnHdTimer, &QTimer::timeout, this, &DocumentPrivate::onModOnHdAutoReload);
-    }
 }
 
 bool KTextEditor::DocumentPrivate::isAutoReload()
@@ -5083,6 +5288,7 @@ void KTextEditor::DocumentPrivate::updateConfig()
 
     // set tab width there, too
     m_buffer->setTabWidth(config()->tabWidth());
+    m_buffer->setSearchIndexEnabled(config()->searchIndex());
 
     // update all views, does tagAll and updateView...
     for (auto view : std::as_const(m_views)) {
@@ -5520,49 +5726,144 @@ void KTextEditor::DocumentPrivate::slotModOnHdDeleted(const QString &path)
     }
 }
 
+namespace
+{
+/**
+ * Git compatible sha1 checksum of the file, empty if it can't be read.
+ */
+QByteArray gitBlobDigest(const QString &path)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+
+    // init the hash with the git header
+    QCryptographicHash crypto(QCryptographicHash::Sha1);
+    const QString header = QStringLiteral("blob %1").arg(f.size());
+    crypto.addData(QByteArray(header.toLatin1() + '\0'));
+
+    while (!f.atEnd()) {
+        crypto.addData(f.read(256 * 1024));
+    }
+
+    return crypto.result();
+}
+
+/**
+ * Threads for the modified on disk checks. They mostly wait for the disk and git,
+ * a few of them are enough to not block each other on e.g. a git checkout.
+ */
+QThreadPool *modOnHdThreadPool()
+{
+    static QThreadPool *pool = [] {
+        auto threadPool = new QThreadPool(QCoreApplication::instance());
+        threadPool->setMaxThreadCount(4);
+        return threadPool;
+    }();
+    return pool;
+}
+}
+
 void KTextEditor::DocumentPrivate::slotDelayedHandleModOnHd()
 {
     // compare git hash with the one we have (if we have one)
     const QByteArray oldDigest = checksum();
-    if (!oldDigest.isEmpty() && !url().isEmpty() && url().isLocalFile()) {
+    if (oldDigest.isEmpty() || url().isEmpty() || !url().isLocalFile()) {
+        // emit our signal to the outside!
+        Q_EMIT modifiedOnDisk(this, m_modOnHd, m_modOnHdReason);
+        if (isAutoReload()) {
+            onModOnHdAutoReload();
+        }
+        return;
+    }
+
+    // a burst of changes, check again once the running check is done
+    if (m_modOnHdVerification.isRunning()) {
+        m_modOnHdVerificationPending = true;
+        return;
+    }
+    m_modOnHdVerificationPending = false;
+
+    // reading the file and asking git may take long, do that in a worker thread
+    // we only want to use git from PATH, cache this
+    static const QString fullGitPath = QStandardPaths::findExecutable(QStringLiteral("git"));
+    const QString path = url().toLocalFile();
+    const QString workingDirectory = url().adjusted(QUrl::RemoveFilename).toLocalFile();
+    const bool compareDigest = m_modOnHdReason != OnDiskDeleted && m_modOnHdReason != OnDiskCreated;
+    // skip git, if document is modified! we have a config option to disable this
+    const QString gitPath =
+        (!isModified() && config()->value(KateDocumentConfig::AutoReloadIfStateIsInVersionControl).toBool()) ? fullGitPath : QString();
+
+    auto promise = std::make_shared<QPromise<ModOnHdVerdict>>();
+    m_modOnHdVerification.setFuture(promise->future());
+    promise->start();
+    modOnHdThreadPool()->start([promise, path, workingDirectory, oldDigest, compareDigest, gitPath]() {
+        ModOnHdVerdict verdict;
+        verdict.path = path;
+        verdict.oldDigest = oldDigest;
+
         // if current checksum == checksum of new file => unmodified
-        if (m_modOnHdReason != OnDiskDeleted && m_modOnHdReason != OnDiskCreated && createDigest() && oldDigest == checksum()) {
-            m_modOnHd = false;
-            m_modOnHdReason = OnDiskUnmodified;
-            m_prevModOnHdReason = OnDiskUnmodified;
+        if (compareDigest) {
+            verdict.digest = gitBlobDigest(path);
+            verdict.unmodified = !verdict.digest.isEmpty() && verdict.digest == oldDigest;
         }
 
         // if still modified, try to take a look at git
-        // skip that, if document is modified!
         // only do that, if the file is still there, else reload makes no sense!
-        // we have a config option to disable this
-        if (m_modOnHd && !isModified() && QFile::exists(url().toLocalFile())
-            && config()->value(KateDocumentConfig::AutoReloadIfStateIsInVersionControl).toBool()) {
-            // we only want to use git from PATH, cache this
-            static const QString fullGitPath = QStandardPaths::findExecutable(QStringLiteral("git"));
-            if (!fullGitPath.isEmpty()) {
-                QProcess git;
-                const QStringList args{QStringLiteral("cat-file"), QStringLiteral("-e"), QString::fromUtf8(oldDigest.toHex())};
-                git.setWorkingDirectory(url().adjusted(QUrl::RemoveFilename).toLocalFile());
-                git.start(fullGitPath, args);
-                if (git.waitForStarted()) {
-                    git.closeWriteChannel();
-                    if (git.waitForFinished()) {
-                        if (git.exitCode() == 0) {
-                            // this hash exists still in git => just reload
-                            m_modOnHd = false;
-                            m_modOnHdReason = OnDiskUnmodified;
-                            m_prevModOnHdReason = OnDiskUnmodified;
-                            documentReload();
-                        }
-                    }
+        if (!verdict.unmodified && !gitPath.isEmpty() && QFile::exists(path)) {
+            QProcess git;
+            const QStringList args{QStringLiteral("cat-file"), QStringLiteral("-e"), QString::fromUtf8(oldDigest.toHex())};
+            git.setWorkingDirectory(workingDirectory);
+            git.start(gitPath, args);
+            if (git.waitForStarted()) {
+                git.closeWriteChannel();
+                if (git.waitForFinished()) {
+                    // this hash exists still in git => just reload
+                    verdict.inVersionControl = git.exitCode() == 0;
                 }
             }
         }
+
+        promise->addResult(verdict);
+        promise->finish();
+    });
+}
+
+void KTextEditor::DocumentPrivate::slotModOnHdVerified()
+{
+    // the file changed again while we checked, our result is outdated
+    if (m_modOnHdVerificationPending) {
+        slotDelayedHandleModOnHd();
+        return;
+    }
+
+    // the document got saved, reloaded or switched to another file meanwhile
+    const ModOnHdVerdict verdict = m_modOnHdVerification.result();
+    if (!m_modOnHd || verdict.path != url().toLocalFile() || verdict.oldDigest != checksum()) {
+        return;
+    }
+
+    if (!verdict.digest.isEmpty()) {
+        m_buffer->setDigest(verdict.digest);
+    }
+
+    if (verdict.unmodified) {
+        m_modOnHd = false;
+        m_modOnHdReason = OnDiskUnmodified;
+        m_prevModOnHdReason = OnDiskUnmodified;
+    } else if (verdict.inVersionControl && !isModified()) {
+        m_modOnHd = false;
+        m_modOnHdReason = OnDiskUnmodified;
+        m_prevModOnHdReason = OnDiskUnmodified;
+        documentReload();
     }
 
     // emit our signal to the outside!
     Q_EMIT modifiedOnDisk(this, m_modOnHd, m_modOnHdReason);
+    if (isAutoReload()) {
+        onModOnHdAutoReload();
+    }
 }
 
 QByteArray KTextEditor::DocumentPrivate::checksum() const
@@ -5575,19 +5876,7 @@ bool KTextEditor::DocumentPrivate::createDigest()
     QByteArray digest;
 
     if (url().isLocalFile()) {
-        QFile f(url().toLocalFile());
-        if (f.open(QIODevice::ReadOnly)) {
-            // init the hash with the git header
-            QCryptographicHash crypto(QCryptographicHash::Sha1);
-            const QString header = QStringLiteral("blob %1").arg(f.size());
-            crypto.addData(QByteArray(header.toLatin1() + '\0'));
-
-            while (!f.atEnd()) {
-                crypto.addData(f.read(256 * 1024));
-            }
-
-            digest = crypto.result();
-        }
+        digest = gitBlobDigest(url().toLocalFile());
     }
 
     // set new digest
@@ -5837,6 +6126,11 @@ Kate::TextLine KTextEditor::DocumentPrivate::plainKateTextLine(int i)
     return m_buffer->plainLine(i);
 }
 
+int KTextEditor::DocumentPrivate::searchCandidateLine(int line, int lastLine, const std::vector<uint> &trigrams) const
+{
+    return m_buffer->searchCandidateLine(line, lastLine, trigrams);
+}
+
 bool KTextEditor::DocumentPrivate::isEditRunning() const
 {
     return editIsRunning;
@@ -6536,6 +6830,14 @@ void KTextEditor::DocumentPrivate::setActiveTemplateHandler(KateTemplateHandler
     m_activeTemplateHandler = handler;
 }
 
+KateWordIndex *KTextEditor::DocumentPrivate::wordIndex()
+{
+    if (!m_wordIndex) {
+        m_wordIndex = std::make_unique<KateWordIndex>(this);
+    }
+    return m_wordIndex.get();
+}
+
 // BEGIN KTextEditor::MessageInterface
 bool KTextEditor::DocumentPrivate::postMessage(KTextEditor::Message *message)
 {
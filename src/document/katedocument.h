@@ -10,6 +10,7 @@
 #ifndef _KATE_DOCUMENT_H_
 #define _KATE_DOCUMENT_H_
 
+#include <QFutureWatcher>
 #include <QPointer>
 #include <QStack>
 #include <QTimer>
@@ -55,6 +56,7 @@ class KateDocumentConfig;
 class KateHighlighting;
 class KateUndoManager;
 class KateOnTheFlyChecker;
+class KateWordIndex;
 class KateDocumentTest;
 
 class KateAutoIndent;
@@ -220,6 +222,16 @@ Q_SIGNALS:
      */
     void textRemoved(KTextEditor::Document *document, KTextEditor::Range range, const QString &oldText);
 
+    /**
+     * The \p document emits this signal instead of textInsertedRange() and
+     * textRemoved() after an undo or redo replayed a large group of edits
+     * with replayInsertText() and replayRemoveText().
+     * The text of the lines in \p lineRange changed, the line count didn't.
+     * \param document document which emitted this signal
+     * \param lineRange the lines that have been changed
+     */
+    void textReplayed(KTextEditor::Document *document, KTextEditor::LineRange lineRange);
+
 public:
     // BEGIN editStart/editEnd (start, end, undo, cursor update, view update)
     /**
@@ -278,6 +290,38 @@ public:
      */
     bool editRemoveText(int line, int col, int len);
 
+    /**
+     * Insert @p s at all @p positions, e.g. the text typed with many cursors.
+     * The insertions into one line change it only once, text with line breaks
+     * is inserted at each position.
+     * @param positions sorted positions
+     * @param s string to be inserted
+     * @return true on success
+     */
+    bool editInsertText(const std::vector<KTextEditor::Cursor> &positions, const QString &s);
+
+    /**
+     * Remove all @p ranges, e.g. the characters erased with many cursors.
+     * The removals from one line change it only once.
+     * @param ranges sorted ranges, each on one line, not overlapping
+     * @return true on success
+     */
+    bool editRemoveText(const std::vector<KTextEditor::Range> &ranges);
+
+    /**
+     * Replay variants of editInsertText() and editRemoveText() for the undo
+     * manager, only valid inside a running editing transaction.
+     * The edit must be valid, it is neither checked nor recorded for undo and
+     * only the buffer signals are emitted, the caller emits textReplayed() once
+     * for all replayed edits.
+     * @param line line number
+     * @param col column
+     * @param s string to be inserted
+     * @param oldText the text to be removed, must match the text at @p col
+     */
+    void replayInsertText(int line, int col, const QString &s);
+    void replayRemoveText(int line, int col, const QString &oldText);
+
     /**
      * Mark @p line as @p autowrapped. This is necessary if static word warp is
      * enabled, because we have to know whether to insert a new line or add the
@@ -882,6 +926,9 @@ private:
     // Helper function for use with multiple cursors
     KTEXTEDITOR_NO_EXPORT
     KTextEditor::Cursor backspaceAtCursor(KTextEditor::ViewPrivate *v, KTextEditor::Cursor c);
+    // The characters in front of the secondary cursors, if backspace just removes them, else empty
+    KTEXTEDITOR_NO_EXPORT
+    std::vector<KTextEditor::Range> backspaceRanges(KTextEditor::ViewPrivate *view) const;
     void commentSelection(KTextEditor::Range selection, KTextEditor::Cursor c, bool blockSelect, CommentType changeType);
     // exported for katedocument_test
     KTEXTEDITOR_NO_EXPORT
@@ -1004,7 +1051,20 @@ private:
     bool removeStartLineCommentFromSelection(KTextEditor::Range, int attrib, bool toggleComment);
 
 public:
-    KTextEditor::Range findMatchingBracket(const KTextEditor::Cursor start, int maxLines);
+    /**
+     * Find the bracket matching the one at or before @p start.
+     * @param start cursor position
+     * @param maxLines maximal number of lines to search above or below, -1 for the whole document
+     * @param highlightLimit maximal number of not yet highlighted lines the search may highlight, -1 for no limit
+     * @return range from the bracket to its match, invalid if there is none or it lies beyond @p highlightLimit
+     */
+    KTextEditor::Range findMatchingBracket(const KTextEditor::Cursor start, int maxLines = -1, int highlightLimit = -1);
+
+    /**
+     * Highlighting limit for bracket matches done while typing or painting,
+     * keeps them interactive in huge documents that aren't highlighted yet.
+     */
+    static constexpr int InteractiveBracketHighlightLimit = 5000;
 
 public:
     QString documentName() const override
@@ -1102,6 +1162,9 @@ public:
     //! @copydoc KateBuffer::plainLine()
     Kate::TextLine plainKateTextLine(int i);
 
+    //! @copydoc Kate::TextBuffer::searchCandidateLine()
+    int searchCandidateLine(int line, int lastLine, const std::vector<uint> &trigrams) const;
+
 Q_SIGNALS:
     void aboutToRemoveText(KTextEditor::Range);
 
@@ -1110,6 +1173,7 @@ private Q_SLOTS:
     void slotModOnHdCreated(const QString &path);
     void slotModOnHdDeleted(const QString &path);
     void slotDelayedHandleModOnHd();
+    void slotModOnHdVerified();
 
 private:
     /**
@@ -1205,6 +1269,19 @@ private:
     ModifiedOnDiskReason m_modOnHdReason = OnDiskUnmodified;
     ModifiedOnDiskReason m_prevModOnHdReason = OnDiskUnmodified;
 
+    /**
+     * Result of the check whether a change on disk is a real one, computed by a worker thread.
+     */
+    struct ModOnHdVerdict {
+        QString path; //!< the checked file
+        QByteArray oldDigest; //!< digest of the document when the check started
+        QByteArray digest; //!< digest of the file on disk, empty if not computed
+        bool unmodified = false; //!< the file content is the one we have
+        bool inVersionControl = false; //!< the old content is known to git, safe to reload
+    };
+    QFutureWatcher<ModOnHdVerdict> m_modOnHdVerification;
+    bool m_modOnHdVerificationPending = false; //!< more changes arrived while verifying
+
     QString m_docName;
     int m_docNameNumber = 0;
 
@@ -1524,6 +1601,12 @@ private Q_SLOTS:
 public:
     void setActiveTemplateHandler(KateTemplateHandler *handler);
 
+    /**
+     * Index of the words of this document for the word completion,
+     * created on first use and kept up-to-date from then on.
+     */
+    KateWordIndex *wordIndex();
+
 Q_SIGNALS:
     void loaded(KTextEditor::DocumentPrivate *document);
 
@@ -1533,6 +1616,8 @@ private:
     QList<KTextEditor::View *> m_viewsCache;
 
     QTimer m_autoSaveTimer;
+
+    std::unique_ptr<KateWordIndex> m_wordIndex;
 };
 
 #endif
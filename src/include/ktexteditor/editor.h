@@ -8,8 +8,10 @@
 #ifndef KTEXTEDITOR_EDITOR_H
 #define KTEXTEDITOR_EDITOR_H
 
+#include <ktexteditor/document.h>
 #include <ktexteditor_export.h>
 
+#include <QFuture>
 #include <QObject>
 #include <QVector>
 
@@ -276,6 +278,64 @@ Q_SIGNALS:
      */
     void repositoryReloaded(KTextEditor::Editor *editor);
 
+public:
+    /**
+     * Result of replaceInDocuments() for one document or file.
+     *
+     * \since 6.0
+     */
+    struct ReplaceResult {
+        /**
+         * The document the text was replaced in, nullptr for a file that was not open.
+         */
+        KTextEditor::Document *document = nullptr;
+
+        /**
+         * Local path of the file, empty for a document without local file.
+         */
+        QString filePath;
+
+        /**
+         * Number of replaced matches.
+         */
+        int replacements = 0;
+
+        /**
+         * Why the file could not be processed, empty on success.
+         */
+        QString errorString;
+    };
+
+    /**
+     * Replace all matches of \p pattern with \p replacement in \p documents and in the
+     * local files \p filePaths, like a replace all in the search bar does.
+     * Supported \p options are KTextEditor::CaseInsensitive, KTextEditor::WholeWords,
+     * KTextEditor::EscapeSequences and KTextEditor::Regex.
+     *
+     * The documents and the files that are open in a document are changed before
+     * this function returns, each in one undo step, and are not saved.
+     * All other files are loaded, changed and saved in a thread pool. Their encoding,
+     * end of line mode and byte order mark are kept, matches in them can't span lines.
+     *
+     * The returned future reports one ReplaceResult per document or file once it is
+     * done, in no particular order. Its progress is the number of processed documents
+     * and files. Canceling it skips the files not processed yet.
+     *
+     * \param documents documents to replace in
+     * \param filePaths local files to replace in
+     * \param pattern text or regular expression to search for
+     * \param replacement replacement, may use references to captures for regular expressions
+     * \param options search options
+     * \return future for the results
+     *
+     * \since 6.0
+     */
+    QFuture<ReplaceResult> replaceInDocuments(const QList<KTextEditor::Document *> &documents,
+                                              const QStringList &filePaths,
+                                              const QString &pattern,
+                                              const QString &replacement,
+                                              KTextEditor::SearchOptions options = KTextEditor::Default);
+
 public:
     /**
      * Query for the command \p cmd.
@@ -378,7 +378,7 @@ static KTextEditor::Range cursorAtBracket(KTextEditor::ViewPrivate *view, const
 
     // We have a bracket
     if (found) {
-        ret = doc->findMatchingBracket(c, 150);
+        ret = doc->findMatchingBracket(c, -1, KTextEditor::DocumentPrivate::InteractiveBracketHighlightLimit);
         if (!ret.isValid()) {
             openX = closeX = -1;
             return ret;
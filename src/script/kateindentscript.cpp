@@ -48,8 +48,13 @@ QPair<int, int> KateIndentScript::indent(KTextEditor::ViewPrivate *view, const K
     }
 
     clearExceptions();
-    QJSValue indentFunction = function(QStringLiteral("indent"));
-    if (!indentFunction.isCallable()) {
+
+    // lookup the indent function only once, this is called for each keystroke
+    if (!m_indentFunctionSet) {
+        m_indentFunctionSet = true;
+        m_indentFunction = function(QStringLiteral("indent"));
+    }
+    if (!m_indentFunction.isCallable()) {
         return qMakePair(-2, -2);
     }
     // add the arguments that we are going to pass to the function
@@ -58,7 +63,7 @@ QPair<int, int> KateIndentScript::indent(KTextEditor::ViewPrivate *view, const K
     arguments << QJSValue(indentWidth);
     arguments << (typedCharacter.isNull() ? QJSValue(QString()) : QJSValue(QString(typedCharacter)));
     // get the required indent
-    QJSValue result = indentFunction.call(arguments);
+    QJSValue result = m_indentFunction.call(arguments);
     // error during the calling?
     if (result.isError()) {
         displayBacktrace(result, QStringLiteral("Error calling indent()"));
@@ -116,6 +116,8 @@ public:
 private:
     QString m_triggerCharacters;
     bool m_triggerCharactersSet = false;
+    QJSValue m_indentFunction;
+    bool m_indentFunctionSet = false;
     KateIndentScriptHeader m_indentHeader;
 };
 
@@ -192,7 +192,12 @@ private:
     QString m_errorMessage;
 
 protected:
-    /** The Qt interpreter for this script */
+    /**
+     * The Qt interpreter for this script.
+     * TODO: share one engine between scripts. QJSEngine has one global object, and scripts and the
+     * libraries they require() communicate via globals, e.g. utils.js reads the debugMode of the
+     * indenter. Sharing needs a global object per script, which QJSEngine doesn't offer yet.
+     */
     QJSEngine *m_engine = nullptr;
 
 private:
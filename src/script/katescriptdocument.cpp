@@ -20,6 +20,10 @@
 #include <QJSEngine>
 #include <ktexteditor/documentcursor.h>
 
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
 KateScriptDocument::KateScriptDocument(QJSEngine *engine, QObject *parent)
     : QObject(parent)
     , m_document(nullptr)
@@ -621,6 +625,113 @@ int KateScriptDocument::lineLength(int line)
     return m_document->lineLength(line);
 }
 
+QStringList KateScriptDocument::textLines(int startLine, int endLine)
+{
+    startLine = qMax(0, startLine);
+    endLine = qMin(endLine, m_document->lines() - 1);
+
+    QStringList lines;
+    lines.reserve(qMax(0, endLine - startLine + 1));
+    for (int line = startLine; line <= endLine; ++line) {
+        lines.append(m_document->line(line));
+    }
+    return lines;
+}
+
+/**
+ * Wrap the values into a script Int32Array, without a round trip per element.
+ */
+static QJSValue toInt32Array(QJSEngine *engine, const std::vector<qint32> &values)
+{
+    const QByteArray buffer(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(qint32));
+    return engine->globalObject().property(QStringLiteral("Int32Array")).callAsConstructor({engine->toScriptValue(buffer)});
+}
+
+QJSValue KateScriptDocument::lineLengths(int startLine, int endLine)
+{
+    startLine = qMax(0, startLine);
+    endLine = qMin(endLine, m_document->lines() - 1);
+
+    std::vector<qint32> lengths;
+    lengths.reserve(qMax(0, endLine - startLine + 1));
+    for (int line = startLine; line <= endLine; ++line) {
+        lengths.push_back(m_document->lineLength(line));
+    }
+    return toInt32Array(m_engine, lengths);
+}
+
+QJSValue KateScriptDocument::attributeRuns(int startLine, int endLine)
+{
+    startLine = qMax(0, startLine);
+    endLine = qMin(endLine, m_document->lines() - 1);
+
+    QJSValue jsArray = m_engine->newArray(qMax(0, endLine - startLine + 1));
+    std::vector<qint32> runs;
+    for (int line = startLine; line <= endLine; ++line) {
+        // kateTextLine() ensures the line is highlighted, like attribute()
+        runs.clear();
+        Kate::TextLine textLine = m_document->kateTextLine(line);
+        if (textLine) {
+            for (const auto &attribute : textLine->attributesList()) {
+                runs.push_back(attribute.offset);
+                runs.push_back(attribute.length);
+                runs.push_back(attribute.attributeValue);
+            }
+        }
+        jsArray.setProperty(line - startLine, toInt32Array(m_engine, runs));
+    }
+    return jsArray;
+}
+
+bool KateScriptDocument::applyEdits(const QJSValue &jsedits)
+{
+    struct Edit {
+        KTextEditor::Range range;
+        QString text;
+    };
+
+    // unpack the array of edits
+    std::vector<Edit> edits;
+    const int length = jsedits.property(QStringLiteral("length")).toInt();
+    edits.reserve(length);
+    const KTextEditor::Range documentRange = m_document->documentRange();
+    for (int i = 0; i < length; ++i) {
+        const QJSValue edit = jsedits.property(i);
+        const auto range = rangeFromScriptValue(edit.property(QStringLiteral("range")));
+        if (!range.isValid() || !documentRange.contains(range)) {
+            return false;
+        }
+        edits.push_back({range, edit.property(QStringLiteral("text")).toString()});
+    }
+
+    // apply from the end of the document to the start, this way the ranges of
+    // the edits still to apply stay valid, insertions at the same position
+    // are applied in reverse list order to end up in list order
+    std::vector<int> order(edits.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&edits](int a, int b) {
+        if (edits[a].range.start() != edits[b].range.start()) {
+            return edits[a].range.start() > edits[b].range.start();
+        }
+        if (edits[a].range.end() != edits[b].range.end()) {
+            return edits[a].range.end() > edits[b].range.end();
+        }
+        return a > b;
+    });
+    for (size_t i = 1; i < order.size(); ++i) {
+        if (edits[order[i]].range.end() > edits[order[i - 1]].range.start()) {
+            return false;
+        }
+    }
+
+    m_document->editStart();
+    for (int i : order) {
+        m_document->replaceText(edits[i].range, edits[i].text);
+    }
+    m_document->editEnd();
+    return true;
+}
+
 void KateScriptDocument::editBegin()
 {
     m_document->editBegin();
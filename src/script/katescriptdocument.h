@@ -87,6 +87,28 @@ public:
     Q_INVOKABLE int findTouchedLine(int startLine, bool down);
     Q_INVOKABLE int length();
     Q_INVOKABLE int lineLength(int line);
+
+    /**
+     * Bulk accessors, to avoid crossing the script boundary for each line or
+     * character. Line ranges are inclusive and clamped to the document.
+     */
+    Q_INVOKABLE QStringList textLines(int startLine, int endLine);
+    /**
+     * Lengths of the lines as Int32Array.
+     */
+    Q_INVOKABLE QJSValue lineLengths(int startLine, int endLine);
+    /**
+     * Highlighting attributes of the lines, one Int32Array per line with
+     * the flattened (offset, length, attribute) triples of its runs.
+     */
+    Q_INVOKABLE QJSValue attributeRuns(int startLine, int endLine);
+    /**
+     * Apply a list of edits { range: Range, text: String } in one transaction.
+     * Ranges refer to the document before any of the edits and must not overlap,
+     * insertions at the same position are inserted in list order.
+     * @return false and leave the document untouched if a range is invalid or overlaps another one
+     */
+    Q_INVOKABLE bool applyEdits(const QJSValue &edits);
     Q_INVOKABLE void editBegin();
     Q_INVOKABLE void editEnd();
     Q_INVOKABLE int firstColumn(int line);
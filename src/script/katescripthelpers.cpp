@@ -15,6 +15,7 @@
 #include <iostream>
 
 #include <QFile>
+#include <QHash>
 #include <QJSEngine>
 #include <QStandardPaths>
 
@@ -42,6 +43,63 @@ bool readFile(const QString &sourceUrl, QString &sourceCode)
     return true;
 }
 
+namespace
+{
+/**
+ * located and read library, shared by all script engines
+ */
+struct CachedLibrary {
+    QString fullName;
+    QString sourceCode;
+};
+
+/**
+ * cache of libraries by require() name, scripts are only used from the GUI thread
+ */
+QHash<QString, CachedLibrary> &libraryCache()
+{
+    static QHash<QString, CachedLibrary> cache;
+    return cache;
+}
+}
+
+bool readLibrary(const QString &name, QString &fullName, QString &sourceCode)
+{
+    // each indenter and command script requires the same few libraries, avoid the lookup and read for each engine
+    auto &cache = libraryCache();
+    const auto it = cache.constFind(name);
+    if (it != cache.constEnd()) {
+        fullName = it->fullName;
+        sourceCode = it->sourceCode;
+        return true;
+    }
+
+    // get full name of file
+    // skip on errors
+    fullName = QStandardPaths::locate(QStandardPaths::GenericDataLocation, QLatin1String("katepart5/script/libraries/") + name);
+    if (fullName.isEmpty()) {
+        // retry with resource
+        fullName = QLatin1String(":/ktexteditor/script/libraries/") + name;
+        if (!QFile::exists(fullName)) {
+            return false;
+        }
+    }
+
+    // try to read complete file
+    // skip non-existing files
+    if (!readFile(fullName, sourceCode)) {
+        return false;
+    }
+
+    cache.insert(name, CachedLibrary{fullName, sourceCode});
+    return true;
+}
+
+void clearLibraryCache()
+{
+    libraryCache().clear();
+}
+
 } // namespace Script
 
 QString ScriptHelper::read(const QString &name)
@@ -66,15 +124,12 @@ QString ScriptHelper::read(const QString &name)
 
 void ScriptHelper::require(const QString &name)
 {
-    // get full name of file
+    // locate & read the library, cached across all engines
     // skip on errors
-    QString fullName = QStandardPaths::locate(QStandardPaths::GenericDataLocation, QLatin1String("katepart5/script/libraries/") + name);
-    if (fullName.isEmpty()) {
-        // retry with resource
-        fullName = QLatin1String(":/ktexteditor/script/libraries/") + name;
-        if (!QFile::exists(fullName)) {
-            return;
-        }
+    QString fullName;
+    QString code;
+    if (!Script::readLibrary(name, fullName, code)) {
+        return;
     }
 
     // check include guard
@@ -83,13 +138,6 @@ void ScriptHelper::require(const QString &name)
         return;
     }
 
-    // try to read complete file
-    // skip non-existing files
-    QString code;
-    if (!Script::readFile(fullName, code)) {
-        return;
-    }
-
     // eval in current script engine
     const QJSValue val = m_engine->evaluate(code, fullName);
     if (val.isError()) {
@@ -21,6 +21,19 @@ namespace Script
 /** read complete file contents, helper */
 KTEXTEDITOR_EXPORT bool readFile(const QString &sourceUrl, QString &sourceCode);
 
+/**
+ * locate and read a library for require(), e.g. "range.js"
+ * the lookup and the contents are cached and shared by all script engines
+ * @param name name of the library
+ * @param fullName located full path of the library
+ * @param sourceCode library source code
+ * @return success?
+ */
+bool readLibrary(const QString &name, QString &fullName, QString &sourceCode);
+
+/** clear the library cache, e.g. on reload of all scripts */
+void clearLibraryCache();
+
 } // namespace Script
 
 class KTEXTEDITOR_EXPORT ScriptHelper : public QObject
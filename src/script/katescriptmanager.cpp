@@ -29,10 +29,12 @@
 #include <KLocalizedString>
 
 #include "katecmd.h"
+#include "katecmds.h"
 #include "katecommandlinescript.h"
 #include "kateglobal.h"
 #include "kateindentscript.h"
 #include "katepartdebug.h"
+#include "katescripthelpers.h"
 
 KateScriptManager *KateScriptManager::m_instance = nullptr;
 
@@ -246,6 +248,15 @@ void KateScriptManager::collect()
                                      << "-> skipping script" << '\n';
                     continue;
                 }
+                // the native line commands replace the bundled utils.js functions, but must not shadow a utils.js of the user
+                if (baseName == QLatin1String("utils")) {
+                    KateCmd *cmdManager = KTextEditor::EditorPrivate::self()->cmdManager();
+                    if (fileName.startsWith(QLatin1String(":/"))) {
+                        cmdManager->registerCommand(KateCommands::LineCommands::self());
+                    } else {
+                        cmdManager->unregisterCommand(KateCommands::LineCommands::self());
+                    }
+                }
                 KateCommandLineScript *script = new KateCommandLineScript(fileName, commandHeader);
                 script->setGeneralHeader(generalHeader);
                 m_commandLineScripts.push_back(script);
@@ -277,6 +288,8 @@ void KateScriptManager::collect()
 
 void KateScriptManager::reload()
 {
+    // libraries might have changed on disk, too
+    Kate::Script::clearLibraryCache();
     collect();
     Q_EMIT reloaded();
 }
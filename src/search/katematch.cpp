@@ -64,7 +64,7 @@ bool KateMatch::isValid() const
     return range().isValid();
 }
 
-QString KateMatch::buildReplacement(const QString &replacement, bool blockMode, int replacementCounter) const
+QString KateMatch::buildReplacement(const QString &replacement, bool blockMode, int replacementCounter)
 {
     QStringList capturedTexts;
     capturedTexts.reserve(m_resultRanges.size());
@@ -73,5 +73,9 @@ QString KateMatch::buildReplacement(const QString &replacement, bool blockMode,
         capturedTexts << m_document->text(captureRange, blockMode);
     }
 
-    return KateRegExpSearch::buildReplacement(replacement, capturedTexts, replacementCounter);
+    if (!m_replacementTemplate || replacement != m_replacement) {
+        m_replacement = replacement;
+        m_replacementTemplate.emplace(replacement);
+    }
+    return m_replacementTemplate->build(capturedTexts, replacementCounter);
 }
@@ -9,10 +9,13 @@
 #define KATE_MATCH_H
 
 #include <memory>
+#include <optional>
 
 #include <ktexteditor/document.h>
 #include <ktexteditor/movingrange.h>
 
+#include "kateregexpsearch.h"
+
 namespace KTextEditor
 {
 class DocumentPrivate;
@@ -31,8 +34,9 @@ public:
 private:
     /**
      * Resolve references and escape sequences.
+     * The parsed @p replacement is kept, a replace all passes the same text for each match.
      */
-    QString buildReplacement(const QString &replacement, bool blockMode, int replacementCounter) const;
+    QString buildReplacement(const QString &replacement, bool blockMode, int replacementCounter);
 
 private:
     KTextEditor::DocumentPrivate *const m_document;
@@ -44,6 +48,12 @@ private:
      * kept for later reuse
      */
     std::unique_ptr<KTextEditor::MovingRange> m_afterReplaceRange;
+
+    /**
+     * last replacement text and its parsed form
+     */
+    QString m_replacement;
+    std::optional<KateRegExpSearch::ReplacementTemplate> m_replacementTemplate;
 };
 
 #endif // KATE_MATCH_H
@@ -0,0 +1,264 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+// BEGIN includes
+#include "katemultipatternsearch.h"
+
+#include "kateplaintextsearch.h"
+#include "kateregexpsearch.h"
+
+#include <algorithm>
+// END  includes
+
+static inline char16_t foldedChar(QChar c, bool caseInsensitive)
+{
+    return caseInsensitive ? QChar::toCaseFolded(c.unicode()) : c.unicode();
+}
+
+static int transition(const std::vector<std::pair<char16_t, int>> &next, char16_t c)
+{
+    const auto it = std::lower_bound(next.begin(), next.end(), c, [](const std::pair<char16_t, int> &t, char16_t value) {
+        return t.first < value;
+    });
+    return (it != next.end() && it->first == c) ? it->second : -1;
+}
+
+// BEGIN d'tor, c'tor
+KateMultiPatternSearch::KateMultiPatternSearch(const KTextEditor::Document *document, const QStringList &patterns, KTextEditor::SearchOptions options)
+    : m_document(document)
+    , m_highlight(KatePlainTextSearch::highlighting(document))
+    , m_caseInsensitive(options.testFlag(KTextEditor::CaseInsensitive))
+    , m_wholeWords(options.testFlag(KTextEditor::WholeWords))
+    , m_regex(options.testFlag(KTextEditor::Regex))
+{
+    if (m_regex) {
+        buildRegularExpressions(patterns);
+    } else if (options.testFlag(KTextEditor::EscapeSequences)) {
+        QStringList unescaped;
+        unescaped.reserve(patterns.size());
+        for (const QString &pattern : patterns) {
+            unescaped.append(KateRegExpSearch::escapePlaintext(pattern));
+        }
+        buildAutomaton(unescaped);
+    } else {
+        buildAutomaton(patterns);
+    }
+}
+
+KateMultiPatternSearch::~KateMultiPatternSearch() = default;
+// END
+
+void KateMultiPatternSearch::buildAutomaton(const QStringList &patterns)
+{
+    // the trie of all patterns
+    m_states.emplace_back();
+    m_patternLengths.reserve(patterns.size());
+    for (int i = 0; i < patterns.size(); ++i) {
+        const QString &pattern = patterns.at(i);
+        m_patternLengths.push_back(pattern.size());
+        if (pattern.isEmpty() || pattern.contains(QLatin1Char('\n'))) {
+            continue;
+        }
+
+        int state = 0;
+        for (const QChar c : pattern) {
+            const char16_t folded = foldedChar(c, m_caseInsensitive);
+            auto &next = m_states[state].next;
+            auto it = std::lower_bound(next.begin(), next.end(), folded, [](const std::pair<char16_t, int> &t, char16_t value) {
+                return t.first < value;
+            });
+            if (it != next.end() && it->first == folded) {
+                state = it->second;
+                continue;
+            }
+
+            // add the state after the transition, m_states might reallocate
+            const int newState = m_states.size();
+            next.insert(it, {folded, newState});
+            m_states.emplace_back();
+            state = newState;
+        }
+        m_states[state].patterns.push_back(i);
+    }
+
+    // failure and output links, breadth first, the links point to states of smaller depth
+    std::vector<int> queue;
+    queue.reserve(m_states.size());
+    for (const auto &t : m_states[0].next) {
+        queue.push_back(t.second);
+    }
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        const int state = queue[head];
+        for (const auto &[c, child] : m_states[state].next) {
+            int failure = m_states[state].failure;
+            int target = transition(m_states[failure].next, c);
+            while (target < 0 && failure != 0) {
+                failure = m_states[failure].failure;
+                target = transition(m_states[failure].next, c);
+            }
+            const int childFailure = target < 0 ? 0 : target;
+            m_states[child].failure = childFailure;
+            m_states[child].outputLink = m_states[childFailure].patterns.empty() ? m_states[childFailure].outputLink : childFailure;
+            queue.push_back(child);
+        }
+    }
+}
+
+void KateMultiPatternSearch::buildRegularExpressions(const QStringList &patterns)
+{
+    QRegularExpression::PatternOptions options = QRegularExpression::UseUnicodePropertiesOption;
+    if (m_caseInsensitive) {
+        options |= QRegularExpression::CaseInsensitiveOption;
+    }
+
+    // references to capture groups break if the patterns are wrapped into one alternation
+    static const QRegularExpression backReference(QStringLiteral("\\\\(?:[1-9]|g|k)"));
+
+    bool combine = true;
+    QString alternation;
+    int capture = 1;
+    m_captureOfPattern.reserve(patterns.size());
+    for (const QString &pattern : patterns) {
+        const QRegularExpression regularExpression(pattern, options);
+        if (!regularExpression.isValid()) {
+            m_captureOfPattern.push_back(-1);
+            continue;
+        }
+        combine = combine && !pattern.contains(backReference);
+
+        if (!alternation.isEmpty()) {
+            alternation += QLatin1Char('|');
+        }
+        alternation += QLatin1Char('(') + pattern + QLatin1Char(')');
+        m_captureOfPattern.push_back(capture);
+        capture += 1 + regularExpression.captureCount();
+    }
+
+    if (combine) {
+        QRegularExpression regularExpression(alternation, options);
+        if (regularExpression.isValid()) {
+            regularExpression.optimize();
+            m_regularExpressions.push_back(regularExpression);
+            return;
+        }
+    }
+
+    // e.g. the same named group in several patterns, match them one by one
+    m_captureOfPattern.clear();
+    for (const QString &pattern : patterns) {
+        m_regularExpressions.emplace_back(pattern, options);
+        m_regularExpressions.back().optimize();
+    }
+}
+
+QVector<KateMultiPatternSearch::Match> KateMultiPatternSearch::search(KTextEditor::Range inputRange) const
+{
+    QVector<Match> matches;
+    if (!inputRange.isValid()) {
+        return matches;
+    }
+
+    // end of the last match of each pattern, to avoid overlapping matches of it
+    std::vector<KTextEditor::Cursor> lastEnds(m_patternLengths.size(), KTextEditor::Cursor::invalid());
+
+    const int endLine = qMin(inputRange.end().line(), m_document->lines() - 1);
+    for (int line = qMax(0, inputRange.start().line()); line <= endLine; ++line) {
+        const QString textLine = m_document->line(line);
+        const int startCol = (line == inputRange.start().line()) ? qMin(inputRange.start().column(), int(textLine.size())) : 0;
+        const int endCol = (line == inputRange.end().line()) ? qMin(inputRange.end().column(), int(textLine.size())) : textLine.size();
+        if (startCol >= endCol) {
+            continue;
+        }
+
+        if (m_regex) {
+            searchRegularExpressions(textLine, line, startCol, endCol, matches);
+        } else {
+            searchLiterals(textLine, line, startCol, endCol, lastEnds, matches);
+        }
+    }
+
+    // the automaton finds the matches by end position
+    std::stable_sort(matches.begin(), matches.end(), [](const Match &a, const Match &b) {
+        return a.range.start() < b.range.start() || (a.range.start() == b.range.start() && a.pattern < b.pattern);
+    });
+    return matches;
+}
+
+void KateMultiPatternSearch::searchLiterals(const QString &textLine,
+                                            int line,
+                                            int startCol,
+                                            int endCol,
+                                            std::vector<KTextEditor::Cursor> &lastEnds,
+                                            QVector<Match> &matches) const
+{
+    int state = 0;
+    for (int column = startCol; column < endCol; ++column) {
+        const char16_t c = foldedChar(textLine.at(column), m_caseInsensitive);
+        int target = transition(m_states[state].next, c);
+        while (target < 0 && state != 0) {
+            state = m_states[state].failure;
+            target = transition(m_states[state].next, c);
+        }
+        state = target < 0 ? 0 : target;
+
+        // all patterns ending here
+        const int end = column + 1;
+        for (int output = m_states[state].patterns.empty() ? m_states[state].outputLink : state; output >= 0; output = m_states[output].outputLink) {
+            for (const int pattern : m_states[output].patterns) {
+                const int start = end - m_patternLengths[pattern];
+                const KTextEditor::Cursor lastEnd = lastEnds[pattern];
+                if (lastEnd.line() == line && start < lastEnd.column()) {
+                    continue;
+                }
+
+                if (m_wholeWords
+                    && (!KatePlainTextSearch::isWordBoundary(m_highlight, textLine, start) || !KatePlainTextSearch::isWordBoundary(m_highlight, textLine, end))) {
+                    continue;
+                }
+
+                matches.push_back({pattern, KTextEditor::Range(line, start, line, end)});
+                lastEnds[pattern] = KTextEditor::Cursor(line, end);
+            }
+        }
+    }
+}
+
+void KateMultiPatternSearch::searchRegularExpressions(const QString &textLine, int line, int startCol, int endCol, QVector<Match> &matches) const
+{
+    for (std::size_t i = 0; i < m_regularExpressions.size(); ++i) {
+        // invalid patterns never match
+        if (!m_regularExpressions[i].isValid()) {
+            continue;
+        }
+
+        auto it = m_regularExpressions[i].globalMatch(textLine, startCol);
+        while (it.hasNext()) {
+            const QRegularExpressionMatch match = it.next();
+            if (match.capturedEnd() > endCol) {
+                break;
+            }
+
+            // nothing to highlight
+            if (match.capturedLength() == 0) {
+                continue;
+            }
+
+            if (m_captureOfPattern.empty()) {
+                matches.push_back({int(i), KTextEditor::Range(line, match.capturedStart(), line, match.capturedEnd())});
+                continue;
+            }
+
+            // the first alternative that matched
+            for (std::size_t pattern = 0; pattern < m_captureOfPattern.size(); ++pattern) {
+                const int capture = m_captureOfPattern[pattern];
+                if (capture >= 0 && match.capturedStart(capture) >= 0) {
+                    matches.push_back({int(pattern), KTextEditor::Range(line, match.capturedStart(), line, match.capturedEnd())});
+                    break;
+                }
+            }
+        }
+    }
+}
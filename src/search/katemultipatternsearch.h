@@ -0,0 +1,104 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KATE_MULTIPATTERNSEARCH_H
+#define KATE_MULTIPATTERNSEARCH_H
+
+#include <ktexteditor/document.h>
+#include <ktexteditor/range.h>
+
+#include <ktexteditor_export.h>
+
+#include <QRegularExpression>
+#include <QStringList>
+#include <QVector>
+
+#include <vector>
+
+class KateHighlighting;
+
+/**
+ * Object to search for several patterns in one pass over the lines of a document,
+ * e.g. to highlight all of them in the visible lines.
+ *
+ * Plain text patterns are matched by an Aho-Corasick automaton, regular expressions
+ * are combined into one alternation. Like KatePlainTextSearch, this is no QObject,
+ * the automaton should be built once per set of patterns and reused.
+ *
+ * Matches never span lines, patterns containing a line break never match.
+ */
+class KTEXTEDITOR_EXPORT KateMultiPatternSearch
+{
+public:
+    /**
+     * A match of the pattern with the index @p pattern.
+     */
+    struct Match {
+        int pattern;
+        KTextEditor::Range range;
+    };
+
+    /**
+     * Create the matcher for @p patterns.
+     * Supported are the options KTextEditor::CaseInsensitive, KTextEditor::WholeWords
+     * (only for plain text), KTextEditor::EscapeSequences and KTextEditor::Regex,
+     * they apply to all patterns.
+     */
+    KateMultiPatternSearch(const KTextEditor::Document *document, const QStringList &patterns, KTextEditor::SearchOptions options);
+    ~KateMultiPatternSearch();
+
+    KateMultiPatternSearch(const KateMultiPatternSearch &) = delete;
+    KateMultiPatternSearch &operator=(const KateMultiPatternSearch &) = delete;
+
+    /**
+     * All matches of all patterns in @p inputRange, sorted by position.
+     * The matches of one pattern don't overlap. For regular expressions, a match
+     * of one pattern hides the overlapping matches of the patterns after it.
+     */
+    QVector<Match> search(KTextEditor::Range inputRange) const;
+
+private:
+    void buildAutomaton(const QStringList &patterns);
+    void buildRegularExpressions(const QStringList &patterns);
+    void searchLiterals(const QString &textLine, int line, int startCol, int endCol, std::vector<KTextEditor::Cursor> &lastEnds, QVector<Match> &matches) const;
+    void searchRegularExpressions(const QString &textLine, int line, int startCol, int endCol, QVector<Match> &matches) const;
+
+private:
+    const KTextEditor::Document *const m_document;
+    const KateHighlighting *const m_highlight;
+    const bool m_caseInsensitive;
+    const bool m_wholeWords;
+    const bool m_regex;
+
+    /**
+     * Aho-Corasick automaton for plain text patterns, state 0 is the root.
+     * The transitions of a state are sorted by character.
+     */
+    struct State {
+        std::vector<std::pair<char16_t, int>> next;
+        int failure = 0;
+        // next state on the failure chain with patterns ending in it, -1 if none
+        int outputLink = -1;
+        // patterns ending in this state
+        std::vector<int> patterns;
+    };
+    std::vector<State> m_states;
+    std::vector<int> m_patternLengths;
+
+    /**
+     * Regular expressions, one alternation of all patterns if possible,
+     * else one per pattern.
+     */
+    std::vector<QRegularExpression> m_regularExpressions;
+
+    /**
+     * For the alternation, the capture group of each pattern in it, -1 for invalid patterns.
+     * Empty if the patterns are matched one by one.
+     */
+    std::vector<int> m_captureOfPattern;
+};
+
+#endif
@@ -8,13 +8,14 @@
 // BEGIN includes
 #include "kateplaintextsearch.h"
 
-#include "kateregexpsearch.h"
-
-#include <ktexteditor/document.h>
+#include "kateconfig.h"
+#include "katedocument.h"
+#include "katehighlight.h"
+#include "katetextblock.h"
 
 #include "katepartdebug.h"
 
-#include <QRegularExpression>
+#include <QStringMatcher>
 // END  includes
 
 // BEGIN d'tor, c'tor
@@ -23,6 +24,7 @@
 //
 KatePlainTextSearch::KatePlainTextSearch(const KTextEditor::Document *document, Qt::CaseSensitivity caseSensitivity, bool wholeWords)
     : m_document(document)
+    , m_highlight(highlighting(document))
     , m_caseSensitivity(caseSensitivity)
     , m_wholeWords(wholeWords)
 {
@@ -30,19 +32,29 @@ KatePlainTextSearch::KatePlainTextSearch(const KTextEditor::Document *document,
 
 // END
 
-KTextEditor::Range KatePlainTextSearch::search(const QString &text, KTextEditor::Range inputRange, bool backwards)
+static bool isInWord(const KateHighlighting *highlight, QChar c)
 {
-    // abuse regex for whole word plaintext search
-    if (m_wholeWords) {
-        // escape dot and friends
-        const QString workPattern = QStringLiteral("\\b%1\\b").arg(QRegularExpression::escape(text));
+    if (highlight) {
+        return highlight->isInWord(c);
+    }
+    return c.isLetterOrNumber() || c.isMark() || c == QLatin1Char('_');
+}
 
-        QRegularExpression::PatternOptions options;
-        options |= m_caseSensitivity == Qt::CaseInsensitive ? QRegularExpression::CaseInsensitiveOption : QRegularExpression::NoPatternOption;
+bool KatePlainTextSearch::isWordBoundary(const KateHighlighting *highlight, const QString &textLine, int column)
+{
+    const bool wordBefore = column > 0 && isInWord(highlight, textLine.at(column - 1));
+    const bool wordAfter = column < textLine.size() && isInWord(highlight, textLine.at(column));
+    return wordBefore != wordAfter;
+}
 
-        return KateRegExpSearch(m_document).search(workPattern, inputRange, backwards, options).at(0);
-    }
+const KateHighlighting *KatePlainTextSearch::highlighting(const KTextEditor::Document *document)
+{
+    const auto doc = qobject_cast<const KTextEditor::DocumentPrivate *>(document);
+    return doc ? doc->highlight() : nullptr;
+}
 
+KTextEditor::Range KatePlainTextSearch::search(const QString &text, KTextEditor::Range inputRange, bool backwards)
+{
     if (text.isEmpty() || !inputRange.isValid() || (inputRange.start() == inputRange.end())) {
         return KTextEditor::Range::invalid();
     }
@@ -50,6 +62,10 @@ KTextEditor::Range KatePlainTextSearch::search(const QString &text, KTextEditor:
     // split multi-line needle into single lines
     const QVector<QStringView> needleLines = QStringView(text).split(QLatin1Char('\n'));
 
+    // skip the blocks that can't contain the text according to the search index
+    const auto doc = qobject_cast<const KTextEditor::DocumentPrivate *>(m_document);
+    const bool useIndex = doc && doc->config()->searchIndex();
+
     if (needleLines.count() > 1) {
         // multi-line plaintext search (both forwards or backwards)
         const int forMin = inputRange.start().line(); // first line in range
@@ -57,7 +73,17 @@ KTextEditor::Range KatePlainTextSearch::search(const QString &text, KTextEditor:
         const int forInit = backwards ? forMax : forMin;
         const int forInc = backwards ? -1 : +1;
 
+        // the first line ends with the first needle line
+        const std::vector<uint> trigrams = useIndex ? Kate::TextBlock::searchTrigrams(needleLines[0]) : std::vector<uint>();
+
         for (int j = forInit; (forMin <= j) && (j <= forMax); j += forInc) {
+            if (!trigrams.empty()) {
+                j = doc->searchCandidateLine(j, backwards ? forMin : forMax, trigrams);
+                if (j < 0) {
+                    break;
+                }
+            }
+
             // try to match all lines
             const int startCol = m_document->lineLength(j) - needleLines[0].length();
             for (int k = 0; k < needleLines.count(); k++) {
@@ -84,6 +110,11 @@ KTextEditor::Range KatePlainTextSearch::search(const QString &text, KTextEditor:
                     // NOTE: QString("")::startsWith("") is false in Qt, therefore we need the additional checks.
                     const bool startsWith = hayLine.startsWith(needleLine, m_caseSensitivity) || (hayLine.isEmpty() && needleLine.isEmpty());
                     if (startsWith && needleLine.length() <= maxRight) {
+                        // whole words only: word boundaries at both ends of the match
+                        if (m_wholeWords
+                            && (!isWordBoundary(m_highlight, m_document->line(j), startCol) || !isWordBoundary(m_highlight, hayLine, needleLine.length()))) {
+                            break;
+                        }
                         return KTextEditor::Range(j, startCol, j + k, needleLine.length());
                     }
                 } else {
@@ -105,20 +136,53 @@ KTextEditor::Range KatePlainTextSearch::search(const QString &text, KTextEditor:
         const int endLine = inputRange.end().line();
         const int forInc = backwards ? -1 : +1;
 
+        // the skip table is built once for the whole search, not once per line like for QString::indexOf()
+        const QStringMatcher matcher(text, m_caseSensitivity);
+        auto isMatch = [this, &text](const QString &textLine, int column) {
+            return !m_wholeWords || (isWordBoundary(m_highlight, textLine, column) && isWordBoundary(m_highlight, textLine, column + text.length()));
+        };
+        const std::vector<uint> trigrams = useIndex ? Kate::TextBlock::searchTrigrams(text) : std::vector<uint>();
+
         for (int line = backwards ? endLine : startLine; (startLine <= line) && (line <= endLine); line += forInc) {
             if ((line < 0) || (m_document->lines() <= line)) {
                 qCWarning(LOG_KTE) << "line " << line << " is not within interval [0.." << m_document->lines() << ") ... returning invalid range";
                 return KTextEditor::Range::invalid();
             }
 
+            if (!trigrams.empty()) {
+                line = doc->searchCandidateLine(line, backwards ? startLine : endLine, trigrams);
+                if (line < 0) {
+                    break;
+                }
+            }
+
             const QString textLine = m_document->line(line);
 
             const int offset = (line == startLine) ? startCol : 0;
             const int line_end = (line == endLine) ? endCol : textLine.length();
-            const int foundAt =
-                backwards ? textLine.lastIndexOf(text, line_end - text.length(), m_caseSensitivity) : textLine.indexOf(text, offset, m_caseSensitivity);
+            if (line_end - offset < text.length()) {
+                continue;
+            }
+
+            // try the candidates until one is a whole word, if requested
+            int foundAt = -1;
+            if (backwards) {
+                for (int from = line_end - text.length(); from >= offset; from = foundAt - 1) {
+                    foundAt = textLine.lastIndexOf(text, from, m_caseSensitivity);
+                    if (foundAt < offset || isMatch(textLine, foundAt)) {
+                        break;
+                    }
+                }
+            } else {
+                for (int from = offset; from <= line_end - text.length(); from = foundAt + 1) {
+                    foundAt = matcher.indexIn(textLine, from);
+                    if (foundAt < 0 || foundAt + text.length() > line_end || isMatch(textLine, foundAt)) {
+                        break;
+                    }
+                }
+            }
 
-            if ((offset <= foundAt) && (foundAt + text.length() <= line_end)) {
+            if ((offset <= foundAt) && (foundAt + text.length() <= line_end) && isMatch(textLine, foundAt)) {
                 return KTextEditor::Range(line, foundAt, line, foundAt + text.length());
             }
         }
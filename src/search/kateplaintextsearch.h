@@ -18,6 +18,7 @@ namespace KTextEditor
 {
 class Document;
 }
+class KateHighlighting;
 
 /**
  * Object to help to search for plain text.
@@ -45,8 +46,21 @@ public:
      */
     KTextEditor::Range search(const QString &text, KTextEditor::Range inputRange, bool backwards = false);
 
+    /**
+     * Is there a word boundary in \p textLine before \p column, like \\b in a regular expression?
+     * Uses the word delimiters of \p highlight, if any.
+     */
+    static bool isWordBoundary(const KateHighlighting *highlight, const QString &textLine, int column);
+
+    /**
+     * The highlighting to use for isWordBoundary() for \p document, nullptr for documents
+     * of other implementations.
+     */
+    static const KateHighlighting *highlighting(const KTextEditor::Document *document);
+
 private:
     const KTextEditor::Document *m_document;
+    const KateHighlighting *m_highlight;
     Qt::CaseSensitivity m_caseSensitivity;
     bool m_wholeWords;
 };
@@ -8,6 +8,10 @@
 // BEGIN includes
 #include "kateregexpsearch.h"
 
+#include "kateconfig.h"
+#include "katedocument.h"
+#include "katetextblock.h"
+
 #include <ktexteditor/document.h>
 // END  includes
 
@@ -163,6 +167,44 @@ struct IndexPair {
     int closeIndex;
 };
 
+/**
+ * The literal text all matches of the single-line @p pattern start with, e.g. "foo" for "^foo\\d+".
+ * Empty if the pattern starts with no literal or the prefix can't be determined easily.
+ */
+static QString literalPrefix(const QString &pattern, QRegularExpression::PatternOptions options)
+{
+    // alternatives need not share a prefix, in extended syntax whitespace is no literal
+    if (options.testFlag(QRegularExpression::ExtendedPatternSyntaxOption) || pattern.contains(QLatin1Char('|'))) {
+        return QString();
+    }
+
+    static const QString metaCharacters = QStringLiteral("\\.[](){}*+?|^$");
+    QString prefix;
+    int i = pattern.startsWith(QLatin1Char('^')) ? 1 : 0;
+    for (; i < pattern.size(); ++i) {
+        QChar c = pattern.at(i);
+        if (c == QLatin1Char('\\')) {
+            // escaped punctuation is a literal, \d, \n and co. are not
+            if (i + 1 >= pattern.size() || pattern.at(i + 1).isLetterOrNumber()) {
+                break;
+            }
+            c = pattern.at(++i);
+        } else if (metaCharacters.contains(c)) {
+            break;
+        }
+        prefix.append(c);
+    }
+
+    // a following quantifier might allow to skip the last character
+    if (i < pattern.size() && !prefix.isEmpty()) {
+        const QChar next = pattern.at(i);
+        if (next == QLatin1Char('?') || next == QLatin1Char('*') || next == QLatin1Char('{')) {
+            prefix.chop(1);
+        }
+    }
+    return prefix;
+}
+
 QVector<KTextEditor::Range>
 KateRegExpSearch::search(const QString &pattern, KTextEditor::Range inputRange, bool backwards, QRegularExpression::PatternOptions options)
 {
@@ -420,12 +462,24 @@ KateRegExpSearch::search(const QString &pattern, KTextEditor::Range inputRange,
 
         FAST_DEBUG("single line " << (backwards ? rangeEndLine : rangeStartLine) << ".." << (backwards ? rangeStartLine : rangeEndLine));
 
+        // skip the blocks that can't contain the literal prefix according to the search index
+        const auto doc = qobject_cast<const KTextEditor::DocumentPrivate *>(m_document);
+        const std::vector<uint> trigrams =
+            (doc && doc->config()->searchIndex()) ? Kate::TextBlock::searchTrigrams(literalPrefix(pattern, options)) : std::vector<uint>();
+
         for (int j = forInit; (rangeStartLine <= j) && (j <= rangeEndLine); j += forInc) {
             if (j < 0 || m_document->lines() <= j) {
                 FAST_DEBUG("searchText | line " << j << ": no");
                 return noResult;
             }
 
+            if (!trigrams.empty()) {
+                j = doc->searchCandidateLine(j, backwards ? rangeStartLine : rangeEndLine, trigrams);
+                if (j < 0) {
+                    break;
+                }
+            }
+
             const QString textLine = m_document->line(j);
 
             const int offset = (j == rangeStartLine) ? rangeStartCol : 0;
@@ -496,25 +550,46 @@ KateRegExpSearch::search(const QString &pattern, KTextEditor::Range inputRange,
 }
 
 /*static*/ QString KateRegExpSearch::buildReplacement(const QString &text, const QStringList &capturedTexts, int replacementCounter, bool replacementGoodies)
+{
+    return ReplacementTemplate(text, replacementGoodies).build(capturedTexts, replacementCounter);
+}
+
+KateRegExpSearch::ReplacementTemplate::ReplacementTemplate(const QString &text)
+    : ReplacementTemplate(text, true)
+{
+}
+
+KateRegExpSearch::ReplacementTemplate::ReplacementTemplate(const QString &text, bool replacementGoodies)
 {
     // get input
     const int inputLen = text.length();
     int input = 0; // walker index
 
-    // prepare output
-    ReplacementStream out(capturedTexts);
+    // consecutive literal characters form one part
+    const auto appendText = [this](QChar c) {
+        if (m_parts.empty() || m_parts.back().type != PartType::Text) {
+            m_parts.push_back({PartType::Text, QString(), 0});
+        }
+        m_parts.back().text.append(c);
+    };
+    const auto appendCapture = [this](int n) {
+        m_parts.push_back({PartType::Capture, QString(), n});
+    };
+    const auto appendCaseConversion = [this](ReplacementStream::CaseConversion caseConversion) {
+        m_parts.push_back({PartType::CaseConversion, QString(), caseConversion});
+    };
 
     while (input < inputLen) {
         switch (text[input].unicode()) {
         case L'\n':
-            out << text[input];
+            appendText(text[input]);
             input++;
             break;
 
         case L'\\':
             if (input + 1 >= inputLen) {
                 // copy backslash
-                out << text[input];
+                appendText(text[input]);
                 input++;
                 break;
             }
@@ -522,7 +597,7 @@ KateRegExpSearch::search(const QString &pattern, KTextEditor::Range inputRange,
             switch (text[input + 1].unicode()) {
             case L'0': // "\0000".."\0377"
                 if (input + 4 >= inputLen) {
-                    out << ReplacementStream::cap(0);
+                    appendCapture(0);
                     input += 2;
                 } else {
                     bool stripAndSkip = false;
@@ -537,7 +612,7 @@ KateRegExpSearch::search(const QString &pattern, KTextEditor::Range inputRange,
                                     digits[i] = 7 - (L'7' - text[input + 2 + i].unicode());
                                 }
                                 const int ch = 64 * digits[0] + 8 * digits[1] + digits[2];
-                                out << QChar(ch);
+                                appendText(QChar(ch));
                                 input += 5;
                             } else {
                                 stripAndSkip = true;
@@ -550,7 +625,7 @@ KateRegExpSearch::search(const QString &pattern, KTextEditor::Range inputRange,
                     }
 
                     if (stripAndSkip) {
-                        out << ReplacementStream::cap(0);
+                        appendCapture(0);
                         input += 2;
                     }
                 }
@@ -566,7 +641,7 @@ KateRegExpSearch::search(const QString &pattern, KTextEditor::Range inputRange,
             case L'7':
             case L'8':
             case L'9':
-                out << ReplacementStream::cap(9 - (L'9' - text[input + 1].unicode()));
+                appendCapture(9 - (L'9' - text[input + 1].unicode()));
                 input += 2;
                 break;
 
@@ -588,7 +663,7 @@ KateRegExpSearch::search(const QString &pattern, KTextEditor::Range inputRange,
                     }
                     break;
                 }
-                out << ReplacementStream::cap(capture);
+                appendCapture(capture);
                 input += captureSize;
                 break;
             }
@@ -600,29 +675,29 @@ KateRegExpSearch::search(const QString &pattern, KTextEditor::Range inputRange,
             case L'u':
                 if (!replacementGoodies) {
                     // strip backslash ("\?" -> "?")
-                    out << text[input + 1];
+                    appendText(text[input + 1]);
                 } else {
                     // handle case switcher
                     switch (text[input + 1].unicode()) {
                     case L'L':
-                        out << ReplacementStream::lowerCase;
+                        appendCaseConversion(ReplacementStream::lowerCase);
                         break;
 
                     case L'l':
-                        out << ReplacementStream::lowerCaseFirst;
+                        appendCaseConversion(ReplacementStream::lowerCaseFirst);
                         break;
 
                     case L'U':
-                        out << ReplacementStream::upperCase;
+                        appendCaseConversion(ReplacementStream::upperCase);
                         break;
 
                     case L'u':
-                        out << ReplacementStream::upperCaseFirst;
+                        appendCaseConversion(ReplacementStream::upperCaseFirst);
                         break;
 
                     case L'E': // FALLTHROUGH
                     default:
-                        out << ReplacementStream::keepCase;
+                        appendCaseConversion(ReplacementStream::keepCase);
                     }
                 }
                 input += 2;
@@ -631,7 +706,7 @@ KateRegExpSearch::search(const QString &pattern, KTextEditor::Range inputRange,
             case L'#':
                 if (!replacementGoodies) {
                     // strip backslash ("\?" -> "?")
-                    out << text[input + 1];
+                    appendText(text[input + 1]);
                     input += 2;
                 } else {
                     // handle replacement counter
@@ -641,45 +716,45 @@ KateRegExpSearch::search(const QString &pattern, KTextEditor::Range inputRange,
                     while ((input + minWidth + 1 < inputLen) && (text[input + minWidth + 1].unicode() == L'#')) {
                         minWidth++;
                     }
-                    out << ReplacementStream::counter(replacementCounter, minWidth);
+                    m_parts.push_back({PartType::Counter, QString(), minWidth});
                     input += 1 + minWidth;
                 }
                 break;
 
             case L'a':
-                out << QChar(0x07);
+                appendText(QChar(0x07));
                 input += 2;
                 break;
 
             case L'f':
-                out << QChar(0x0c);
+                appendText(QChar(0x0c));
                 input += 2;
                 break;
 
             case L'n':
-                out << QChar(0x0a);
+                appendText(QChar(0x0a));
                 input += 2;
                 break;
 
             case L'r':
-                out << QChar(0x0d);
+                appendText(QChar(0x0d));
                 input += 2;
                 break;
 
             case L't':
-                out << QChar(0x09);
+                appendText(QChar(0x09));
                 input += 2;
                 break;
 
             case L'v':
-                out << QChar(0x0b);
+                appendText(QChar(0x0b));
                 input += 2;
                 break;
 
             case L'x': // "\x0000".."\xffff"
                 if (input + 5 >= inputLen) {
                     // strip backslash ("\x" -> "x")
-                    out << text[input + 1];
+                    appendText(text[input + 1]);
                     input += 2;
                 } else {
                     bool stripAndSkip = false;
@@ -705,7 +780,7 @@ KateRegExpSearch::search(const QString &pattern, KTextEditor::Range inputRange,
                                     }
 
                                     const int ch = 4096 * digits[0] + 256 * digits[1] + 16 * digits[2] + digits[3];
-                                    out << QChar(ch);
+                                    appendText(QChar(ch));
                                     input += 6;
                                 } else {
                                     stripAndSkip = true;
@@ -720,7 +795,7 @@ KateRegExpSearch::search(const QString &pattern, KTextEditor::Range inputRange,
 
                     if (stripAndSkip) {
                         // strip backslash ("\x" -> "x")
-                        out << text[input + 1];
+                        appendText(text[input + 1]);
                         input += 2;
                     }
                 }
@@ -728,17 +803,37 @@ KateRegExpSearch::search(const QString &pattern, KTextEditor::Range inputRange,
 
             default:
                 // strip backslash ("\?" -> "?")
-                out << text[input + 1];
+                appendText(text[input + 1]);
                 input += 2;
             }
             break;
 
         default:
-            out << text[input];
+            appendText(text[input]);
             input++;
         }
     }
+}
 
+QString KateRegExpSearch::ReplacementTemplate::build(const QStringList &capturedTexts, int replacementCounter) const
+{
+    ReplacementStream out(capturedTexts);
+    for (const Part &part : m_parts) {
+        switch (part.type) {
+        case PartType::Text:
+            out << part.text;
+            break;
+        case PartType::Capture:
+            out << ReplacementStream::cap(part.value);
+            break;
+        case PartType::Counter:
+            out << ReplacementStream::counter(replacementCounter, part.value);
+            break;
+        case PartType::CaseConversion:
+            out << ReplacementStream::CaseConversion(part.value);
+            break;
+        }
+    }
     return out.str();
 }
 
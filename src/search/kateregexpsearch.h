@@ -13,6 +13,8 @@
 
 #include <ktexteditor/range.h>
 
+#include <vector>
+
 #include <ktexteditor_export.h>
 
 namespace KTextEditor
@@ -81,6 +83,51 @@ public:
      */
     static QString buildReplacement(const QString &text, const QStringList &capturedTexts, int replacementCounter);
 
+    /**
+     * A replacement text with its escape sequences, references, case conversions and
+     * counter sequences parsed once, to build the replacements of many matches.
+     * build() gives the same result as buildReplacement() with the same text.
+     */
+    class KTEXTEDITOR_EXPORT ReplacementTemplate
+    {
+    public:
+        /**
+         * Parse the replacement \p text, see buildReplacement().
+         */
+        explicit ReplacementTemplate(const QString &text);
+
+        /**
+         * The replacement for a match.
+         *
+         * \param capturedTexts list of substitutes for references
+         * \param replacementCounter value for replacement counter
+         * \return resolved text
+         */
+        QString build(const QStringList &capturedTexts, int replacementCounter) const;
+
+    private:
+        friend class KateRegExpSearch;
+        KTEXTEDITOR_NO_EXPORT ReplacementTemplate(const QString &text, bool replacementGoodies);
+
+        enum class PartType {
+            Text,
+            Capture,
+            Counter,
+            CaseConversion
+        };
+
+        /**
+         * Literal text, or the capture, counter width or case conversion for the other types.
+         */
+        struct Part {
+            PartType type;
+            QString text;
+            int value;
+        };
+
+        std::vector<Part> m_parts;
+    };
+
 private:
     /**
      * Implementation of escapePlainText() and public buildReplacement().
@@ -94,6 +141,7 @@ private:
     KTEXTEDITOR_NO_EXPORT
     static QString buildReplacement(const QString &text, const QStringList &capturedTexts, int replacementCounter, bool replacementGoodies);
 
+public:
     /**
      * Checks the pattern for special characters and escape sequences that can
      * make a match span multiple lines; if any are found, \p stillMultiLine is
@@ -0,0 +1,332 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+// BEGIN includes
+#include "katereplaceinfiles.h"
+
+#include "kateconfig.h"
+#include "katedocument.h"
+#include "kateglobal.h"
+#include "katematch.h"
+#include "kateplaintextsearch.h"
+#include "kateregexpsearch.h"
+#include "katetextbuffer.h"
+
+#include <KTextEditor/DocumentCursor>
+#include <KTextEditor/MovingRange>
+
+#include <KLocalizedString>
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QPromise>
+#include <QRegularExpression>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+// END  includes
+
+using ReplaceResult = KTextEditor::Editor::ReplaceResult;
+
+namespace
+{
+QThreadPool *replaceThreadPool()
+{
+    // own pool, a large replace shouldn't block other users of the global one
+    static QThreadPool *pool = [] {
+        return new QThreadPool(QCoreApplication::instance());
+    }();
+    return pool;
+}
+
+/**
+ * Everything needed to replace in a file that is not open, prepared on the GUI thread
+ * and shared read-only by the workers.
+ */
+class FileReplace
+{
+public:
+    FileReplace(const QString &pattern, const QString &replacement, KTextEditor::SearchOptions options)
+        : m_replacement(replacement)
+        , m_replacementTemplate(replacement)
+        , m_regex(options.testFlag(KTextEditor::Regex))
+        , m_wholeWords(options.testFlag(KTextEditor::WholeWords) && !m_regex)
+        , m_caseSensitivity(options.testFlag(KTextEditor::CaseInsensitive) ? Qt::CaseInsensitive : Qt::CaseSensitive)
+        , m_proberType(KateGlobalConfig::global()->proberType())
+        , m_fallbackCodec(KateGlobalConfig::global()->fallbackEncoding())
+        , m_codec(KTextEditor::EditorPrivate::self()->documentConfig()->encoding())
+    {
+        // placeholders like \n or \0 are only expanded for escape sequences and regular expressions
+        m_usePlaceholders = (m_regex || options.testFlag(KTextEditor::EscapeSequences)) && replacement.contains(QLatin1Char('\\'));
+
+        bool multiLine = false;
+        if (m_regex) {
+            m_patternOptions = QRegularExpression::UseUnicodePropertiesOption;
+            if (m_caseSensitivity == Qt::CaseInsensitive) {
+                m_patternOptions |= QRegularExpression::CaseInsensitiveOption;
+            }
+
+            // repairPattern() may assert on invalid patterns
+            if (!QRegularExpression(pattern, m_patternOptions).isValid()) {
+                m_error = i18n("The regular expression is invalid.");
+                return;
+            }
+            m_pattern = KateRegExpSearch::repairPattern(pattern, multiLine);
+        } else {
+            m_pattern = options.testFlag(KTextEditor::EscapeSequences) ? KateRegExpSearch::escapePlaintext(pattern) : pattern;
+            multiLine = m_pattern.contains(QLatin1Char('\n'));
+        }
+
+        if (multiLine) {
+            m_error = i18n("Patterns that span lines are only supported in open documents.");
+        }
+    }
+
+    ReplaceResult run(const QString &path) const
+    {
+        ReplaceResult result;
+        result.filePath = path;
+        if (!m_error.isEmpty()) {
+            result.errorString = m_error;
+            return result;
+        }
+
+        // load like a document, but don't wrap long lines, they would be saved wrapped
+        Kate::TextBuffer buffer(nullptr);
+        buffer.setEncodingProberType(m_proberType);
+        buffer.setFallbackTextCodec(m_fallbackCodec);
+        buffer.setTextCodec(m_codec);
+        buffer.setLineLengthLimit(0);
+
+        bool encodingErrors = false;
+        bool tooLongLinesWrapped = false;
+        int longestLineLoaded = 0;
+        if (!buffer.load(path, encodingErrors, tooLongLinesWrapped, longestLineLoaded, false)) {
+            result.errorString = i18n("The file %1 could not be loaded.", path);
+            return result;
+        }
+        if (encodingErrors) {
+            result.errorString = i18n("The file %1 could not be loaded without encoding errors, it was not changed.", path);
+            return result;
+        }
+
+        // compiled per file, the workers don't share the expression
+        const QRegularExpression regularExpression = m_regex ? QRegularExpression(m_pattern, m_patternOptions) : QRegularExpression();
+
+        // top to bottom, the counter for \# placeholders counts in document order
+        std::vector<std::pair<int, QString>> changedLines;
+        int counter = 0;
+        for (int line = 0; line < buffer.lines(); ++line) {
+            QString newText;
+            const int matches = replaceInLine(buffer.line(line)->text(), regularExpression, counter, newText);
+            if (matches > 0) {
+                result.replacements += matches;
+                changedLines.emplace_back(line, newText);
+            }
+        }
+        if (changedLines.empty()) {
+            return result;
+        }
+
+        // bottom up, a replacement containing line breaks doesn't move the lines still to change
+        buffer.startEditing();
+        for (auto it = changedLines.rbegin(); it != changedLines.rend(); ++it) {
+            const int line = it->first;
+            buffer.removeText(KTextEditor::Range(line, 0, line, buffer.lineLength(line)));
+
+            const QList<QStringView> parts = QStringView(it->second).split(QLatin1Char('\n'));
+            buffer.insertText(KTextEditor::Cursor(line, 0), parts.first().toString());
+            for (int i = 1; i < parts.size(); ++i) {
+                buffer.wrapLine(KTextEditor::Cursor(line + i - 1, buffer.lineLength(line + i - 1)));
+                buffer.insertText(KTextEditor::Cursor(line + i, 0), parts.at(i).toString());
+            }
+        }
+        buffer.finishEditing();
+
+        if (!buffer.save(path)) {
+            result.errorString = i18n("The file %1 could not be saved.", path);
+        }
+        return result;
+    }
+
+private:
+    /**
+     * Replace all matches in @p text, the result is only written to @p newText if there are matches.
+     * @return number of matches
+     */
+    int replaceInLine(const QString &text, const QRegularExpression &regularExpression, int &counter, QString &newText) const
+    {
+        int matches = 0;
+        int copied = 0;
+        const auto replace = [&](int start, int end, const QStringList &capturedTexts) {
+            newText += QStringView(text).mid(copied, start - copied);
+            ++counter;
+            newText += m_usePlaceholders ? m_replacementTemplate.build(capturedTexts, counter) : m_replacement;
+            copied = end;
+            ++matches;
+        };
+
+        if (m_regex) {
+            auto it = regularExpression.globalMatch(text);
+            while (it.hasNext()) {
+                const QRegularExpressionMatch match = it.next();
+                replace(match.capturedStart(), match.capturedEnd(), match.capturedTexts());
+            }
+        } else {
+            for (int start = text.indexOf(m_pattern, 0, m_caseSensitivity); start >= 0; start = text.indexOf(m_pattern, start, m_caseSensitivity)) {
+                const int end = start + m_pattern.size();
+                if (m_wholeWords && (!KatePlainTextSearch::isWordBoundary(nullptr, text, start) || !KatePlainTextSearch::isWordBoundary(nullptr, text, end))) {
+                    ++start;
+                    continue;
+                }
+                replace(start, end, m_usePlaceholders ? QStringList{text.mid(start, end - start)} : QStringList());
+                start = end;
+            }
+        }
+
+        if (matches > 0) {
+            newText += QStringView(text).mid(copied);
+        }
+        return matches;
+    }
+
+private:
+    QString m_pattern;
+    const QString m_replacement;
+    const KateRegExpSearch::ReplacementTemplate m_replacementTemplate;
+    const bool m_regex;
+    const bool m_wholeWords;
+    const Qt::CaseSensitivity m_caseSensitivity;
+    bool m_usePlaceholders = false;
+    QRegularExpression::PatternOptions m_patternOptions = QRegularExpression::NoPatternOption;
+    const KEncodingProber::ProberType m_proberType;
+    const QString m_fallbackCodec;
+    const QString m_codec;
+
+    // set if no file can be processed, e.g. for an invalid regular expression
+    QString m_error;
+};
+
+/**
+ * Replace all in @p doc in one edit transaction, like KateSearchBar::findOrReplaceAll().
+ */
+ReplaceResult replaceInDocument(KTextEditor::DocumentPrivate *doc, const QString &pattern, const QString &replacement, KTextEditor::SearchOptions options)
+{
+    ReplaceResult result;
+    result.document = doc;
+    result.filePath = doc->url().isLocalFile() ? doc->url().toLocalFile() : QString();
+    if (!doc->isReadWrite()) {
+        result.errorString = i18n("The document %1 is read-only.", doc->documentName());
+        return result;
+    }
+
+    KateMatch match(doc, options);
+    std::unique_ptr<KTextEditor::MovingRange> workingRange(doc->newMovingRange(doc->documentRange()));
+    bool editing = false;
+    while (true) {
+        match.searchText(workingRange->toRange(), pattern);
+        if (!match.isValid()) {
+            break;
+        }
+
+        if (!editing) {
+            doc->startEditing();
+            editing = true;
+        }
+
+        const bool emptyMatch = match.isEmpty();
+        const KTextEditor::Range replaced = match.replace(replacement, false, ++result.replacements);
+
+        // continue behind the replacement, step over empty matches to not find them again
+        KTextEditor::DocumentCursor next(doc, replaced.end());
+        if ((emptyMatch && !next.move(1)) || next.toCursor() >= workingRange->end().toCursor()) {
+            break;
+        }
+        workingRange->setRange(KTextEditor::Range(next.toCursor(), workingRange->end().toCursor()));
+    }
+
+    if (editing) {
+        doc->finishEditing();
+    }
+    return result;
+}
+}
+
+QFuture<ReplaceResult> KateReplaceInFiles::start(const QList<KTextEditor::Document *> &documents,
+                                                 const QStringList &filePaths,
+                                                 const QString &pattern,
+                                                 const QString &replacement,
+                                                 KTextEditor::SearchOptions options)
+{
+    auto promise = std::make_shared<QPromise<ReplaceResult>>();
+    QFuture<ReplaceResult> future = promise->future();
+    promise->start();
+
+    QList<KTextEditor::DocumentPrivate *> openDocuments;
+    for (KTextEditor::Document *document : documents) {
+        auto doc = qobject_cast<KTextEditor::DocumentPrivate *>(document);
+        if (doc && !openDocuments.contains(doc)) {
+            openDocuments.append(doc);
+        }
+    }
+
+    // files open in a document are changed in it, saving it would drop other modifications
+    const QList<KTextEditor::DocumentPrivate *> allDocuments = KTextEditor::EditorPrivate::self()->kateDocuments();
+    QStringList files;
+    for (const QString &filePath : filePaths) {
+        const QString path = QFileInfo(filePath).absoluteFilePath();
+        const auto it = std::find_if(allDocuments.begin(), allDocuments.end(), [&path](KTextEditor::DocumentPrivate *doc) {
+            return doc->url().isLocalFile() && doc->url().toLocalFile() == path;
+        });
+        if (it != allDocuments.end()) {
+            if (!openDocuments.contains(*it)) {
+                openDocuments.append(*it);
+            }
+        } else if (!files.contains(path)) {
+            files.append(path);
+        }
+    }
+
+    const int total = openDocuments.size() + files.size();
+    promise->setProgressRange(0, total);
+    if (pattern.isEmpty() || total == 0) {
+        promise->finish();
+        return future;
+    }
+
+    // the last item done finishes the future, after all results are added
+    const auto done = std::make_shared<std::atomic<int>>(0);
+    const auto reportDone = [promise, done, total]() {
+        const int processed = ++*done;
+        promise->setProgressValue(processed);
+        if (processed == total) {
+            promise->finish();
+        }
+    };
+
+    // the files first, they are processed while the documents are changed
+    const auto fileReplace = std::make_shared<const FileReplace>(pattern, replacement, options);
+    for (const QString &path : files) {
+        replaceThreadPool()->start([promise, fileReplace, path, reportDone]() {
+            if (!promise->isCanceled()) {
+                promise->addResult(fileReplace->run(path));
+            }
+            reportDone();
+        });
+    }
+
+    for (KTextEditor::DocumentPrivate *doc : std::as_const(openDocuments)) {
+        if (!promise->isCanceled()) {
+            promise->addResult(replaceInDocument(doc, pattern, replacement, options));
+        }
+        reportDone();
+    }
+
+    return future;
+}
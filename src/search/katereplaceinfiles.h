@@ -0,0 +1,35 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KATE_REPLACEINFILES_H
+#define KATE_REPLACEINFILES_H
+
+#include <ktexteditor/editor.h>
+
+#include <QStringList>
+
+/**
+ * Replace all matches of a pattern in many documents and files,
+ * the implementation of KTextEditor::Editor::replaceInDocuments().
+ *
+ * Documents are changed on the GUI thread like a replace all in the search bar,
+ * files that are not open are loaded into a Kate::TextBuffer, changed and saved
+ * in a thread pool.
+ */
+class KateReplaceInFiles
+{
+public:
+    /**
+     * Start the replacement, see KTextEditor::Editor::replaceInDocuments().
+     */
+    static QFuture<KTextEditor::Editor::ReplaceResult> start(const QList<KTextEditor::Document *> &documents,
+                                                             const QStringList &filePaths,
+                                                             const QString &pattern,
+                                                             const QString &replacement,
+                                                             KTextEditor::SearchOptions options);
+};
+
+#endif
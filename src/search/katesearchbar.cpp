@@ -151,6 +151,9 @@ KateSearchBar::KateSearchBar(bool initAsPower, KTextEditor::ViewPrivate *view, K
     connect(view, &KTextEditor::View::selectionChanged, this, &KateSearchBar::updateSelectionOnly);
     connect(this, &KateSearchBar::findOrReplaceAllFinished, this, &KateSearchBar::endFindOrReplaceAll);
 
+    m_incSearchTimer.setSingleShot(true);
+    connect(&m_incSearchTimer, &QTimer::timeout, this, &KateSearchBar::continueIncrementalSearch);
+
     auto setSelectionChangedByUndoRedo = [this]() {
         m_selectionChangedByUndoRedo = true;
     };
@@ -240,6 +243,7 @@ void KateSearchBar::closed()
     clearHighlights();
     m_replacement.clear();
     m_unfinishedSearchText.clear();
+    m_incSearchTimer.stop();
 }
 
 void KateSearchBar::setReplacementPattern(const QString &replacementPattern)
@@ -416,29 +420,98 @@ void KateSearchBar::onIncPatternChanged(const QString &pattern)
     m_incUi->next->setDisabled(pattern.isEmpty());
     m_incUi->prev->setDisabled(pattern.isEmpty());
 
-    KateMatch match(m_view->doc(), searchOptions());
+    // cancel the search for the previous pattern
+    m_incSearchTimer.stop();
 
-    if (!pattern.isEmpty()) {
-        // Find, first try
-        const Range inputRange = KTextEditor::Range(m_incInitCursor, m_view->document()->documentEnd());
-        match.searchText(inputRange, pattern);
+    if (pattern.isEmpty()) {
+        m_incSearch = IncrementalSearch();
+
+        // don't update m_incInitCursor when we move the cursor
+        disconnect(m_view, &KTextEditor::View::cursorPositionChanged, this, &KateSearchBar::updateIncInitCursor);
+        selectRange2(Range(m_incInitCursor, m_incInitCursor));
+        connect(m_view, &KTextEditor::View::cursorPositionChanged, this, &KateSearchBar::updateIncInitCursor);
+
+        indicateMatch(MatchNothing);
+        return;
+    }
+
+    // a match of the extended pattern is a match of the previous one,
+    // continue where the search for the previous pattern stopped
+    const SearchOptions options = searchOptions();
+    const qint64 revision = m_view->doc()->revision();
+    const bool refine = !m_incSearch.pattern.isEmpty() && pattern.startsWith(m_incSearch.pattern) && options == m_incSearch.options
+        && revision == m_incSearch.revision && m_incInitCursor == m_incSearch.initCursor;
+    if (!refine) {
+        m_incSearch.options = options;
+        m_incSearch.initCursor = m_incInitCursor;
+        m_incSearch.revision = revision;
+        m_incSearch.pass = IncrementalSearch::FromInitCursor;
+        m_incSearch.cursor = m_incInitCursor;
     }
+    m_incSearch.pattern = pattern;
 
-    const bool wrap = !match.isValid() && !pattern.isEmpty();
+    continueIncrementalSearch();
+}
 
-    if (wrap) {
-        // Find, second try
-        const KTextEditor::Range inputRange = m_view->document()->documentRange();
-        match.searchText(inputRange, pattern);
+void KateSearchBar::continueIncrementalSearch()
+{
+    if (!m_incUi || m_incSearch.pattern.isEmpty()) {
+        return;
     }
 
-    const MatchResult matchResult = match.isValid() ? (wrap ? MatchWrappedForward : MatchFound) : pattern.isEmpty() ? MatchNothing : MatchMismatch;
+    KTextEditor::DocumentPrivate *const doc = m_view->doc();
+
+    // the document changed while searching, start again
+    if (doc->revision() != m_incSearch.revision) {
+        m_incSearch.initCursor = m_incInitCursor;
+        m_incSearch.revision = doc->revision();
+        m_incSearch.pass = IncrementalSearch::FromInitCursor;
+        m_incSearch.cursor = m_incInitCursor;
+    }
 
-    const Range selectionRange = pattern.isEmpty() ? Range(m_incInitCursor, m_incInitCursor) : match.isValid() ? match.range() : Range::invalid();
+    // matches of patterns without line break don't span lines, the search can be split at line ends
+    const int linesPerSlice = m_incSearch.pattern.contains(QLatin1Char('\n')) ? doc->lines() : 10000;
+    const qint64 maxSliceTime = 20;
+    QElapsedTimer sliceTime;
+    sliceTime.start();
+
+    KateMatch match(doc, m_incSearch.options);
+    while (m_incSearch.pass != IncrementalSearch::Done) {
+        // Find, first try from the init cursor, second try wrapped from the document start
+        const Cursor documentEnd = doc->documentEnd();
+        const int lastLine = qMin(documentEnd.line(), m_incSearch.cursor.line() + linesPerSlice - 1);
+        match.searchText(Range(m_incSearch.cursor, Cursor(lastLine, doc->lineLength(lastLine))), m_incSearch.pattern);
+        if (match.isValid()) {
+            break;
+        }
+
+        if (lastLine < documentEnd.line()) {
+            m_incSearch.cursor = Cursor(lastLine + 1, 0);
+        } else if (m_incSearch.pass == IncrementalSearch::FromInitCursor) {
+            m_incSearch.pass = IncrementalSearch::Wrapped;
+            m_incSearch.cursor = Cursor(0, 0);
+        } else {
+            m_incSearch.pass = IncrementalSearch::Done;
+        }
+
+        // let the user continue typing, search the remaining lines later
+        if (m_incSearch.pass != IncrementalSearch::Done && sliceTime.elapsed() > maxSliceTime) {
+            indicateMatch(MatchNeutral);
+            m_incSearchTimer.start();
+            return;
+        }
+    }
+
+    MatchResult matchResult = MatchMismatch;
+    if (match.isValid()) {
+        // a search for an extended pattern continues at the match
+        m_incSearch.cursor = match.range().start();
+        matchResult = (m_incSearch.pass == IncrementalSearch::Wrapped) ? MatchWrappedForward : MatchFound;
+    }
 
     // don't update m_incInitCursor when we move the cursor
     disconnect(m_view, &KTextEditor::View::cursorPositionChanged, this, &KateSearchBar::updateIncInitCursor);
-    selectRange2(selectionRange);
+    selectRange2(match.isValid() ? match.range() : Range::invalid());
     connect(m_view, &KTextEditor::View::cursorPositionChanged, this, &KateSearchBar::updateIncInitCursor);
 
     indicateMatch(matchResult);
@@ -1366,9 +1439,10 @@ void KateSearchBar::enterPowerMode()
             const bool OF_INCREMENTAL = false;
             backupConfig(OF_INCREMENTAL);
 
-            // Kill widget
+            // Kill widget, cancel a running search
             delete m_incUi;
             m_incUi = nullptr;
+            m_incSearchTimer.stop();
             m_layout->removeWidget(m_widget);
             m_widget->deleteLater(); // I didn't get a crash here but for symmetrie to the other mutate slot^
         }
@@ -14,6 +14,8 @@
 #include <ktexteditor/attribute.h>
 #include <ktexteditor/document.h>
 
+#include <QTimer>
+
 namespace KTextEditor
 {
 class ViewPrivate;
@@ -113,6 +115,13 @@ protected:
 
 private Q_SLOTS:
     void onIncPatternChanged(const QString &pattern);
+
+    /**
+     * Search the next lines for the incremental search pattern, until a match
+     * is found or the time slice is used up. In the latter case, the search
+     * continues after the pending events got processed.
+     */
+    void continueIncrementalSearch();
     void onMatchCaseToggled(bool matchCase);
 
     void onReturnPressed();
@@ -216,6 +225,24 @@ private:
     Ui::IncrementalSearchBar *m_incUi;
     KTextEditor::Cursor m_incInitCursor;
 
+    /**
+     * State of the last incremental search. There is no match of the pattern
+     * between the start of the current pass and the cursor, an extended
+     * pattern can continue the search at the cursor.
+     */
+    struct IncrementalSearch {
+        enum Pass { FromInitCursor, Wrapped, Done };
+
+        QString pattern;
+        KTextEditor::SearchOptions options;
+        KTextEditor::Cursor initCursor = KTextEditor::Cursor::invalid();
+        qint64 revision = -1;
+        Pass pass = Done;
+        KTextEditor::Cursor cursor = KTextEditor::Cursor::invalid();
+    };
+    IncrementalSearch m_incSearch;
+    QTimer m_incSearchTimer;
+
     // Power search related
     Ui::PowerSearchBar *m_powerUi = nullptr;
     KTextEditor::MovingRange *m_workingRange = nullptr;
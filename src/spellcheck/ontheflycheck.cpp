@@ -7,6 +7,7 @@
 #include "ontheflycheck.h"
 
 #include <QRegularExpression>
+#include <QTextBoundaryFinder>
 #include <QTimer>
 
 #include "katebuffer.h"
@@ -14,6 +15,7 @@
 #include "kateglobal.h"
 #include "katepartdebug.h"
 #include "katerenderer.h"
+#include "katetextrange.h"
 #include "kateview.h"
 #include "spellcheck.h"
 #include "spellingmenu.h"
@@ -28,6 +30,33 @@ inline const QPair<KTextEditor::MovingRange *, QString> &invalidSpellCheckQueueI
     return item;
 }
 
+/**
+ * Split the text into the words Sonnet would check, i.e. the ones starting with a letter.
+ **/
+QList<QPair<int, QString>> spellCheckableWords(const QString &text)
+{
+    QList<QPair<int, QString>> words;
+    QTextBoundaryFinder finder(QTextBoundaryFinder::Word, text);
+    int start = 0;
+    while (finder.toNextBoundary() != -1) {
+        const int end = finder.position();
+        if ((finder.boundaryReasons() & QTextBoundaryFinder::EndOfItem) && text.at(start).isLetter()) {
+            words.push_back(qMakePair(start, text.mid(start, end - start)));
+        }
+        start = end;
+    }
+    return words;
+}
+
+/**
+ * Sonnet skips words in URLs and mail addresses, so what it reports for such text
+ * doesn't hold for the words in general.
+ **/
+bool mayContainAddress(const QString &text)
+{
+    return text.contains(QLatin1Char('@')) || text.contains(QLatin1String("://")) || text.contains(QLatin1String("www."));
+}
+
 }
 
 KateOnTheFlyChecker::KateOnTheFlyChecker(KTextEditor::DocumentPrivate *document)
@@ -45,6 +74,10 @@ KateOnTheFlyChecker::KateOnTheFlyChecker(KTextEditor::DocumentPrivate *document)
 
     connect(document, &KTextEditor::DocumentPrivate::textInsertedRange, this, &KateOnTheFlyChecker::textInserted);
     connect(document, &KTextEditor::DocumentPrivate::textRemoved, this, &KateOnTheFlyChecker::textRemoved);
+    connect(document, &KTextEditor::DocumentPrivate::textReplayed, this, [this](KTextEditor::Document *, KTextEditor::LineRange lineRange) {
+        // recheck the changed lines as if they had been inserted
+        textInserted(m_document, KTextEditor::Range(lineRange.start(), 0, lineRange.end(), m_document->lineLength(lineRange.end())));
+    });
     connect(document, &KTextEditor::DocumentPrivate::viewCreated, this, &KateOnTheFlyChecker::addView);
     connect(document, &KTextEditor::DocumentPrivate::highlightingModeChanged, this, &KateOnTheFlyChecker::updateConfig);
     connect(&document->buffer(), &KateBuffer::respellCheckBlock, this, &KateOnTheFlyChecker::handleRespellCheckBlock);
@@ -68,12 +101,30 @@ KateOnTheFlyChecker::~KateOnTheFlyChecker()
     freeDocument();
 }
 
+KateOnTheFlyChecker::MovingRangeList KateOnTheFlyChecker::misspelledRangesForLine(int line) const
+{
+    MovingRangeList misspelledRanges;
+    const auto views = m_document->views();
+    if (line < 0 || line >= m_document->lines() || views.isEmpty()) {
+        return misspelledRanges;
+    }
+
+    // the buffer knows the ranges of each line, the misspelled ones have an attribute for all views
+    const auto ranges = m_document->buffer().rangesForLine(line, views.first(), true);
+    for (Kate::TextRange *range : ranges) {
+        if (m_misspelledList.contains(range)) {
+            misspelledRanges.push_back(range);
+        }
+    }
+    return misspelledRanges;
+}
+
 QPair<KTextEditor::Range, QString> KateOnTheFlyChecker::getMisspelledItem(const KTextEditor::Cursor cursor) const
 {
-    for (const MisspelledItem &item : m_misspelledList) {
-        KTextEditor::MovingRange *movingRange = item.first;
+    const MovingRangeList misspelledRanges = misspelledRangesForLine(cursor.line());
+    for (KTextEditor::MovingRange *movingRange : misspelledRanges) {
         if (movingRange->contains(cursor)) {
-            return QPair<KTextEditor::Range, QString>(*movingRange, item.second);
+            return QPair<KTextEditor::Range, QString>(*movingRange, m_misspelledList.value(movingRange));
         }
     }
     return QPair<KTextEditor::Range, QString>(KTextEditor::Range::invalid(), QString());
@@ -81,10 +132,10 @@ QPair<KTextEditor::Range, QString> KateOnTheFlyChecker::getMisspelledItem(const
 
 QString KateOnTheFlyChecker::dictionaryForMisspelledRange(KTextEditor::Range range) const
 {
-    for (const MisspelledItem &item : m_misspelledList) {
-        KTextEditor::MovingRange *movingRange = item.first;
+    const MovingRangeList misspelledRanges = misspelledRangesForLine(range.start().line());
+    for (KTextEditor::MovingRange *movingRange : misspelledRanges) {
         if (*movingRange == range) {
-            return item.second;
+            return m_misspelledList.value(movingRange);
         }
     }
     return QString();
@@ -92,9 +143,8 @@ QString KateOnTheFlyChecker::dictionaryForMisspelledRange(KTextEditor::Range ran
 
 void KateOnTheFlyChecker::clearMisspellingForWord(const QString &word)
 {
-    const MisspelledList misspelledList = m_misspelledList; // make a copy
-    for (const MisspelledItem &item : misspelledList) {
-        KTextEditor::MovingRange *movingRange = item.first;
+    const MovingRangeList misspelledList = m_misspelledList.keys(); // make a copy
+    for (KTextEditor::MovingRange *movingRange : misspelledList) {
         if (m_document->text(*movingRange) == word) {
             deleteMovingRange(movingRange);
         }
@@ -331,9 +381,9 @@ void KateOnTheFlyChecker::freeDocument()
     }
     stopCurrentSpellCheck();
 
-    const MisspelledList misspelledList = m_misspelledList; // make a copy!
-    for (const MisspelledItem &i : misspelledList) {
-        deleteMovingRange(i.first);
+    const MovingRangeList misspelledList = m_misspelledList.keys(); // make a copy!
+    for (KTextEditor::MovingRange *movingRange : misspelledList) {
+        deleteMovingRange(movingRange);
     }
     m_misspelledList.clear();
     clearModificationList();
@@ -367,6 +417,18 @@ void KateOnTheFlyChecker::performSpellCheck()
         spellCheckDone(); // (bug 225867)
         return;
     }
+
+    // if all the words of the range have been checked before, there is no need to ask Sonnet
+    m_currentWordsCacheable = !mayContainAddress(text);
+    if (m_currentWordsCacheable) {
+        m_currentWords = spellCheckableWords(text);
+        if (applyCachedVerdicts(language)) {
+            m_currentWordsCacheable = false; // nothing new to learn
+            spellCheckDone();
+            return;
+        }
+    }
+
     if (m_speller.language() != language) {
         m_speller.setLanguage(language);
     }
@@ -402,23 +464,17 @@ void KateOnTheFlyChecker::removeRangeFromEverything(KTextEditor::MovingRange *mo
     Q_ASSERT(m_document == movingRange->document());
     ON_THE_FLY_DEBUG << *movingRange << "(" << movingRange << ")";
 
+    // a misspelled range is in no queue, no need to search them
+    if (m_misspelledList.remove(movingRange)) {
+        return;
+    }
+
     if (removeRangeFromModificationList(movingRange)) {
         return; // range was part of the modification queue, so we don't have
         // to look further for it
     }
 
-    if (removeRangeFromSpellCheckQueue(movingRange)) {
-        return; // range was part of the spell check queue, so it cannot have been
-        // a misspelled range
-    }
-
-    for (MisspelledList::iterator i = m_misspelledList.begin(); i != m_misspelledList.end();) {
-        if ((*i).first == movingRange) {
-            i = m_misspelledList.erase(i);
-        } else {
-            ++i;
-        }
-    }
+    removeRangeFromSpellCheckQueue(movingRange);
 }
 
 bool KateOnTheFlyChecker::removeRangeFromCurrentSpellCheck(KTextEditor::MovingRange *range)
@@ -433,6 +489,9 @@ bool KateOnTheFlyChecker::removeRangeFromCurrentSpellCheck(KTextEditor::MovingRa
 void KateOnTheFlyChecker::stopCurrentSpellCheck()
 {
     m_currentDecToEncOffsetList.clear();
+    m_currentWords.clear();
+    m_currentMisspellings.clear();
+    m_currentWordsCacheable = false;
     m_currentlyCheckedItem = invalidSpellCheckQueueItem();
     if (m_backgroundChecker) {
         m_backgroundChecker->stop();
@@ -563,6 +622,16 @@ void KateOnTheFlyChecker::misspelling(const QString &word, int start)
         ON_THE_FLY_DEBUG << "exited as no spell check is taking place";
         return;
     }
+    m_currentMisspellings.push_back(qMakePair(start, word));
+    addMisspelling(word, start);
+
+    if (m_backgroundChecker) {
+        m_backgroundChecker->continueChecking();
+    }
+}
+
+void KateOnTheFlyChecker::addMisspelling(const QString &word, int start)
+{
     int translatedStart = m_document->computePositionWrtOffsets(m_currentDecToEncOffsetList, start);
     //   ON_THE_FLY_DEBUG << "misspelled " << word
     //                                     << " at line "
@@ -585,10 +654,63 @@ void KateOnTheFlyChecker::misspelling(const QString &word, int start)
     movingRange->setAttributeOnlyForViews(true);
 
     movingRange->setAttribute(KTextEditor::Attribute::Ptr(attribute));
-    m_misspelledList.push_back(MisspelledItem(movingRange, m_currentlyCheckedItem.second));
+    m_misspelledList.insert(movingRange, m_currentlyCheckedItem.second);
+}
 
-    if (m_backgroundChecker) {
-        m_backgroundChecker->continueChecking();
+bool KateOnTheFlyChecker::applyCachedVerdicts(const QString &dictionary)
+{
+    const KateSpellCheckManager *spellCheckManager = KTextEditor::EditorPrivate::self()->spellCheckManager();
+    QList<int> misspelled;
+    for (int i = 0; i < m_currentWords.size(); ++i) {
+        bool isMisspelled = false;
+        if (!spellCheckManager->cachedVerdict(m_currentWords[i].second, dictionary, isMisspelled)) {
+            return false;
+        }
+        if (isMisspelled) {
+            misspelled.push_back(i);
+        }
+    }
+
+    ON_THE_FLY_DEBUG << "all" << m_currentWords.size() << "words known";
+    for (int i : misspelled) {
+        addMisspelling(m_currentWords[i].second, m_currentWords[i].first);
+    }
+    return true;
+}
+
+void KateOnTheFlyChecker::cacheVerdicts(const QString &dictionary)
+{
+    // learn from Sonnet's result only if every reported word is one of ours, otherwise
+    // it split the text differently and we don't know what it thinks of our words
+    QHash<int, QString> reported;
+    for (const auto &misspelling : std::as_const(m_currentMisspellings)) {
+        reported.insert(misspelling.first, misspelling.second);
+    }
+    QHash<QString, bool> verdicts;
+    QSet<QString> ambiguous;
+    int matched = 0;
+    for (const auto &word : std::as_const(m_currentWords)) {
+        const auto it = reported.constFind(word.first);
+        const bool misspelled = it != reported.cend() && *it == word.second;
+        if (misspelled) {
+            ++matched;
+        }
+        const auto verdict = verdicts.constFind(word.second);
+        if (verdict != verdicts.cend() && *verdict != misspelled) {
+            ambiguous.insert(word.second);
+        } else {
+            verdicts.insert(word.second, misspelled);
+        }
+    }
+    if (matched != m_currentMisspellings.size()) {
+        return;
+    }
+
+    KateSpellCheckManager *spellCheckManager = KTextEditor::EditorPrivate::self()->spellCheckManager();
+    for (auto it = verdicts.cbegin(); it != verdicts.cend(); ++it) {
+        if (!ambiguous.contains(it.key())) {
+            spellCheckManager->cacheVerdict(it.key(), dictionary, it.value());
+        }
     }
 }
 
@@ -599,6 +721,9 @@ void KateOnTheFlyChecker::spellCheckDone()
         return;
     }
     KTextEditor::MovingRange *movingRange = m_currentlyCheckedItem.first;
+    if (m_currentWordsCacheable) {
+        cacheVerdicts(m_currentlyCheckedItem.second);
+    }
     stopCurrentSpellCheck();
     deleteMovingRangeQuickly(movingRange);
 
@@ -612,8 +737,8 @@ QList<KTextEditor::MovingRange *> KateOnTheFlyChecker::installedMovingRanges(KTe
     ON_THE_FLY_DEBUG << range;
     MovingRangeList toReturn;
 
-    for (QList<SpellCheckItem>::const_iterator i = m_misspelledList.begin(); i != m_misspelledList.end(); ++i) {
-        KTextEditor::MovingRange *movingRange = (*i).first;
+    for (auto it = m_misspelledList.cbegin(); it != m_misspelledList.cend(); ++it) {
+        KTextEditor::MovingRange *movingRange = it.key();
         if (movingRange->overlaps(range)) {
             toReturn.push_back(movingRange);
         }
@@ -671,8 +796,8 @@ void KateOnTheFlyChecker::updateInstalledMovingRanges(KTextEditor::ViewPrivate *
     ON_THE_FLY_DEBUG << "new range: " << newDisplayRange;
     ON_THE_FLY_DEBUG << "old range: " << oldDisplayRange;
     QList<KTextEditor::MovingRange *> toDelete;
-    for (const MisspelledItem &item : std::as_const(m_misspelledList)) {
-        KTextEditor::MovingRange *movingRange = item.first;
+    for (auto it = m_misspelledList.cbegin(); it != m_misspelledList.cend(); ++it) {
+        KTextEditor::MovingRange *movingRange = it.key();
         if (!movingRange->overlaps(newDisplayRange)) {
             bool stillVisible = false;
             const auto views = m_document->views();
@@ -8,6 +8,7 @@
 #ifndef ONTHEFLYCHECK_H
 #define ONTHEFLYCHECK_H
 
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QObject>
@@ -30,8 +31,8 @@ class KateOnTheFlyChecker : public QObject, private KTextEditor::MovingRangeFeed
 
     typedef QPair<KTextEditor::MovingRange *, QString> SpellCheckItem;
     typedef QList<KTextEditor::MovingRange *> MovingRangeList;
-    typedef QPair<KTextEditor::MovingRange *, QString> MisspelledItem;
-    typedef QList<MisspelledItem> MisspelledList;
+    typedef QHash<KTextEditor::MovingRange *, QString> MisspelledList;
+    typedef QList<QPair<int, QString>> WordList;
 
     typedef QPair<ModificationType, KTextEditor::MovingRange *> ModificationItem;
     typedef QList<ModificationItem> ModificationList;
@@ -62,12 +63,26 @@ protected:
     Sonnet::BackgroundChecker *m_backgroundChecker;
     SpellCheckItem m_currentlyCheckedItem;
     MisspelledList m_misspelledList;
+    /**
+     * The words of the range that is currently checked and what Sonnet reported
+     * for it so far, both as (offset, word) in the decoded text, used for the
+     * shared verdict cache of the spell check manager.
+     **/
+    WordList m_currentWords;
+    WordList m_currentMisspellings;
+    bool m_currentWordsCacheable = false;
     ModificationList m_modificationList;
     KTextEditor::DocumentPrivate::OffsetList m_currentDecToEncOffsetList;
     QMap<KTextEditor::View *, KTextEditor::Range> m_displayRangeMap;
 
     void freeDocument();
 
+    /**
+     * The misspelled ranges on @p line, looked up in the ranges the buffer keeps per line.
+     * Misspellings are only installed for the visible lines, so there are none without a view.
+     **/
+    MovingRangeList misspelledRangesForLine(int line) const;
+
     void queueLineSpellCheck(KTextEditor::DocumentPrivate *document, int line);
     /**
      * 'range' must be on a single line
@@ -102,8 +117,12 @@ protected:
     void addToDictionary(const QString &word);
     void addToSession(const QString &word);
     void misspelling(const QString &word, int start);
+    void addMisspelling(const QString &word, int start);
     void spellCheckDone();
 
+    bool applyCachedVerdicts(const QString &dictionary);
+    void cacheVerdicts(const QString &dictionary);
+
     void viewDestroyed(QObject *obj);
     void addView(KTextEditor::Document *document, KTextEditor::View *view);
     void removeView(KTextEditor::View *view);
@@ -35,6 +35,7 @@ void KateSpellCheckManager::ignoreWord(const QString &word, const QString &dicti
     Sonnet::Speller speller;
     speller.setLanguage(dictionary);
     speller.addToSession(word);
+    forgetVerdict(word);
     Q_EMIT wordIgnored(word);
 }
 
@@ -43,9 +44,48 @@ void KateSpellCheckManager::addToDictionary(const QString &word, const QString &
     Sonnet::Speller speller;
     speller.setLanguage(dictionary);
     speller.addToPersonal(word);
+    forgetVerdict(word);
     Q_EMIT wordAddedToDictionary(word);
 }
 
+bool KateSpellCheckManager::cachedVerdict(const QString &word, const QString &dictionary, bool &misspelled) const
+{
+    const auto verdicts = m_verdictCache.constFind(dictionary);
+    if (verdicts == m_verdictCache.cend()) {
+        return false;
+    }
+    const auto verdict = verdicts->constFind(word);
+    if (verdict == verdicts->cend()) {
+        return false;
+    }
+    misspelled = *verdict;
+    return true;
+}
+
+void KateSpellCheckManager::cacheVerdict(const QString &word, const QString &dictionary, bool misspelled)
+{
+    // bound the memory usage, just start over for huge vocabularies
+    static constexpr int maxCachedWords = 200000;
+    auto &verdicts = m_verdictCache[dictionary];
+    if (verdicts.size() >= maxCachedWords) {
+        verdicts.clear();
+    }
+    verdicts.insert(word, misspelled);
+}
+
+void KateSpellCheckManager::forgetVerdict(const QString &word)
+{
+    // the session and personal word lists are not strictly per dictionary, drop the word everywhere
+    for (auto &verdicts : m_verdictCache) {
+        verdicts.remove(word);
+    }
+}
+
+void KateSpellCheckManager::clearVerdicts()
+{
+    m_verdictCache.clear();
+}
+
 QList<KTextEditor::Range> KateSpellCheckManager::rangeDifference(KTextEditor::Range r1, KTextEditor::Range r2)
 {
     Q_ASSERT(r1.contains(r2));
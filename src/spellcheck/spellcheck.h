@@ -7,12 +7,14 @@
 #ifndef SPELLCHECK_H
 #define SPELLCHECK_H
 
+#include <QHash>
 #include <QList>
 #include <QObject>
 #include <QPair>
 #include <QString>
 
 #include <ktexteditor/document.h>
+#include <ktexteditor_export.h>
 #include <sonnet/backgroundchecker.h>
 #include <sonnet/speller.h>
 
@@ -21,7 +23,7 @@ namespace KTextEditor
 class DocumentPrivate;
 }
 
-class KateSpellCheckManager : public QObject
+class KTEXTEDITOR_EXPORT KateSpellCheckManager : public QObject
 {
     Q_OBJECT
 
@@ -41,6 +43,21 @@ public:
      **/
     static QList<KTextEditor::Range> rangeDifference(KTextEditor::Range r1, KTextEditor::Range r2);
 
+    /**
+     * Cache of the verdicts of the on-the-fly spell checking, shared by all documents.
+     * It only contains what Sonnet reported for a word before, words that are added
+     * to the dictionary or ignored are dropped from it.
+     * @return true if the verdict for @p word is known, it is stored in @p misspelled then
+     **/
+    bool cachedVerdict(const QString &word, const QString &dictionary, bool &misspelled) const;
+    void cacheVerdict(const QString &word, const QString &dictionary, bool misspelled);
+
+    /**
+     * Drop all cached verdicts, needed once the Sonnet settings changed, e.g. the
+     * default language, the ignore list or the personal dictionary.
+     **/
+    void clearVerdicts();
+
 Q_SIGNALS:
     /**
      * These signals are used to propagate the dictionary changes to the
@@ -63,6 +80,13 @@ public:
 
 private:
     static void trimRange(KTextEditor::DocumentPrivate *doc, KTextEditor::Range &r);
+
+    void forgetVerdict(const QString &word);
+
+    /**
+     * dictionary -> (word -> misspelled)
+     **/
+    QHash<QString, QHash<QString, bool>> m_verdictCache;
 };
 
 #endif
@@ -18,6 +18,18 @@
 #include <ktexteditor/cursor.h>
 #include <ktexteditor/view.h>
 
+#include <QAccessible>
+#include <QIODevice>
+
+#include <algorithm>
+#include <array>
+
+/**
+ * Minimal number of items for a group to be replayed by KateUndoGroup::replay().
+ * Smaller groups keep the per edit notifications, e.g. for the vi marks.
+ */
+static constexpr std::size_t minimalReplayItems = 1024;
+
 KateUndoGroup::KateUndoGroup(const KTextEditor::Cursor cursorPosition,
                              KTextEditor::Range selection,
                              const QVector<KTextEditor::ViewPrivate::PlainSecondaryCursor> &secondary)
@@ -47,41 +59,45 @@ void KateUndoGroup::undo(KateUndoManager *manager, KTextEditor::ViewPrivate *vie
         }
     };
 
-    for (auto rit = m_items.rbegin(); rit != m_items.rend(); ++rit) {
-        auto &item = *rit;
-        switch (item.type) {
-        case UndoItem::editInsertText:
-            doc->editRemoveText(item.line, item.col, item.text.size());
-            updateDocLine(item);
-            break;
-        case UndoItem::editRemoveText:
-            doc->editInsertText(item.line, item.col, item.text);
-            updateDocLine(item);
-            break;
-        case UndoItem::editWrapLine:
-            doc->editUnWrapLine(item.line, item.newLine, item.len);
-            updateDocLine(item);
-            break;
-        case UndoItem::editUnWrapLine: {
-            doc->editWrapLine(item.line, item.col, item.removeLine);
-            updateDocLine(item);
-
-            auto next = doc->plainKateTextLine(item.line + 1);
-            next->markAsModified(item.lineModFlags.testFlag(UndoItem::UndoLine2Modified));
-            next->markAsSavedOnDisk(item.lineModFlags.testFlag(UndoItem::UndoLine2Saved));
-        } break;
-        case UndoItem::editInsertLine:
-            doc->editRemoveLine(item.line);
-            break;
-        case UndoItem::editRemoveLine:
-            doc->editInsertLine(item.line, item.text);
-            updateDocLine(item);
-            break;
-        case UndoItem::editMarkLineAutoWrapped:
-            doc->editMarkLineAutoWrapped(item.line, item.autowrapped);
-            break;
-        case UndoItem::editInvalid:
-            break;
+    if (canReplay()) {
+        replay(doc, true);
+    } else {
+        for (auto rit = m_items.rbegin(); rit != m_items.rend(); ++rit) {
+            auto &item = *rit;
+            switch (item.type) {
+            case UndoItem::editInsertText:
+                doc->editRemoveText(item.line, item.col, item.text.size());
+                updateDocLine(item);
+                break;
+            case UndoItem::editRemoveText:
+                doc->editInsertText(item.line, item.col, item.text);
+                updateDocLine(item);
+                break;
+            case UndoItem::editWrapLine:
+                doc->editUnWrapLine(item.line, item.newLine, item.len);
+                updateDocLine(item);
+                break;
+            case UndoItem::editUnWrapLine: {
+                doc->editWrapLine(item.line, item.col, item.removeLine);
+                updateDocLine(item);
+
+                auto next = doc->plainKateTextLine(item.line + 1);
+                next->markAsModified(item.lineModFlags.testFlag(UndoItem::UndoLine2Modified));
+                next->markAsSavedOnDisk(item.lineModFlags.testFlag(UndoItem::UndoLine2Saved));
+            } break;
+            case UndoItem::editInsertLine:
+                doc->editRemoveLine(item.line);
+                break;
+            case UndoItem::editRemoveLine:
+                doc->editInsertLine(item.line, item.text);
+                updateDocLine(item);
+                break;
+            case UndoItem::editMarkLineAutoWrapped:
+                doc->editMarkLineAutoWrapped(item.line, item.autowrapped);
+                break;
+            case UndoItem::editInvalid:
+                break;
+            }
         }
     }
 
@@ -120,43 +136,47 @@ void KateUndoGroup::redo(KateUndoManager *manager, KTextEditor::ViewPrivate *vie
         }
     };
 
-    for (auto &item : m_items) {
-        switch (item.type) {
-        case UndoItem::editInsertText:
-            doc->editInsertText(item.line, item.col, item.text);
-            updateDocLine(item);
-            break;
-        case UndoItem::editRemoveText:
-            doc->editRemoveText(item.line, item.col, item.text.size());
-            updateDocLine(item);
-            break;
-        case UndoItem::editWrapLine: {
-            doc->editWrapLine(item.line, item.col, item.newLine);
-            updateDocLine(item);
-
-            Kate::TextLine next = doc->plainKateTextLine(item.line + 1);
-            Q_ASSERT(next);
-            if (next) {
-                next->markAsModified(item.lineModFlags.testFlag(UndoItem::RedoLine2Modified));
-                next->markAsSavedOnDisk(item.lineModFlags.testFlag(UndoItem::RedoLine2Saved));
+    if (canReplay()) {
+        replay(doc, false);
+    } else {
+        for (auto &item : m_items) {
+            switch (item.type) {
+            case UndoItem::editInsertText:
+                doc->editInsertText(item.line, item.col, item.text);
+                updateDocLine(item);
+                break;
+            case UndoItem::editRemoveText:
+                doc->editRemoveText(item.line, item.col, item.text.size());
+                updateDocLine(item);
+                break;
+            case UndoItem::editWrapLine: {
+                doc->editWrapLine(item.line, item.col, item.newLine);
+                updateDocLine(item);
+
+                Kate::TextLine next = doc->plainKateTextLine(item.line + 1);
+                Q_ASSERT(next);
+                if (next) {
+                    next->markAsModified(item.lineModFlags.testFlag(UndoItem::RedoLine2Modified));
+                    next->markAsSavedOnDisk(item.lineModFlags.testFlag(UndoItem::RedoLine2Saved));
+                }
+            } break;
+            case UndoItem::editUnWrapLine:
+                doc->editUnWrapLine(item.line, item.removeLine, item.len);
+                updateDocLine(item);
+                break;
+            case UndoItem::editInsertLine:
+                doc->editInsertLine(item.line, item.text);
+                updateDocLine(item);
+                break;
+            case UndoItem::editRemoveLine:
+                doc->editRemoveLine(item.line);
+                break;
+            case UndoItem::editMarkLineAutoWrapped:
+                doc->editMarkLineAutoWrapped(item.line, item.autowrapped);
+                break;
+            case UndoItem::editInvalid:
+                break;
             }
-        } break;
-        case UndoItem::editUnWrapLine:
-            doc->editUnWrapLine(item.line, item.removeLine, item.len);
-            updateDocLine(item);
-            break;
-        case UndoItem::editInsertLine:
-            doc->editInsertLine(item.line, item.text);
-            updateDocLine(item);
-            break;
-        case UndoItem::editRemoveLine:
-            doc->editRemoveLine(item.line);
-            break;
-        case UndoItem::editMarkLineAutoWrapped:
-            doc->editMarkLineAutoWrapped(item.line, item.autowrapped);
-            break;
-        case UndoItem::editInvalid:
-            break;
         }
     }
 
@@ -177,6 +197,58 @@ void KateUndoGroup::redo(KateUndoManager *manager, KTextEditor::ViewPrivate *vie
     manager->endUndo();
 }
 
+bool KateUndoGroup::canReplay() const
+{
+#ifndef QT_NO_ACCESSIBILITY
+    // screen readers need the text of each single change
+    if (QAccessible::isActive()) {
+        return false;
+    }
+#endif
+
+    return m_items.size() >= minimalReplayItems && std::all_of(m_items.begin(), m_items.end(), [](const UndoItem &item) {
+               return item.type == UndoItem::editInsertText || item.type == UndoItem::editRemoveText;
+           });
+}
+
+void KateUndoGroup::replay(KTextEditor::DocumentPrivate *doc, bool undo)
+{
+    int firstLine = doc->lines();
+    int lastLine = -1;
+    auto replayItem = [doc, &firstLine, &lastLine](const UndoItem &item, bool insert, bool modified, bool saved) {
+        if (insert) {
+            doc->replayInsertText(item.line, item.col, item.text);
+        } else {
+            doc->replayRemoveText(item.line, item.col, item.text);
+        }
+
+        Kate::TextLine tl = doc->plainKateTextLine(item.line);
+        tl->markAsModified(modified);
+        tl->markAsSavedOnDisk(saved);
+
+        firstLine = std::min(firstLine, item.line);
+        lastLine = std::max(lastLine, item.line);
+    };
+
+    if (undo) {
+        for (auto rit = m_items.rbegin(); rit != m_items.rend(); ++rit) {
+            replayItem(*rit,
+                       rit->type == UndoItem::editRemoveText,
+                       rit->lineModFlags.testFlag(UndoItem::UndoLine1Modified),
+                       rit->lineModFlags.testFlag(UndoItem::UndoLine1Saved));
+        }
+    } else {
+        for (const auto &item : m_items) {
+            replayItem(item,
+                       item.type == UndoItem::editInsertText,
+                       item.lineModFlags.testFlag(UndoItem::RedoLine1Modified),
+                       item.lineModFlags.testFlag(UndoItem::RedoLine1Saved));
+        }
+    }
+
+    Q_EMIT doc->textReplayed(doc, KTextEditor::LineRange(firstLine, lastLine));
+}
+
 void KateUndoGroup::editEnd(const KTextEditor::Cursor cursorPosition,
                             KTextEditor::Range selectionRange,
                             const QVector<KTextEditor::ViewPrivate::PlainSecondaryCursor> &secondaryCursors)
@@ -193,11 +265,18 @@ static bool mergeUndoItems(UndoItem &base, const UndoItem &u)
     }
 
     if (base.type == UndoItem::editRemoveText) {
+        // backspace
         if (base.line == u.line && base.col == (u.col + u.text.size())) {
             base.text.prepend(u.text);
             base.col = u.col;
             return true;
         }
+
+        // delete
+        if (base.line == u.line && base.col == u.col) {
+            base.text += u.text;
+            return true;
+        }
     }
 
     if (base.type == UndoItem::editInsertText) {
@@ -210,6 +289,44 @@ static bool mergeUndoItems(UndoItem &base, const UndoItem &u)
     return false;
 }
 
+/**
+ * Single ASCII characters are by far the most common text of new items, share one
+ * string per character instead of allocating one for each item.
+ */
+static QString compactText(const QString &text)
+{
+    if (text.size() == 1 && text.at(0).unicode() < 128) {
+        static const auto asciiStrings = [] {
+            std::array<QString, 128> strings;
+            for (size_t i = 0; i < strings.size(); ++i) {
+                strings[i] = QString(QChar(char16_t(i)));
+            }
+            return strings;
+        }();
+        return asciiStrings[text.at(0).unicode()];
+    }
+    return text;
+}
+
+/**
+ * Text removed right at the end of the text inserted before, e.g. typing and backspace,
+ * just shortens the insertion.
+ */
+static bool compactUndoItems(UndoItem &base, const UndoItem &u)
+{
+    if (base.type != UndoItem::editInsertText || u.type != UndoItem::editRemoveText || base.line != u.line) {
+        return false;
+    }
+
+    if (u.col < base.col || (u.col + u.text.size()) != (base.col + base.text.size()) || !base.text.endsWith(u.text)) {
+        return false;
+    }
+
+    // keep the item even if it is empty now, undo still restores the line modification flags
+    base.text.chop(u.text.size());
+    return true;
+}
+
 void KateUndoGroup::addItem(UndoItem u)
 {
     // try to merge, do that only for equal types, inside mergeWith we do hard casts
@@ -217,7 +334,12 @@ void KateUndoGroup::addItem(UndoItem u)
         return;
     }
 
+    if (!m_items.empty() && compactUndoItems(m_items.back(), u)) {
+        return;
+    }
+
     // default: just add new item unchanged
+    u.text = compactText(u.text);
     m_items.push_back(std::move(u));
 }
 
@@ -251,9 +373,103 @@ bool KateUndoGroup::merge(KateUndoGroup *newGroup, bool complex)
 
 void KateUndoGroup::safePoint(bool safePoint)
 {
+    // nothing will be merged into the last item anymore, give back the room reserved for that
+    if (safePoint && !m_safePoint && !m_items.empty()) {
+        QString &text = m_items.back().text;
+        if (text.isDetached() && text.capacity() > text.size()) {
+            text.squeeze();
+        }
+    }
+
     m_safePoint = safePoint;
 }
 
+static bool hasText(const UndoItem &item)
+{
+    switch (item.type) {
+    case UndoItem::editInsertText:
+    case UndoItem::editRemoveText:
+    case UndoItem::editInsertLine:
+    case UndoItem::editRemoveLine:
+        return true;
+    default:
+        return false;
+    }
+}
+
+qsizetype KateUndoGroup::memoryUsage() const
+{
+    qsizetype usage = sizeof(KateUndoGroup) + qsizetype(m_items.capacity() * sizeof(UndoItem));
+    usage += (m_undoSecondaryCursors.capacity() + m_redoSecondaryCursors.capacity()) * qsizetype(sizeof(KTextEditor::ViewPrivate::PlainSecondaryCursor));
+    for (const UndoItem &item : m_items) {
+        usage += item.text.capacity() * qsizetype(sizeof(QChar));
+    }
+    return usage;
+}
+
+qsizetype KateUndoGroup::spill(QIODevice &file)
+{
+    Q_ASSERT(!isSpilled());
+
+    // append the text of all items, the length is kept in the otherwise unused len of the items
+    const qint64 offset = file.size();
+    if (!file.seek(offset)) {
+        return -1;
+    }
+    for (const UndoItem &item : m_items) {
+        if (hasText(item)) {
+            const qint64 bytes = item.text.size() * qint64(sizeof(QChar));
+            if (file.write(reinterpret_cast<const char *>(item.text.constData()), bytes) != bytes) {
+                return -1;
+            }
+        }
+    }
+
+    // everything is on disk, drop the text
+    qsizetype freed = 0;
+    for (UndoItem &item : m_items) {
+        if (hasText(item)) {
+            freed += item.text.capacity() * qsizetype(sizeof(QChar));
+            item.len = item.text.size();
+            item.text = QString();
+        }
+    }
+    m_spillOffset = offset;
+    return freed;
+}
+
+bool KateUndoGroup::restore(QIODevice &file)
+{
+    Q_ASSERT(isSpilled());
+
+    if (!file.seek(m_spillOffset)) {
+        return false;
+    }
+
+    // read all text first, the group stays untouched on errors
+    std::vector<QString> texts;
+    for (const UndoItem &item : m_items) {
+        if (hasText(item)) {
+            QString text(item.len, Qt::Uninitialized);
+            const qint64 bytes = item.len * qint64(sizeof(QChar));
+            if (file.read(reinterpret_cast<char *>(text.data()), bytes) != bytes) {
+                return false;
+            }
+            texts.push_back(std::move(text));
+        }
+    }
+
+    auto text = texts.begin();
+    for (UndoItem &item : m_items) {
+        if (hasText(item)) {
+            item.text = std::move(*text++);
+            item.len = 0;
+        }
+    }
+    m_spillOffset = -1;
+    return true;
+}
+
 void KateUndoGroup::flagSavedAsModified()
 {
     for (UndoItem &item : m_items) {
@@ -279,17 +495,45 @@ void KateUndoGroup::flagSavedAsModified()
     }
 }
 
-static void updateUndoSavedOnDiskFlag(UndoItem &item, QBitArray &lines)
+void KateUndoGroup::appendLines(std::vector<int> &lines, bool undo) const
 {
-    const int line = item.line;
-    if (line >= lines.size()) {
-        lines.resize(line + 1);
+    for (const UndoItem &item : m_items) {
+        lines.push_back(item.line);
+
+        // see updateUndoSavedOnDiskFlag(), the item marks the line after it if it has a flag for it at all
+        if (undo && item.type == UndoItem::editUnWrapLine
+            && (item.lineModFlags.testFlag(UndoItem::UndoLine2Modified) || item.lineModFlags.testFlag(UndoItem::UndoLine2Saved))) {
+            lines.push_back(item.line + 1);
+        }
     }
+}
 
-    const bool wasBitSet = lines.testBit(line);
-    if (!wasBitSet) {
-        lines.setBit(line);
+std::vector<int> KateUndoGroup::dependentLines() const
+{
+    std::vector<int> lines;
+    lines.reserve(m_items.size() * 2);
+    for (const UndoItem &item : m_items) {
+        lines.push_back(item.line);
+        lines.push_back(item.line + 1);
     }
+    std::sort(lines.begin(), lines.end());
+    lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
+    return lines;
+}
+
+static std::vector<bool>::reference seenLine(const std::vector<int> &lines, std::vector<bool> &seen, int line)
+{
+    const auto it = std::lower_bound(lines.begin(), lines.end(), line);
+    Q_ASSERT(it != lines.end() && *it == line);
+    return seen[it - lines.begin()];
+}
+
+static void updateUndoSavedOnDiskFlag(UndoItem &item, const std::vector<int> &lines, std::vector<bool> &seen)
+{
+    const int line = item.line;
+    auto lineSeen = seenLine(lines, seen, line);
+    const bool wasBitSet = lineSeen;
+    lineSeen = true;
 
     auto &lineFlags = item.lineModFlags;
 
@@ -309,16 +553,14 @@ static void updateUndoSavedOnDiskFlag(UndoItem &item, QBitArray &lines)
         }
         break;
     case UndoItem::editUnWrapLine:
-        if (line + 1 >= lines.size()) {
-            lines.resize(line + 2);
-        }
         if (lineFlags.testFlag(UndoItem::UndoLine1Modified) && !wasBitSet) {
             lineFlags.setFlag(UndoItem::UndoLine1Modified, false);
             lineFlags.setFlag(UndoItem::UndoLine1Saved, true);
         }
 
-        if (lineFlags.testFlag(UndoItem::UndoLine2Modified) && !lines.testBit(line + 1)) {
-            lines.setBit(line + 1);
+        auto nextLineSeen = seenLine(lines, seen, line + 1);
+        if (lineFlags.testFlag(UndoItem::UndoLine2Modified) && !nextLineSeen) {
+            nextLineSeen = true;
 
             lineFlags.setFlag(UndoItem::UndoLine2Modified, false);
             lineFlags.setFlag(UndoItem::UndoLine2Saved, true);
@@ -331,24 +573,19 @@ static void updateUndoSavedOnDiskFlag(UndoItem &item, QBitArray &lines)
     }
 }
 
-void KateUndoGroup::markUndoAsSaved(QBitArray &lines)
+void KateUndoGroup::markUndoAsSaved(const std::vector<int> &lines, std::vector<bool> &seen)
 {
     for (auto rit = m_items.rbegin(); rit != m_items.rend(); ++rit) {
-        updateUndoSavedOnDiskFlag(*rit, lines);
+        updateUndoSavedOnDiskFlag(*rit, lines, seen);
     }
 }
 
-static void updateRedoSavedOnDiskFlag(UndoItem &item, QBitArray &lines)
+static void updateRedoSavedOnDiskFlag(UndoItem &item, const std::vector<int> &lines, std::vector<bool> &seen)
 {
     const int line = item.line;
-    if (line >= lines.size()) {
-        lines.resize(line + 1);
-    }
-
-    const bool wasBitSet = lines.testBit(line);
-    if (!wasBitSet) {
-        lines.setBit(line);
-    }
+    auto lineSeen = seenLine(lines, seen, line);
+    const bool wasBitSet = lineSeen;
+    lineSeen = true;
     auto &lineFlags = item.lineModFlags;
 
     switch (item.type) {
@@ -365,16 +602,12 @@ static void updateRedoSavedOnDiskFlag(UndoItem &item, QBitArray &lines)
         }
         break;
     case UndoItem::editWrapLine:
-        if (line + 1 >= lines.size()) {
-            lines.resize(line + 2);
-        }
-
         if (lineFlags.testFlag(UndoItem::RedoLine1Modified) && !wasBitSet) {
             lineFlags.setFlag(UndoItem::RedoLine1Modified, false);
             lineFlags.setFlag(UndoItem::RedoLine1Saved, true);
         }
 
-        if (lineFlags.testFlag(UndoItem::RedoLine2Modified) && !lines.testBit(line + 1)) {
+        if (lineFlags.testFlag(UndoItem::RedoLine2Modified) && !seenLine(lines, seen, line + 1)) {
             lineFlags.setFlag(UndoItem::RedoLine2Modified, false);
             lineFlags.setFlag(UndoItem::RedoLine2Saved, true);
         }
@@ -386,10 +619,10 @@ static void updateRedoSavedOnDiskFlag(UndoItem &item, QBitArray &lines)
     }
 }
 
-void KateUndoGroup::markRedoAsSaved(QBitArray &lines)
+void KateUndoGroup::markRedoAsSaved(const std::vector<int> &lines, std::vector<bool> &seen)
 {
     for (auto rit = m_items.rbegin(); rit != m_items.rend(); ++rit) {
-        updateRedoSavedOnDiskFlag(*rit, lines);
+        updateRedoSavedOnDiskFlag(*rit, lines, seen);
     }
 }
 
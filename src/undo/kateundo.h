@@ -14,11 +14,11 @@
 
 #include <QList>
 
-#include <QBitArray>
 #include <kateview.h>
 #include <ktexteditor/range.h>
 
 class KateUndoManager;
+class QIODevice;
 namespace KTextEditor
 {
 class DocumentPrivate;
@@ -108,13 +108,58 @@ public:
         return m_items.empty();
     }
 
+    /**
+     * Rough estimate of the memory used by this group in bytes.
+     */
+    qsizetype memoryUsage() const;
+
+    /**
+     * Move the text of the items to the end of @p file.
+     * The group can't be undone or redone before restore() brought it back.
+     * @return the number of bytes freed, -1 on write errors
+     */
+    qsizetype spill(QIODevice &file);
+
+    /**
+     * Read back the text written by spill().
+     * @return success
+     */
+    bool restore(QIODevice &file);
+
+    /**
+     * Is the text of the items in the spill file?
+     */
+    bool isSpilled() const
+    {
+        return m_spillOffset >= 0;
+    }
+
     /**
      * Change all LineSaved flags to LineModified of the line modification system.
      */
     void flagSavedAsModified();
 
-    void markUndoAsSaved(QBitArray &lines);
-    void markRedoAsSaved(QBitArray &lines);
+    /**
+     * Append the lines of the items to @p lines, unsorted.
+     * The items of older groups on these lines don't restore the saved state of their line.
+     * @param lines lines to append to
+     * @param undo whether this group is on the redo stack, the undo flags are marked there
+     */
+    void appendLines(std::vector<int> &lines, bool undo) const;
+
+    /**
+     * The sorted lines the saved flags of the items depend on, the ones of the items and the lines after them.
+     */
+    std::vector<int> dependentLines() const;
+
+    /**
+     * Change the LineModified flags of the newest item of each line to LineSaved,
+     * markUndoAsSaved() for groups on the redo stack, markRedoAsSaved() for the undo stack.
+     * @param lines lines from dependentLines()
+     * @param seen for each of @p lines whether a newer group has an item on it, updated by the items of this group
+     */
+    void markUndoAsSaved(const std::vector<int> &lines, std::vector<bool> &seen);
+    void markRedoAsSaved(const std::vector<int> &lines, std::vector<bool> &seen);
 
     /**
      * Set the undo cursor to @p cursor.
@@ -151,6 +196,19 @@ private:
      */
     bool isOnlyType(UndoItem::UndoType type) const;
 
+    /**
+     * Can the items be replayed with replay() instead of the document's edit functions?
+     * True for large groups that only change text within lines, like a replace all.
+     */
+    bool canReplay() const;
+
+    /**
+     * Replay all items directly on the buffer of @p doc, in reverse order if @p undo.
+     * Neither checks nor records the edits, and emits one textReplayed() for all
+     * changed lines instead of one textInsertedRange() or textRemoved() per item.
+     */
+    void replay(KTextEditor::DocumentPrivate *doc, bool undo);
+
 public:
     /**
      * add an undo item
@@ -168,6 +226,12 @@ private:
      * prohibit merging with the next group
      */
     bool m_safePoint = false;
+
+    /**
+     * position of the text of the items in the spill file, -1 if in memory
+     */
+    qint64 m_spillOffset = -1;
+
     /*
      * Selection Range of primary cursor
      */
@@ -8,11 +8,15 @@
 
 #include <ktexteditor/view.h>
 
+#include "kateconfig.h"
 #include "katedocument.h"
 #include "katepartdebug.h"
 #include "kateview.h"
 
-#include <QBitArray>
+#include <QTemporaryFile>
+
+#include <algorithm>
+#include <functional>
 
 KateUndoManager::KateUndoManager(KTextEditor::DocumentPrivate *doc)
     : QObject(doc)
@@ -28,11 +32,16 @@ KateUndoManager::KateUndoManager(KTextEditor::DocumentPrivate *doc)
         savedUndoItems = std::move(undoItems);
         savedRedoItems = std::move(redoItems);
         docChecksumBeforeReload = m_document->checksum();
+        groupChanged(m_undoLinesIndex, undoItems, 0, false);
+        groupChanged(m_redoLinesIndex, redoItems, 0, true);
+        updateMemoryUsage();
     });
 
     // After reload restore it only if checksum of the doc is same
     connect(doc, &KTextEditor::DocumentPrivate::loaded, this, [this](KTextEditor::Document *doc) {
         if (doc && !doc->checksum().isEmpty() && !docChecksumBeforeReload.isEmpty() && doc->checksum() == docChecksumBeforeReload) {
+            groupChanged(m_undoLinesIndex, undoItems, 0, false);
+            groupChanged(m_redoLinesIndex, redoItems, 0, true);
             undoItems = std::move(savedUndoItems);
             redoItems = std::move(savedRedoItems);
             Q_EMIT undoChanged();
@@ -40,6 +49,7 @@ KateUndoManager::KateUndoManager(KTextEditor::DocumentPrivate *doc)
         docChecksumBeforeReload.clear();
         savedUndoItems.clear();
         savedRedoItems.clear();
+        updateMemoryUsage();
     });
 }
 
@@ -93,17 +103,30 @@ void KateUndoManager::editEnd()
 
     bool changedUndo = false;
 
+    // only an estimate, merging compacts items, enforceMemoryBudget() computes the real usage
+    const qsizetype addedMemory = m_editCurrentUndo->memoryUsage();
+
+    // undo() can leave a spilled group as the last one, nothing is merged into it as restore() would overwrite the merged items
+    if (!m_editCurrentUndo->isEmpty() && !undoItems.empty() && !undoItems.back().isSpilled()) {
+        groupChanged(m_undoLinesIndex, undoItems, undoItems.size() - 1, false);
+    }
     if (m_editCurrentUndo->isEmpty()) {
         m_editCurrentUndo.reset();
-    } else if (!undoItems.empty() && undoItems.back().merge(&*m_editCurrentUndo, m_undoComplexMerge)) {
+    } else if (!undoItems.empty() && !undoItems.back().isSpilled() && undoItems.back().merge(&*m_editCurrentUndo, m_undoComplexMerge)) {
         m_editCurrentUndo.reset();
+        m_memoryUsage += addedMemory - qsizetype(sizeof(KateUndoGroup));
     } else {
         undoItems.push_back(std::move(*m_editCurrentUndo));
+        m_memoryUsage += addedMemory;
         changedUndo = true;
     }
 
     m_editCurrentUndo.reset();
 
+    if (m_memoryBudget > 0 && m_memoryUsage > m_memoryBudget) {
+        enforceMemoryBudget();
+    }
+
     if (changedUndo) {
         Q_EMIT undoChanged();
     }
@@ -366,7 +389,11 @@ void KateUndoManager::addUndoItem(UndoItem undo)
     m_editCurrentUndo->addItem(std::move(undo));
 
     // Clear redo buffer
-    redoItems.clear();
+    if (!redoItems.empty()) {
+        groupChanged(m_redoLinesIndex, redoItems, 0, true);
+        redoItems.clear();
+        updateMemoryUsage();
+    }
 }
 
 void KateUndoManager::setActive(bool enabled)
@@ -394,9 +421,14 @@ void KateUndoManager::undo()
     Q_ASSERT(!m_editCurrentUndo.has_value()); // undo is not supported while we care about notifications (call editEnd() first)
 
     if (!undoItems.empty()) {
+        if (undoItems.back().isSpilled() && !restoreLastUndoGroup()) {
+            return;
+        }
+
         Q_EMIT undoStart(document());
 
         undoItems.back().undo(this, activeView());
+        groupChanged(m_undoLinesIndex, undoItems, undoItems.size() - 1, false);
         redoItems.push_back(std::move(undoItems.back()));
         undoItems.pop_back();
         updateModified();
@@ -413,6 +445,7 @@ void KateUndoManager::redo()
         Q_EMIT redoStart(document());
 
         redoItems.back().redo(this, activeView());
+        groupChanged(m_redoLinesIndex, redoItems, redoItems.size() - 1, true);
         undoItems.push_back(std::move(redoItems.back()));
         redoItems.pop_back();
         updateModified();
@@ -502,7 +535,9 @@ void KateUndoManager::updateModified()
 
 void KateUndoManager::clearUndo()
 {
+    groupChanged(m_undoLinesIndex, undoItems, 0, false);
     undoItems.clear();
+    updateMemoryUsage();
 
     lastUndoGroupWhenSaved = nullptr;
     docWasSavedWhenUndoWasEmpty = false;
@@ -512,7 +547,9 @@ void KateUndoManager::clearUndo()
 
 void KateUndoManager::clearRedo()
 {
+    groupChanged(m_redoLinesIndex, redoItems, 0, true);
     redoItems.clear();
+    updateMemoryUsage();
 
     lastRedoGroupWhenSaved = nullptr;
     docWasSavedWhenRedoWasEmpty = false;
@@ -538,25 +575,114 @@ void KateUndoManager::setModified(bool modified)
 
 void KateUndoManager::updateLineModifications()
 {
-    // change LineSaved flag of all undo & redo items to LineModified
-    for (KateUndoGroup &undoGroup : undoItems) {
-        undoGroup.flagSavedAsModified();
+    // the newest item of each line sets the flag LineSaved, all others get LineModified,
+    // only the groups changed since the last save and the older ones they shadow are visited
+    updateSavedFlags(undoItems, m_undoLinesIndex, m_droppedUndoGroups, false);
+    updateSavedFlags(redoItems, m_redoLinesIndex, 0, true);
+}
+
+void KateUndoManager::groupChanged(SavedLinesIndex &index, const std::vector<KateUndoGroup> &groups, size_t group, bool undo)
+{
+    if (group >= index.unchangedGroups) {
+        return;
+    }
+
+    // everything changed, start over
+    if (group == 0) {
+        index = SavedLinesIndex();
+        return;
     }
 
-    for (KateUndoGroup &undoGroup : redoItems) {
-        undoGroup.flagSavedAsModified();
+    // older groups on the lines of the changed ones might be the newest on their line again
+    for (size_t i = group; i < index.unchangedGroups; ++i) {
+        groups[i].appendLines(index.removedLines, undo);
     }
+    index.unchangedGroups = group;
+}
 
-    // iterate all undo/redo items to find out, which item sets the flag LineSaved
-    QBitArray lines(document()->lines(), false);
-    for (int i = undoItems.size() - 1; i >= 0; --i) {
-        undoItems[i].markRedoAsSaved(lines);
+void KateUndoManager::updateSavedFlags(std::vector<KateUndoGroup> &groups, SavedLinesIndex &index, size_t firstPosition, bool undo)
+{
+    // the lines of the removed and the changed groups
+    std::vector<int> lines = std::move(index.removedLines);
+    index.removedLines.clear();
+    for (size_t i = index.unchangedGroups; i < groups.size(); ++i) {
+        groups[i].appendLines(lines, undo);
     }
+    std::sort(lines.begin(), lines.end());
+    lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
 
-    lines.fill(false);
-    for (int i = redoItems.size() - 1; i >= 0; --i) {
-        redoItems[i].markUndoAsSaved(lines);
+    // forget them on these lines
+    const size_t firstChangedPosition = firstPosition + index.unchangedGroups;
+    for (int line : lines) {
+        const auto it = index.groups.find(line);
+        if (it == index.groups.end()) {
+            continue;
+        }
+        std::vector<size_t> &positions = it->second;
+        positions.erase(std::lower_bound(positions.begin(), positions.end(), firstChangedPosition), positions.end());
+        if (positions.empty()) {
+            index.groups.erase(it);
+        }
     }
+
+    // the unchanged groups whose flags might change: the newest one on each of the lines,
+    // and newer ones on the line in front, they check the line after their items, too
+    std::vector<size_t> visit;
+    for (int line : lines) {
+        const auto it = index.groups.find(line);
+        const size_t newest = it != index.groups.end() ? it->second.back() : 0;
+        if (it != index.groups.end()) {
+            visit.push_back(newest);
+        }
+
+        const auto previous = index.groups.find(line - 1);
+        if (previous != index.groups.end()) {
+            for (auto position = previous->second.rbegin(); position != previous->second.rend(); ++position) {
+                if (it != index.groups.end() && *position <= newest) {
+                    break;
+                }
+                visit.push_back(*position);
+            }
+        }
+    }
+
+    // the changed groups are all visited and join the index
+    std::vector<int> groupLines;
+    for (size_t i = index.unchangedGroups; i < groups.size(); ++i) {
+        const size_t position = firstPosition + i;
+        groupLines.clear();
+        groups[i].appendLines(groupLines, undo);
+        for (int line : groupLines) {
+            std::vector<size_t> &positions = index.groups[line];
+            if (positions.empty() || positions.back() != position) {
+                positions.push_back(position);
+            }
+        }
+        visit.push_back(position);
+    }
+    std::sort(visit.begin(), visit.end());
+    visit.erase(std::unique(visit.begin(), visit.end()), visit.end());
+
+    // change the LineSaved flags to LineModified and mark the newest items as saved again,
+    // newer groups have higher positions, on the redo stack too, it is walked from the back
+    for (size_t position : visit) {
+        KateUndoGroup &group = groups[position - firstPosition];
+        const std::vector<int> dependentLines = group.dependentLines();
+        std::vector<bool> seen(dependentLines.size());
+        for (size_t i = 0; i < dependentLines.size(); ++i) {
+            const auto it = index.groups.find(dependentLines[i]);
+            seen[i] = it != index.groups.end() && it->second.back() > position;
+        }
+
+        group.flagSavedAsModified();
+        if (undo) {
+            group.markUndoAsSaved(dependentLines, seen);
+        } else {
+            group.markRedoAsSaved(dependentLines, seen);
+        }
+    }
+
+    index.unchangedGroups = groups.size();
 }
 
 void KateUndoManager::setUndoRedoCursorsOfLastGroup(const KTextEditor::Cursor undoCursor, const KTextEditor::Cursor redoCursor)
@@ -580,9 +706,134 @@ KTextEditor::Cursor KateUndoManager::lastRedoCursor() const
 
 void KateUndoManager::updateConfig()
 {
+    const KateDocumentConfig *config = m_document->config();
+    setMemoryBudget(qsizetype(config->undoMemoryBudget()) * 1024 * 1024, config->undoSpillToDisk());
+
     Q_EMIT undoChanged();
 }
 
+void KateUndoManager::setMemoryBudget(qsizetype bytes, bool spillToDisk)
+{
+    m_memoryBudget = bytes;
+    m_spillToDisk = spillToDisk;
+
+    if (m_memoryBudget > 0 && m_memoryUsage > m_memoryBudget) {
+        enforceMemoryBudget();
+    }
+}
+
+void KateUndoManager::updateMemoryUsage()
+{
+    m_memoryUsage = 0;
+    for (const KateUndoGroup &group : undoItems) {
+        m_memoryUsage += group.memoryUsage();
+    }
+    for (const KateUndoGroup &group : redoItems) {
+        m_memoryUsage += group.memoryUsage();
+    }
+
+    m_spilledUndoGroups = 0;
+    while (m_spilledUndoGroups < undoItems.size() && undoItems[m_spilledUndoGroups].isSpilled()) {
+        ++m_spilledUndoGroups;
+    }
+
+    // nothing references the spill file anymore, start over
+    const auto isSpilled = [](const KateUndoGroup &group) {
+        return group.isSpilled();
+    };
+    if (m_spillFile && m_spilledUndoGroups == 0 && std::none_of(savedUndoItems.begin(), savedUndoItems.end(), isSpilled)) {
+        m_spillFile->resize(0);
+    }
+}
+
+void KateUndoManager::enforceMemoryBudget()
+{
+    // the running estimate only grows, check the real usage first
+    updateMemoryUsage();
+    if (m_memoryUsage <= m_memoryBudget) {
+        return;
+    }
+
+    // leave some room, to not end up here again on the next keystroke
+    const qsizetype target = m_memoryBudget / 4 * 3;
+
+    // the last group stays in memory, it may still be merged with
+    if (m_spillToDisk) {
+        if (!m_spillFile) {
+            m_spillFile = std::make_unique<QTemporaryFile>();
+            if (!m_spillFile->open()) {
+                qCWarning(LOG_KTE) << "Failed to create the undo spill file" << m_spillFile->errorString();
+                m_spillFile.reset();
+            }
+        }
+
+        while (m_spillFile && m_memoryUsage > target && (m_spilledUndoGroups + 1) < undoItems.size()) {
+            const qsizetype freed = undoItems[m_spilledUndoGroups].spill(*m_spillFile);
+            if (freed < 0) {
+                qCWarning(LOG_KTE) << "Failed to write the undo spill file" << m_spillFile->errorString();
+                break;
+            }
+            m_memoryUsage -= freed;
+            ++m_spilledUndoGroups;
+        }
+    }
+
+    // still too much, forget the oldest groups
+    size_t dropped = 0;
+    while (m_memoryUsage > target && (dropped + 1) < undoItems.size()) {
+        m_memoryUsage -= undoItems[dropped].memoryUsage();
+        ++dropped;
+    }
+    if (dropped == 0) {
+        return;
+    }
+
+    qCDebug(LOG_KTE) << "dropping" << dropped << "undo groups to stay within" << m_memoryBudget << "bytes";
+
+    // the groups of the saved state are only compared by address, move them along with the erased ones
+    const auto fixup = [this, dropped](KateUndoGroup *&group) {
+        const std::less<const KateUndoGroup *> less;
+        if (!group || less(group, undoItems.data()) || !less(group, undoItems.data() + undoItems.size())) {
+            return;
+        }
+        const size_t index = group - undoItems.data();
+        group = index < dropped ? nullptr : undoItems.data() + (index - dropped);
+    };
+    fixup(lastUndoGroupWhenSaved);
+    fixup(lastRedoGroupWhenSaved);
+
+    // undoing everything won't reach the saved state anymore
+    docWasSavedWhenUndoWasEmpty = false;
+
+    undoItems.erase(undoItems.begin(), undoItems.begin() + dropped);
+    m_spilledUndoGroups -= std::min(dropped, m_spilledUndoGroups);
+    m_undoLinesIndex.unchangedGroups -= std::min(dropped, m_undoLinesIndex.unchangedGroups);
+    m_droppedUndoGroups += dropped;
+    for (auto it = m_undoLinesIndex.groups.begin(); it != m_undoLinesIndex.groups.end();) {
+        std::vector<size_t> &positions = it->second;
+        positions.erase(positions.begin(), std::lower_bound(positions.begin(), positions.end(), m_droppedUndoGroups));
+        it = positions.empty() ? m_undoLinesIndex.groups.erase(it) : std::next(it);
+    }
+
+    Q_EMIT undoChanged();
+}
+
+bool KateUndoManager::restoreLastUndoGroup()
+{
+    KateUndoGroup &group = undoItems.back();
+    const qsizetype spilledUsage = group.memoryUsage();
+    if (!m_spillFile || !group.restore(*m_spillFile)) {
+        qCWarning(LOG_KTE) << "Failed to read back the undo history from disk, dropping it";
+        clearUndo();
+        return false;
+    }
+
+    // spilled groups are the oldest ones, this was the last of them
+    m_memoryUsage += group.memoryUsage() - spilledUsage;
+    --m_spilledUndoGroups;
+    return true;
+}
+
 void KateUndoManager::setAllowComplexMerge(bool allow)
 {
     m_undoComplexMerge = allow;
@@ -14,7 +14,10 @@
 
 #include <QList>
 
+#include <memory>
 #include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace KTextEditor
 {
@@ -22,6 +25,7 @@ class DocumentPrivate;
 }
 class KateUndo;
 class KateUndoGroup;
+class QTemporaryFile;
 
 namespace KTextEditor
 {
@@ -110,6 +114,24 @@ public:
      */
     KTextEditor::Cursor lastRedoCursor() const;
 
+    /**
+     * Limit the memory used by the history to about @p bytes, 0 for no limit.
+     * Once over budget, the text of the oldest undo groups is moved to a
+     * temporary file if @p spillToDisk is set, the oldest groups are dropped
+     * if that isn't enough.
+     * Normally set from the document config by updateConfig().
+     */
+    void setMemoryBudget(qsizetype bytes, bool spillToDisk);
+
+    /**
+     * Rough estimate of the memory used by the history in bytes,
+     * without the text moved to disk.
+     */
+    qsizetype memoryUsage() const
+    {
+        return m_memoryUsage;
+    }
+
 public Q_SLOTS:
     /**
      * Undo the latest undo group.
@@ -206,6 +228,60 @@ private:
     KTEXTEDITOR_NO_EXPORT
     KTextEditor::ViewPrivate *activeView();
 
+    /**
+     * Recompute m_memoryUsage and m_spilledUndoGroups after bigger changes of the history.
+     */
+    KTEXTEDITOR_NO_EXPORT
+    void updateMemoryUsage();
+
+    /**
+     * Spill or drop the oldest undo groups until the history fits into the memory budget again.
+     */
+    KTEXTEDITOR_NO_EXPORT
+    void enforceMemoryBudget();
+
+    /**
+     * Bring back the text of the last undo group from disk.
+     * @return success, on failure the undo history is cleared
+     */
+    KTEXTEDITOR_NO_EXPORT
+    bool restoreLastUndoGroup();
+
+    /**
+     * What updateLineModifications() knows about one of the stacks since the last save.
+     */
+    struct SavedLinesIndex {
+        /**
+         * for each line, the positions of the groups with items on it, oldest first
+         */
+        std::unordered_map<int, std::vector<size_t>> groups;
+
+        /**
+         * the groups in front of this one didn't change since the last save
+         */
+        size_t unchangedGroups = 0;
+
+        /**
+         * lines of the groups that were removed from the unchanged ones since the last save
+         */
+        std::vector<int> removedLines;
+    };
+
+    /**
+     * The group @p group of @p groups is about to be removed or changed,
+     * the next updateLineModifications() revisits it and the newer ones.
+     */
+    KTEXTEDITOR_NO_EXPORT
+    static void groupChanged(SavedLinesIndex &index, const std::vector<KateUndoGroup> &groups, size_t group, bool undo);
+
+    /**
+     * Update the saved flags of the changed groups of one stack and of the unchanged groups they shadow.
+     * @param firstPosition position of the first group in @p index, groups might have been dropped
+     * @param undo whether @p groups is the redo stack, the undo flags are marked there
+     */
+    KTEXTEDITOR_NO_EXPORT
+    static void updateSavedFlags(std::vector<KateUndoGroup> &groups, SavedLinesIndex &index, size_t firstPosition, bool undo);
+
 private:
     KTextEditor::DocumentPrivate *m_document = nullptr;
     bool m_undoComplexMerge = false;
@@ -224,6 +300,18 @@ private:
     std::vector<KateUndoGroup> savedUndoItems;
     std::vector<KateUndoGroup> savedRedoItems;
     QByteArray docChecksumBeforeReload;
+
+    // memory budget, spilled groups are always the oldest ones at the front of undoItems
+    qsizetype m_memoryBudget = 0;
+    bool m_spillToDisk = false;
+    qsizetype m_memoryUsage = 0;
+    size_t m_spilledUndoGroups = 0;
+    std::unique_ptr<QTemporaryFile> m_spillFile;
+
+    // line modification bookkeeping, the positions of the undo groups count the ones dropped from the front
+    SavedLinesIndex m_undoLinesIndex;
+    SavedLinesIndex m_redoLinesIndex;
+    size_t m_droppedUndoGroups = 0;
 };
 
 #endif
@@ -6,6 +6,7 @@
 
 #include "document.h"
 #include "katedocument.h"
+#include "katemultipatternsearch.h"
 
 using namespace KTextEditor;
 
@@ -114,3 +115,13 @@ QVector<KTextEditor::Range> Document::searchText(KTextEditor::Range range, const
 {
     return d->searchText(range, pattern, options);
 }
+
+QVector<QVector<KTextEditor::Range>> Document::searchTexts(KTextEditor::Range range, const QStringList &patterns, const SearchOptions options) const
+{
+    QVector<QVector<KTextEditor::Range>> result(patterns.size());
+    const auto matches = KateMultiPatternSearch(this, patterns, options).search(range);
+    for (const auto &match : matches) {
+        result[match.pattern].push_back(match.range);
+    }
+    return result;
+}
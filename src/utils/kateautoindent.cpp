@@ -18,6 +18,7 @@
 #include "kateglobal.h"
 #include "katehighlight.h"
 #include "kateindentscript.h"
+#include "katenativeindenter.h"
 #include "katepartdebug.h"
 #include "katescriptmanager.h"
 
@@ -261,6 +262,7 @@ void KateAutoIndent::reloadScript()
 {
     // small trick to force reload
     m_script = nullptr; // prevent dangling pointer
+    m_nativeIndenter.reset();
     QString currentMode = m_mode;
     m_mode = QString();
     setMode(currentMode);
@@ -272,7 +274,9 @@ void KateAutoIndent::scriptIndent(KTextEditor::ViewPrivate *view, const KTextEdi
     doc->pushEditState();
     doc->editStart();
 
-    QPair<int, int> result = m_script->indent(view, position, typedChar, indentWidth);
+    // prefer the native implementation of the script, if there is one
+    QPair<int, int> result = nativeIndenter() ? m_nativeIndenter->indent(view, position, typedChar, indentWidth)
+                                              : m_script->indent(view, position, typedChar, indentWidth);
     int newIndentInChars = result.first;
 
     // handle negative values special
@@ -297,6 +301,11 @@ void KateAutoIndent::scriptIndent(KTextEditor::ViewPrivate *view, const KTextEdi
     doc->popEditState();
 }
 
+KateNativeIndenter *KateAutoIndent::nativeIndenter() const
+{
+    return KateNativeIndenter::isEnabled() ? m_nativeIndenter.get() : nullptr;
+}
+
 bool KateAutoIndent::isStyleProvided(const KateIndentScript *script, const KateHighlighting *highlight)
 {
     QString requiredStyle = script->indentHeader().requiredStyle();
@@ -312,6 +321,7 @@ void KateAutoIndent::setMode(const QString &name)
 
     // cleanup
     m_script = nullptr;
+    m_nativeIndenter.reset();
 
     // first, catch easy stuff... normal mode and none, easy...
     if (name.isEmpty() || name == MODE_NONE()) {
@@ -329,6 +339,10 @@ void KateAutoIndent::setMode(const QString &name)
     if (script) {
         if (isStyleProvided(script, doc->highlight())) {
             m_script = script;
+            // a script the user installed with the same name replaces the bundled one, it must not be bypassed
+            if (script->url().startsWith(QLatin1String(":/ktexteditor/"))) {
+                m_nativeIndenter = KateNativeIndenter::create(name, doc);
+            }
             m_mode = name;
             return;
         } else {
@@ -437,7 +451,8 @@ void KateAutoIndent::userTypedChar(KTextEditor::ViewPrivate *view, const KTextEd
     }
 
     // does the script allow this char as trigger?
-    if (typedChar != QLatin1Char('\n') && !m_script->triggerCharacters().contains(typedChar)) {
+    const QString &triggerCharacters = nativeIndenter() ? m_nativeIndenter->triggerCharacters() : m_script->triggerCharacters();
+    if (typedChar != QLatin1Char('\n') && !triggerCharacters.contains(typedChar)) {
         return;
     }
 
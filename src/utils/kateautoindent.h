@@ -19,12 +19,15 @@
 
 #include <KActionMenu>
 
+#include <memory>
+
 namespace KTextEditor
 {
 class DocumentPrivate;
 class Cursor;
 }
 class KateIndentScript;
+class KateNativeIndenter;
 class KateHighlighting;
 
 /**
@@ -145,6 +148,12 @@ private:
      */
     void scriptIndent(KTextEditor::ViewPrivate *view, const KTextEditor::Cursor position, QChar typedChar);
 
+    /**
+     * The native indenter to use instead of the script, nullptr if there is
+     * none for the current mode or native indenters are disabled.
+     */
+    KateNativeIndenter *nativeIndenter() const;
+
     /**
      * Return true if the required style for the script is provided by the highlighter.
      */
@@ -224,6 +233,7 @@ private:
     bool keepExtra; //!< Keep indentation that is not on indentation boundaries
     QString m_mode;
     KateIndentScript *m_script;
+    std::unique_ptr<KateNativeIndenter> m_nativeIndenter; //!< C++ implementation of m_script, if available
 };
 
 /**
@@ -5,6 +5,7 @@
 */
 
 #include "katecmd.h"
+#include "katecmds.h"
 #include "kateglobal.h"
 
 #include "katepartdebug.h"
@@ -24,13 +25,21 @@ KateCmd::~KateCmd() = default;
 
 bool KateCmd::registerCommand(KTextEditor::Command *cmd)
 {
-    const QStringList &l = cmd->cmds();
-
-    for (int z = 0; z < l.count(); z++) {
-        if (m_dict.contains(l[z])) {
-            qCDebug(LOG_KTE) << "Command already registered: " << l[z] << ". Aborting.";
+    QStringList l;
+    for (const QString &name : cmd->cmds()) {
+        if (KTextEditor::Command *registered = m_dict.value(name)) {
+            // the native line commands replace the functions of the same name of the bundled utils.js, keep its other ones
+            if (dynamic_cast<KateCommands::LineCommands *>(registered)) {
+                qCDebug(LOG_KTE) << "Command already registered natively: " << name << ". Skipping it.";
+                continue;
+            }
+            qCDebug(LOG_KTE) << "Command already registered: " << name << ". Aborting.";
             return false;
         }
+        l.append(name);
+    }
+    if (l.isEmpty()) {
+        return false;
     }
 
     for (int z = 0; z < l.count(); z++) {
@@ -102,6 +111,8 @@ QStringList KateCmd::commandList() const
 
 KateCmd *KateCmd::self()
 {
+    // the script manager is created on first use, ensure the command line scripts are registered
+    KTextEditor::EditorPrivate::self()->scriptManager();
     return KTextEditor::EditorPrivate::self()->cmdManager();
 }
 
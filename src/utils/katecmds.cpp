@@ -10,17 +10,25 @@
 
 #include "kateautoindent.h"
 #include "katecmd.h"
+#include "katecommandlinescript.h"
 #include "katedocument.h"
+#include "kateglobal.h"
 #include "katepartdebug.h"
 #include "katerenderer.h"
+#include "katescriptmanager.h"
 #include "katesyntaxmanager.h"
 #include "katetextline.h"
 #include "kateview.h"
 
 #include <KLocalizedString>
+#include <KShell>
 
 #include <QDateTime>
 #include <QRegularExpression>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
 
 // BEGIN CoreCommands
 KateCommands::CoreCommands *KateCommands::CoreCommands::m_instance = nullptr;
@@ -602,3 +610,276 @@ bool KateCommands::Date::exec(KTextEditor::View *view, const QString &cmd, QStri
 }
 
 // END Date
+
+// BEGIN LineCommands
+KateCommands::LineCommands *KateCommands::LineCommands::m_instance = nullptr;
+
+// from this number of lines on, chunks are sorted in parallel and merged afterwards
+static constexpr qsizetype parallelSortSize = 65536;
+
+// the characters JavaScript treats as white space, for \s and the conversion of strings to numbers
+static bool isJsWhiteSpace(int c)
+{
+    switch (c) {
+    case 0x09:
+    case 0x0A:
+    case 0x0B:
+    case 0x0C:
+    case 0x0D:
+    case 0x20:
+    case 0xA0:
+    case 0x1680:
+    case 0x2028:
+    case 0x2029:
+    case 0x202F:
+    case 0x205F:
+    case 0x3000:
+    case 0xFEFF:
+        return true;
+    default:
+        return c >= 0x2000 && c <= 0x200A;
+    }
+}
+
+// the helpers below follow natcompare() of utils.js, the sort order must not change
+// a character is -1 past the end of the string, like the empty string charAt() returns there
+static int charAt(QStringView s, qsizetype i)
+{
+    return i < s.size() ? s[i].unicode() : -1;
+}
+
+static bool isWhitespaceChar(int c)
+{
+    return c >= 0 && c <= 32;
+}
+
+static bool isDigitChar(int c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// JavaScript's (c == 0) for a one character string
+static bool equalsZero(int c)
+{
+    return c < 0 || c == '0' || isJsWhiteSpace(c);
+}
+
+static int compareRight(QStringView a, QStringView b)
+{
+    // the longest run of digits wins, else the first differing digit
+    int bias = 0;
+    for (qsizetype i = 0;; ++i) {
+        const int ca = charAt(a, i);
+        const int cb = charAt(b, i);
+        if (!isDigitChar(ca) && !isDigitChar(cb)) {
+            return bias;
+        } else if (!isDigitChar(ca)) {
+            return -1;
+        } else if (!isDigitChar(cb)) {
+            return +1;
+        } else if (ca < cb) {
+            if (bias == 0) {
+                bias = -1;
+            }
+        } else if (ca > cb) {
+            if (bias == 0) {
+                bias = +1;
+            }
+        } else if (equalsZero(ca) && equalsZero(cb)) {
+            return bias;
+        }
+    }
+}
+
+static int naturalCompare(QStringView a, QStringView b)
+{
+    qsizetype ia = 0;
+    qsizetype ib = 0;
+    while (true) {
+        // only count the number of zeroes leading the last number compared
+        int nza = 0;
+        int nzb = 0;
+        int ca = charAt(a, ia);
+        int cb = charAt(b, ib);
+
+        // skip over leading spaces or zeros
+        while (isWhitespaceChar(ca) || ca == '0') {
+            nza = (ca == '0') ? nza + 1 : 0;
+            ca = charAt(a, ++ia);
+        }
+        while (isWhitespaceChar(cb) || cb == '0') {
+            nzb = (cb == '0') ? nzb + 1 : 0;
+            cb = charAt(b, ++ib);
+        }
+
+        // process run of digits
+        if (isDigitChar(ca) && isDigitChar(cb)) {
+            const int result = compareRight(a.mid(ia), b.mid(ib));
+            if (result != 0) {
+                return result;
+            }
+        }
+
+        if (equalsZero(ca) && equalsZero(cb)) {
+            return nza - nzb;
+        }
+        if (ca < cb) {
+            return -1;
+        } else if (ca > cb) {
+            return +1;
+        }
+        ++ia;
+        ++ib;
+    }
+}
+
+template<typename LessThan>
+static void sortLines(QStringList &lines, LessThan lessThan)
+{
+    const int threads = QThread::idealThreadCount();
+    if (lines.size() < parallelSortSize || threads < 2) {
+        std::stable_sort(lines.begin(), lines.end(), lessThan);
+        return;
+    }
+
+    // sort a chunk per thread, then merge neighbouring chunks until one is left, stable like the sequential sort
+    const auto begin = lines.begin();
+    std::vector<qsizetype> bounds;
+    for (int i = 0; i <= threads; ++i) {
+        bounds.push_back(lines.size() * i / threads);
+    }
+
+    QThreadPool pool;
+    for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+        pool.start([&, i] {
+            std::stable_sort(begin + bounds[i], begin + bounds[i + 1], lessThan);
+        });
+    }
+    pool.waitForDone();
+
+    while (bounds.size() > 2) {
+        std::vector<qsizetype> merged;
+        for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+            merged.push_back(bounds[i]);
+            if (i + 2 < bounds.size()) {
+                pool.start([&, i] {
+                    std::inplace_merge(begin + bounds[i], begin + bounds[i + 1], begin + bounds[i + 2], lessThan);
+                });
+            }
+        }
+        merged.push_back(bounds.back());
+        pool.waitForDone();
+        bounds = std::move(merged);
+    }
+}
+
+KTextEditor::Command *KateCommands::LineCommands::scriptCommand(const QString &cmd)
+{
+    const auto &scripts = KTextEditor::EditorPrivate::self()->scriptManager()->commandLineScripts();
+    for (KateCommandLineScript *script : scripts) {
+        if (script->cmds().contains(cmd)) {
+            return script;
+        }
+    }
+    return nullptr;
+}
+
+bool KateCommands::LineCommands::help(KTextEditor::View *view, const QString &cmd, QString &msg)
+{
+    KTextEditor::Command *script = scriptCommand(cmd.trimmed());
+    return script && script->help(view, cmd, msg);
+}
+
+bool KateCommands::LineCommands::supportsRange(const QString &)
+{
+    return true;
+}
+
+bool KateCommands::LineCommands::exec(KTextEditor::View *view, const QString &cmd, QString &errorMsg, const KTextEditor::Range &range)
+{
+    KShell::Errors errorCode;
+    QStringList args(KShell::splitArgs(cmd, KShell::NoOptions, &errorCode));
+    auto v = qobject_cast<KTextEditor::ViewPrivate *>(view);
+
+    // block selections and bad quoting are left to the script, so is reporting the errors
+    if (!v || errorCode != KShell::NoError || args.isEmpty() || (v->blockSelection() && (range.isValid() || v->selection()))) {
+        KTextEditor::Command *script = scriptCommand(args.value(0));
+        if (!script) {
+            errorMsg = i18n("Command '%1' not available.", args.value(0));
+            return false;
+        }
+        return script->exec(view, cmd, errorMsg, range);
+    }
+
+    if (range.isValid()) {
+        v->setSelection(range);
+    }
+
+    // like each() of utils.js: the selected lines or the whole document
+    KTextEditor::DocumentPrivate *doc = v->doc();
+    KTextEditor::Range selection = v->selectionRange();
+    if (!selection.isValid()) {
+        selection = doc->documentRange();
+    } else {
+        selection = KTextEditor::Range(selection.start().line(), 0, selection.end().line(), doc->lineLength(selection.end().line()));
+    }
+
+    QStringList lines;
+    lines.reserve(selection.numberOfLines() + 1);
+    for (int line = selection.start().line(); line <= selection.end().line(); ++line) {
+        lines.append(doc->line(line));
+    }
+    const int oldLineCount = lines.size();
+
+    const QString command = args.takeFirst();
+    const auto lessThan = [](const QString &a, const QString &b) {
+        return a < b;
+    };
+    if (command == QLatin1String("sort")) {
+        sortLines(lines, lessThan);
+    } else if (command == QLatin1String("sortuniq")) {
+        lines.removeDuplicates();
+        sortLines(lines, lessThan);
+    } else if (command == QLatin1String("natsort")) {
+        sortLines(lines, [](const QString &a, const QString &b) {
+            return naturalCompare(a, b) < 0;
+        });
+    } else if (command == QLatin1String("uniq")) {
+        lines.removeDuplicates();
+    } else if (command == QLatin1String("rtrim")) {
+        for (QString &line : lines) {
+            qsizetype end = line.size();
+            while (end > 0 && isJsWhiteSpace(line.at(end - 1).unicode())) {
+                --end;
+            }
+            line.truncate(end);
+        }
+    } else if (command == QLatin1String("join")) {
+        lines = QStringList{lines.join(args.value(0))};
+    } else {
+        return false;
+    }
+
+    // replace the lines in one edit, the cursor stays if the number of lines is the same
+    const KTextEditor::Cursor cursor = v->cursorPosition();
+    const int oldCurrentLineLength = doc->lineLength(cursor.line());
+    v->clearSelection();
+
+    doc->editStart();
+    doc->removeText(selection);
+    doc->insertText(selection.start(), lines.join(QLatin1Char('\n')));
+    doc->editEnd();
+
+    if (lines.size() == oldLineCount) {
+        KTextEditor::Cursor newCursor = cursor;
+        if (doc->lineLength(cursor.line()) != oldCurrentLineLength) {
+            const Kate::TextLine textLine = doc->plainKateTextLine(cursor.line());
+            newCursor.setColumn((textLine ? textLine->lastChar() : -1) + 1);
+        }
+        v->setCursorPosition(newCursor);
+    }
+
+    return true;
+}
+
+// END LineCommands
@@ -191,5 +191,63 @@ public:
     }
 };
 
+/**
+ * Native versions of line based commands of the utils.js command line script.
+ * Like the script, they replace the selected lines or the whole document,
+ * but in one edit and without passing each line through the script engine.
+ * The script is still used for what they don't handle, e.g. block selections.
+ */
+class LineCommands : public KTextEditor::Command
+{
+    LineCommands()
+        : KTextEditor::Command({QStringLiteral("sort"),
+                                QStringLiteral("sortuniq"),
+                                QStringLiteral("natsort"),
+                                QStringLiteral("uniq"),
+                                QStringLiteral("rtrim"),
+                                QStringLiteral("join")})
+    {
+    }
+
+    static LineCommands *m_instance;
+
+public:
+    ~LineCommands() override
+    {
+        m_instance = nullptr;
+    }
+
+    /**
+     * execute command
+     * @param view view to use for execution
+     * @param cmd cmd string
+     * @param errorMsg error to return if no success
+     * @param range range to execute command on
+     * @return success
+     */
+    bool
+    exec(class KTextEditor::View *view, const QString &cmd, QString &errorMsg, const KTextEditor::Range &range = KTextEditor::Range(-1, -0, -1, 0)) override;
+
+    bool supportsRange(const QString &range) override;
+
+    /** The help of the script command. @see KTextEditor::Command::help */
+    bool help(class KTextEditor::View *view, const QString &cmd, QString &msg) override;
+
+    /**
+     * The command of the command line script that provides @p cmd, the fallback for what isn't handled natively.
+     * @param cmd command name
+     * @return script command or nullptr
+     */
+    static KTextEditor::Command *scriptCommand(const QString &cmd);
+
+    static LineCommands *self()
+    {
+        if (m_instance == nullptr) {
+            m_instance = new LineCommands();
+        }
+        return m_instance;
+    }
+};
+
 } // namespace KateCommands
 #endif
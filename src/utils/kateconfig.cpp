@@ -352,6 +352,15 @@ KateDocumentConfig::KateDocumentConfig()
     // Shall we do auto reloading for stuff e.g. in Git?
     addConfigEntry(ConfigEntry(AutoReloadIfStateIsInVersionControl, "Auto Reload If State Is In Version Control", QString(), true));
 
+    // Limit the memory used by the undo history
+    addConfigEntry(ConfigEntry(UndoMemoryBudget, "Undo Memory Budget", QString(), 0, [](const QVariant &value) {
+        return value.toInt() >= 0;
+    }));
+    addConfigEntry(ConfigEntry(UndoSpillToDisk, "Undo Spill To Disk", QString(), false));
+
+    // Index large documents for repeated searches
+    addConfigEntry(ConfigEntry(SearchIndex, "Search Index", QString(), false));
+
     // finalize the entries, e.g. hashs them
     finalizeConfigEntries();
 
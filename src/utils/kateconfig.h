@@ -556,7 +556,22 @@ public:
         /**
          * Should we auto-reload if the old state is in version control?
          */
-        AutoReloadIfStateIsInVersionControl
+        AutoReloadIfStateIsInVersionControl,
+
+        /**
+         * Memory budget of the undo history in MiB, 0 for no limit
+         */
+        UndoMemoryBudget,
+
+        /**
+         * Move the text of old undo steps to a temporary file instead of dropping them?
+         */
+        UndoSpillToDisk,
+
+        /**
+         * Keep a trigram index of the text to speed up searches?
+         */
+        SearchIndex
     };
 
 public:
@@ -919,6 +934,36 @@ public:
         setValue(LineLengthLimit, limit);
     }
 
+    int undoMemoryBudget() const
+    {
+        return value(UndoMemoryBudget).toInt();
+    }
+
+    void setUndoMemoryBudget(int megaBytes)
+    {
+        setValue(UndoMemoryBudget, megaBytes);
+    }
+
+    bool undoSpillToDisk() const
+    {
+        return value(UndoSpillToDisk).toBool();
+    }
+
+    void setUndoSpillToDisk(bool on)
+    {
+        setValue(UndoSpillToDisk, on);
+    }
+
+    bool searchIndex() const
+    {
+        return value(SearchIndex).toBool();
+    }
+
+    void setSearchIndex(bool on)
+    {
+        setValue(SearchIndex, on);
+    }
+
     void setCamelCursor(bool on)
     {
         setValue(CamelCursor, on);
@@ -25,6 +25,7 @@
 #include "katehighlightingcmds.h"
 #include "katekeywordcompletion.h"
 #include "katemodemanager.h"
+#include "katepartdebug.h"
 #include "katescriptmanager.h"
 #include "katesedcmd.h"
 #include "katesyntaxmanager.h"
@@ -45,6 +46,7 @@
 #include <QApplication>
 #include <QBoxLayout>
 #include <QClipboard>
+#include <QElapsedTimer>
 #include <QFrame>
 #include <QPushButton>
 #include <QScreen>
@@ -67,6 +69,18 @@ bool KTextEditor::EditorPrivate::unitTestMode()
 }
 // END unit test mode
 
+template<typename Init>
+void KTextEditor::EditorPrivate::traceStartup(const char *subsystem, Init init)
+{
+    QElapsedTimer timer;
+    timer.start();
+    init();
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    m_startupTrace.push_back({QString::fromLatin1(subsystem), elapsed});
+    qCDebug(LOG_KTE) << "initialized" << subsystem << "in" << (elapsed / 1000) << "us";
+}
+
 KTextEditor::EditorPrivate::EditorPrivate(QPointer<KTextEditor::EditorPrivate> &staticInstance)
     : KTextEditor::Editor(this)
     , m_aboutData(QStringLiteral("katepart"),
@@ -158,63 +172,55 @@ KTextEditor::EditorPrivate::EditorPrivate(QPointer<KTextEditor::EditorPrivate> &
     //
     // dir watch
     //
-    m_dirWatch = new KDirWatch();
+    traceStartup("dirWatch", [this]() {
+        m_dirWatch = new KDirWatch();
+    });
 
     //
     // command manager
     //
-    m_cmdManager = new KateCmd();
+    traceStartup("cmdManager", [this]() {
+        m_cmdManager = new KateCmd();
+    });
 
     //
     // variable expansion manager
     //
-    m_variableExpansionManager = new KateVariableExpansionManager(this);
-
-    //
-    // hl manager
-    //
-    m_hlManager = new KateHlManager();
-
-    //
-    // mode man
-    //
-    m_modeManager = new KateModeManager();
-
-    //
-    // input mode factories
-    //
-    Q_ASSERT(m_inputModeFactories.size() == KTextEditor::View::ViInputMode + 1);
-    m_inputModeFactories[KTextEditor::View::NormalInputMode].reset(new KateNormalInputModeFactory());
-    m_inputModeFactories[KTextEditor::View::ViInputMode].reset(new KateViInputModeFactory());
+    traceStartup("variableExpansionManager", [this]() {
+        m_variableExpansionManager = new KateVariableExpansionManager(this);
+    });
 
     //
-    // spell check manager
+    // the hl manager, mode manager, spell check manager, script manager,
+    // input mode factories and completion models are created on first use,
+    // see the accessors below, to keep the time to the first document low
     //
-    m_spellCheckManager = new KateSpellCheckManager();
-
-    // config objects
-    m_globalConfig = new KateGlobalConfig();
-    m_documentConfig = new KateDocumentConfig();
-    m_viewConfig = new KateViewConfig();
-    m_rendererConfig = new KateRendererConfig();
 
-    // create script manager (search scripts)
-    m_scriptManager = KateScriptManager::self();
+    // config objects, the renderer config will pull in the hl manager for the theme
+    traceStartup("globalConfig", [this]() {
+        m_globalConfig = new KateGlobalConfig();
+    });
+    traceStartup("documentConfig", [this]() {
+        m_documentConfig = new KateDocumentConfig();
+    });
+    traceStartup("viewConfig", [this]() {
+        m_viewConfig = new KateViewConfig();
+    });
+    traceStartup("rendererConfig", [this]() {
+        m_rendererConfig = new KateRendererConfig();
+    });
 
     //
     // init the cmds
     //
-    m_cmds.push_back(KateCommands::CoreCommands::self());
-    m_cmds.push_back(KateCommands::Character::self());
-    m_cmds.push_back(KateCommands::Date::self());
-    m_cmds.push_back(KateCommands::SedReplace::self());
-    m_cmds.push_back(KateCommands::Highlighting::self());
-
-    // global word completion model
-    m_wordCompletionModel = new KateWordCompletionModel(this);
-
-    // global keyword completion model
-    m_keywordCompletionModel = new KateKeywordCompletionModel(this);
+    traceStartup("commands", [this]() {
+        m_cmds.push_back(KateCommands::CoreCommands::self());
+        m_cmds.push_back(KateCommands::Character::self());
+        m_cmds.push_back(KateCommands::Date::self());
+        m_cmds.push_back(KateCommands::SedReplace::self());
+        m_cmds.push_back(KateCommands::Highlighting::self());
+        m_cmds.push_back(KateCommands::LineCommands::self());
+    });
 
     // tap to QApplication object for color palette changes
     qApp->installEventFilter(this);
@@ -249,6 +255,79 @@ KTextEditor::EditorPrivate::~EditorPrivate()
     delete m_cmdManager;
 }
 
+KateModeManager *KTextEditor::EditorPrivate::modeManager()
+{
+    if (!m_modeManager) {
+        traceStartup("modeManager", [this]() {
+            m_modeManager = new KateModeManager();
+        });
+    }
+    return m_modeManager;
+}
+
+KateScriptManager *KTextEditor::EditorPrivate::scriptManager()
+{
+    if (!m_scriptManager) {
+        // search scripts
+        traceStartup("scriptManager", [this]() {
+            m_scriptManager = KateScriptManager::self();
+        });
+    }
+    return m_scriptManager;
+}
+
+KateHlManager *KTextEditor::EditorPrivate::hlManager()
+{
+    if (!m_hlManager) {
+        traceStartup("hlManager", [this]() {
+            m_hlManager = new KateHlManager();
+        });
+    }
+    return m_hlManager;
+}
+
+KateSpellCheckManager *KTextEditor::EditorPrivate::spellCheckManager()
+{
+    if (!m_spellCheckManager) {
+        traceStartup("spellCheckManager", [this]() {
+            m_spellCheckManager = new KateSpellCheckManager();
+        });
+    }
+    return m_spellCheckManager;
+}
+
+KateWordCompletionModel *KTextEditor::EditorPrivate::wordCompletionModel()
+{
+    if (!m_wordCompletionModel) {
+        traceStartup("wordCompletionModel", [this]() {
+            m_wordCompletionModel = new KateWordCompletionModel(this);
+        });
+    }
+    return m_wordCompletionModel;
+}
+
+KateKeywordCompletionModel *KTextEditor::EditorPrivate::keywordCompletionModel()
+{
+    if (!m_keywordCompletionModel) {
+        traceStartup("keywordCompletionModel", [this]() {
+            m_keywordCompletionModel = new KateKeywordCompletionModel(this);
+        });
+    }
+    return m_keywordCompletionModel;
+}
+
+const std::array<std::unique_ptr<KateAbstractInputModeFactory>, KTextEditor::View::ViInputMode + 1> &KTextEditor::EditorPrivate::inputModeFactories()
+{
+    if (!m_inputModeFactories[KTextEditor::View::NormalInputMode]) {
+        traceStartup("inputModeFactories", [this]() {
+            Q_ASSERT(m_inputModeFactories.size() == KTextEditor::View::ViInputMode + 1);
+            m_inputModeFactories[KTextEditor::View::NormalInputMode].reset(new KateNormalInputModeFactory());
+            m_inputModeFactories[KTextEditor::View::ViInputMode].reset(new KateViInputModeFactory());
+        });
+    }
+    return m_inputModeFactories;
+}
+
 KTextEditor::Document *KTextEditor::EditorPrivate::createDocument(QObject *parent)
 {
     KTextEditor::DocumentPrivate *doc = new KTextEditor::DocumentPrivate(false, false, nullptr, parent);
@@ -440,16 +519,20 @@ void KTextEditor::EditorPrivate::deregisterView(KTextEditor::ViewPrivate *view)
 
 KTextEditor::Command *KTextEditor::EditorPrivate::queryCommand(const QString &cmd) const
 {
+    // the script manager registers the command line scripts, ensure they are there
+    const_cast<KTextEditor::EditorPrivate *>(this)->scriptManager();
     return m_cmdManager->queryCommand(cmd);
 }
 
 QList<KTextEditor::Command *> KTextEditor::EditorPrivate::commands() const
 {
+    const_cast<KTextEditor::EditorPrivate *>(this)->scriptManager();
     return m_cmdManager->commands();
 }
 
 QStringList KTextEditor::EditorPrivate::commandList() const
 {
+    const_cast<KTextEditor::EditorPrivate *>(this)->scriptManager();
     return m_cmdManager->commandList();
 }
 
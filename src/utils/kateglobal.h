@@ -24,6 +24,7 @@
 
 #include <array>
 #include <memory>
+#include <vector>
 
 class QStringListModel;
 
@@ -236,12 +237,10 @@ public:
     /**
      * global mode manager
      * used to manage the modes centrally
+     * created on first use
      * @return mode manager
      */
-    KateModeManager *modeManager()
-    {
-        return m_modeManager;
-    }
+    KateModeManager *modeManager();
 
     /**
      * fallback document config
@@ -272,20 +271,16 @@ public:
 
     /**
      * Global script collection
+     * created on first use
      */
-    KateScriptManager *scriptManager()
-    {
-        return m_scriptManager;
-    }
+    KateScriptManager *scriptManager();
 
     /**
      * hl manager
+     * created on first use
      * @return hl manager
      */
-    KateHlManager *hlManager()
-    {
-        return m_hlManager;
-    }
+    KateHlManager *hlManager();
 
     /**
      * command manager
@@ -298,30 +293,24 @@ public:
 
     /**
      * spell check manager
+     * created on first use
      * @return spell check manager
      */
-    KateSpellCheckManager *spellCheckManager()
-    {
-        return m_spellCheckManager;
-    }
+    KateSpellCheckManager *spellCheckManager();
 
     /**
      * global instance of the simple word completion mode
+     * created on first use
      * @return global instance of the simple word completion mode
      */
-    KateWordCompletionModel *wordCompletionModel()
-    {
-        return m_wordCompletionModel;
-    }
+    KateWordCompletionModel *wordCompletionModel();
 
     /**
      * Global instance of the language-aware keyword completion model
+     * created on first use
      * @return global instance of the keyword completion model
      */
-    KateKeywordCompletionModel *keywordCompletionModel()
-    {
-        return m_keywordCompletionModel;
-    }
+    KateKeywordCompletionModel *keywordCompletionModel();
 
     /**
      * query for command
@@ -398,11 +387,33 @@ public:
     }
 
     /**
-     * @return list of available input mode factories
+     * @return list of available input mode factories, created on first use
+     */
+    const std::array<std::unique_ptr<KateAbstractInputModeFactory>, KTextEditor::View::ViInputMode + 1> &inputModeFactories();
+
+    /**
+     * One entry of the startup trace, see startupTrace().
      */
-    const std::array<std::unique_ptr<KateAbstractInputModeFactory>, KTextEditor::View::ViInputMode + 1> &inputModeFactories()
+    struct StartupTraceEntry {
+        /**
+         * Name of the initialized subsystem, e.g. "hlManager"
+         */
+        QString subsystem;
+        /**
+         * Time needed to initialize the subsystem, in nanoseconds
+         */
+        qint64 elapsedNSecs = 0;
+    };
+
+    /**
+     * Timings of the initialization of the editor subsystems, in the order they got initialized.
+     * Subsystems are created lazily, entries are appended on first use.
+     * Each entry is logged, too, enable the kf.texteditor category on debug level to see them.
+     * @return startup trace
+     */
+    const std::vector<StartupTraceEntry> &startupTrace() const
     {
-        return m_inputModeFactories;
+        return m_startupTrace;
     }
 
     /**
@@ -454,6 +465,14 @@ private Q_SLOTS:
     void updateColorPalette();
 
 private:
+    /**
+     * Run the given initialization function and record its timing in the startup trace.
+     * @param subsystem name of the subsystem that is initialized
+     * @param init initialization function
+     */
+    template<typename Init>
+    void traceStartup(const char *subsystem, Init init);
+
     /**
      * about data (authors and more)
      */
@@ -477,7 +496,7 @@ private:
     /**
      * mode manager
      */
-    KateModeManager *m_modeManager;
+    KateModeManager *m_modeManager = nullptr;
 
     /**
      * global config
@@ -507,12 +526,12 @@ private:
     /**
      * script manager
      */
-    KateScriptManager *m_scriptManager;
+    KateScriptManager *m_scriptManager = nullptr;
 
     /**
      * hl manager
      */
-    KateHlManager *m_hlManager;
+    KateHlManager *m_hlManager = nullptr;
 
     /**
      * command manager
@@ -527,17 +546,17 @@ private:
     /**
      * spell check manager
      */
-    KateSpellCheckManager *m_spellCheckManager;
+    KateSpellCheckManager *m_spellCheckManager = nullptr;
 
     /**
      * global instance of the simple word completion mode
      */
-    KateWordCompletionModel *m_wordCompletionModel;
+    KateWordCompletionModel *m_wordCompletionModel = nullptr;
 
     /**
      * global instance of the language-specific keyword completion model
      */
-    KateKeywordCompletionModel *m_keywordCompletionModel;
+    KateKeywordCompletionModel *m_keywordCompletionModel = nullptr;
 
     /**
      * clipboard history
@@ -586,6 +605,11 @@ private:
      * slot.
      */
     bool m_configWasChanged = false;
+
+    /**
+     * Timings of the subsystem initializations, see startupTrace().
+     */
+    std::vector<StartupTraceEntry> m_startupTrace;
 };
 
 }
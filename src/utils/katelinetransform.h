@@ -0,0 +1,77 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KATE_LINE_TRANSFORM_H
+#define KATE_LINE_TRANSFORM_H
+
+#include "katedocument.h"
+
+#include <QThread>
+#include <QThreadPool>
+
+#include <vector>
+
+/**
+ * Helper for range commands that compute the change of each line on its own,
+ * e.g. the replacements of a :%s over a huge document.
+ *
+ * The results are computed in parallel for many lines and returned in line order,
+ * the command then applies them in one edit transaction on the GUI thread.
+ */
+namespace KateLineTransform
+{
+// from this number of lines on, chunks of lines are computed in parallel
+constexpr int parallelTransformSize = 4096;
+
+/**
+ * Compute the result of each line from @p startLine to @p endLine of @p doc.
+ * @p makeTransform is called once per chunk of lines on the thread that handles the chunk,
+ * the function it returns is called with the line number and the line text of each line of
+ * the chunk. Neither may access the document, the line texts are collected before.
+ * @param doc document to read the lines of
+ * @param startLine first line
+ * @param endLine last line
+ * @param makeTransform factory of the per line function, state like regular expressions isn't shared between threads this way
+ * @return the results, index 0 for @p startLine
+ */
+template<typename Result, typename MakeTransform>
+std::vector<Result> transformLines(const KTextEditor::DocumentPrivate *doc, int startLine, int endLine, const MakeTransform &makeTransform)
+{
+    std::vector<QString> texts;
+    texts.reserve(qMax(0, endLine - startLine + 1));
+    for (int line = startLine; line <= endLine; ++line) {
+        texts.push_back(doc->line(line));
+    }
+
+    std::vector<Result> results(texts.size());
+    const auto transformChunk = [&](size_t begin, size_t end) {
+        const auto transform = makeTransform();
+        for (size_t i = begin; i < end; ++i) {
+            results[i] = transform(startLine + int(i), texts[i]);
+        }
+    };
+
+    const int threads = QThread::idealThreadCount();
+    if (texts.size() < size_t(parallelTransformSize) || threads < 2) {
+        transformChunk(0, texts.size());
+        return results;
+    }
+
+    // each chunk writes its own part of the results
+    QThreadPool pool;
+    for (int i = 0; i < threads; ++i) {
+        const size_t begin = texts.size() * i / threads;
+        const size_t end = texts.size() * (i + 1) / threads;
+        pool.start([&transformChunk, begin, end] {
+            transformChunk(begin, end);
+        });
+    }
+    pool.waitForDone();
+    return results;
+}
+}
+
+#endif
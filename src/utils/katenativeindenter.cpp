@@ -0,0 +1,1160 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "katenativeindenter.h"
+
+#include "katedocument.h"
+#include "kateview.h"
+
+#include <QRegularExpression>
+
+namespace
+{
+bool s_enabled = true;
+
+/**
+ * QString::at() that returns a null character for out of range positions,
+ * like String.charAt() in the scripts.
+ */
+inline QChar charAt(const QString &string, int column)
+{
+    return (column >= 0 && column < string.size()) ? string.at(column) : QChar();
+}
+
+// the trim functions of the script library only strip spaces and tabs
+inline bool isBlank(QChar c)
+{
+    return c == QLatin1Char(' ') || c == QLatin1Char('\t');
+}
+
+QString ltrim(const QString &string)
+{
+    int start = 0;
+    while (start < string.size() && isBlank(string.at(start))) {
+        ++start;
+    }
+    return string.mid(start);
+}
+
+QString rtrim(const QString &string)
+{
+    int end = string.size();
+    while (end > 0 && isBlank(string.at(end - 1))) {
+        --end;
+    }
+    return string.left(end);
+}
+
+QString trim(const QString &string)
+{
+    return ltrim(rtrim(string));
+}
+
+// BEGIN PythonIndenter
+/**
+ * Port of the python.js indentation script.
+ */
+class PythonIndenter : public KateNativeIndenter
+{
+public:
+    using KateNativeIndenter::KateNativeIndenter;
+
+    QString triggerCharacters() const override
+    {
+        return QStringLiteral(": ");
+    }
+
+    QPair<int, int> indent(KTextEditor::ViewPrivate *, const KTextEditor::Cursor position, QChar typedChar, int indentWidth) override
+    {
+        return qMakePair(indentLine(position.line(), indentWidth, typedChar), -2);
+    }
+
+private:
+    static int opening(QChar c)
+    {
+        return QStringView(u"([{").indexOf(c);
+    }
+
+    static int closing(QChar c)
+    {
+        return QStringView(u")]}").indexOf(c);
+    }
+
+    static bool hasTripleQuote(const QString &string)
+    {
+        return string.contains(QLatin1String("'''")) || string.contains(QLatin1String("\"\"\""));
+    }
+
+    /**
+     * Return the given line without comments and leading or trailing whitespace.
+     */
+    QString getCode(int lineNr, int virtcol = -1)
+    {
+        const QString line = m_document.line(lineNr);
+        virtcol = virtcol >= 0 ? virtcol : m_document.firstVirtualColumn(lineNr);
+        QString code;
+        if (virtcol < 0) {
+            return code;
+        }
+        for (; virtcol < line.size(); ++virtcol) {
+            if (m_document.isCode(lineNr, virtcol)) {
+                code += line.at(virtcol);
+            }
+        }
+        return trim(code);
+    }
+
+    /**
+     * Return the indent if an opening bracket is not closed, this is the
+     * position of the innermost opening bracket plus 1.
+     */
+    int calcOpeningIndent(int lineNr)
+    {
+        const QString line = m_document.line(lineNr);
+        int countClosing[3] = {0, 0, 0};
+        for (int i = line.size() - 1; i >= 0; --i) {
+            if (m_document.isComment(lineNr, i) || m_document.isString(lineNr, i)) {
+                continue;
+            }
+            const int closingIndex = closing(line.at(i));
+            if (closingIndex > -1) {
+                ++countClosing[closingIndex];
+            }
+            const int openingIndex = opening(line.at(i));
+            if (openingIndex > -1) {
+                if (countClosing[openingIndex] == 0) {
+                    return i + 1;
+                }
+                --countClosing[openingIndex];
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * Return the indent if a closing bracket was not opened on its line, this
+     * is the indentation of the line with the unmatched opening bracket.
+     */
+    int calcClosingIndent(int lineNr, int indentWidth)
+    {
+        const QString line = m_document.line(lineNr);
+        int countClosing[3] = {0, 0, 0};
+        for (int i = line.size() - 1; i >= 0; --i) {
+            if (m_document.isComment(lineNr, i) || m_document.isString(lineNr, i)) {
+                continue;
+            }
+            const int closingIndex = closing(line.at(i));
+            if (closingIndex > -1) {
+                ++countClosing[closingIndex];
+            }
+            const int openingIndex = opening(line.at(i));
+            if (openingIndex > -1) {
+                --countClosing[openingIndex];
+            }
+        }
+
+        if (countClosing[0] > 0 || countClosing[1] > 0 || countClosing[2] > 0) {
+            for (--lineNr; lineNr >= 0; --lineNr) {
+                if (calcOpeningIndent(lineNr) > -1) {
+                    const int indent = m_document.firstVirtualColumn(lineNr);
+                    if (shouldUnindent(lineNr + 1)) {
+                        return qMax(0, indent - indentWidth);
+                    }
+                    return indent;
+                }
+            }
+        }
+        return -1;
+    }
+
+    int calcBracketIndent(int lineNr, int indentWidth)
+    {
+        const int indent = calcOpeningIndent(lineNr - 1);
+        if (indent > -1) {
+            return indent;
+        }
+        return calcClosingIndent(lineNr - 1, indentWidth);
+    }
+
+    /**
+     * Return true if a single unindent should occur.
+     */
+    bool shouldUnindent(int lineNr)
+    {
+        static const QRegularExpression unindenters(QStringLiteral("\\b(continue|pass|raise|return|break)\\b"));
+        if (getCode(lineNr - 1).contains(unindenters)) {
+            return true;
+        }
+
+        // unindent if the last line was indented b/c of a backslash
+        if (lineNr >= 2) {
+            return getCode(lineNr - 2).endsWith(QLatin1Char('\\'));
+        }
+        return false;
+    }
+
+    int findLastIndent(int lineNr)
+    {
+        while (lineNr >= 0 && getCode(lineNr).isEmpty()) {
+            --lineNr;
+        }
+        return m_document.firstVirtualColumn(lineNr);
+    }
+
+    int getDocStringStart(int line)
+    {
+        const int firstColumn = m_document.firstVirtualColumn(line);
+        if (!m_document.isComment(line, firstColumn) || charAt(m_document.line(line), firstColumn) == QLatin1Char('#')) {
+            return -1;
+        }
+
+        int currentLine = line;
+        while (currentLine >= 0) {
+            const QString currentString = m_document.line(currentLine - 1);
+            if (charAt(currentString, m_document.firstVirtualColumn(currentLine - 1)) != QLatin1Char('#') && hasTripleQuote(currentString)) {
+                break;
+            }
+            --currentLine;
+        }
+        return currentLine - 1;
+    }
+
+    int getPrevDocStringEnd(int line)
+    {
+        int currentLine = line;
+        while (currentLine >= 0) {
+            if (hasTripleQuote(m_document.line(currentLine - 1))) {
+                break;
+            } else if (!getCode(currentLine - 1, 0).isEmpty()) {
+                return -1;
+            }
+            --currentLine;
+        }
+        return currentLine - 1;
+    }
+
+    int getMultiLineStringStart(int line)
+    {
+        if (!m_document.isString(line, m_document.firstVirtualColumn(line))) {
+            return -1;
+        }
+
+        int currentLine = line;
+        while (currentLine >= 0) {
+            if (!m_document.isComment(currentLine - 1, m_document.firstVirtualColumn(currentLine - 1)) && hasTripleQuote(m_document.line(currentLine - 1))) {
+                break;
+            }
+            --currentLine;
+        }
+        return currentLine - 1;
+    }
+
+    int getPrevMultiLineStringEnd(int line)
+    {
+        int currentLine = line;
+        while (currentLine >= 0) {
+            if (!m_document.isComment(currentLine - 1, m_document.firstVirtualColumn(currentLine - 1))) {
+                if (hasTripleQuote(m_document.line(currentLine - 1))) {
+                    break;
+                } else if (!getCode(currentLine - 1, 0).isEmpty()) {
+                    return -1;
+                }
+            }
+            --currentLine;
+        }
+        return currentLine - 1;
+    }
+
+    int indentLine(int line, int indentWidth, QChar character)
+    {
+        // don't ever act on document's first line or after an empty line
+        if (line == 0 || m_document.line(line - 1).isEmpty()) {
+            return -2;
+        }
+
+        if (!character.isNull() && triggerCharacters().contains(character)) {
+            static const QStringList immediateUnindenters = {QStringLiteral("else"), QStringLiteral("elif"), QStringLiteral("finally"), QStringLiteral("except")};
+            const int virtcol = m_document.firstVirtualColumn(line);
+            QString lline = getCode(line, virtcol);
+            if (character != QLatin1Char(' ')) {
+                lline.chop(1);
+            }
+            if (immediateUnindenters.contains(lline) && virtcol == findLastIndent(line - 1)
+                && lline.size() == m_document.line(line).size() - virtcol - 1) {
+                return qMax(0, virtcol - indentWidth);
+            }
+            return -2;
+        }
+
+        const int virtcol = m_document.firstVirtualColumn(line - 1);
+        const QString lastLine = getCode(line - 1, virtcol);
+        const QChar lastChar = lastLine.isEmpty() ? QChar() : lastLine.back();
+
+        // indent when opening bracket or backslash is at the end the previous line
+        if (opening(lastChar) >= 0 || lastChar == QLatin1Char('\\')) {
+            return virtcol + indentWidth;
+        }
+        int indent = calcBracketIndent(line, indentWidth);
+        if (lastLine.endsWith(QLatin1Char(':'))) {
+            if (indent > -1) {
+                indent += indentWidth;
+            } else {
+                indent = virtcol + indentWidth;
+            }
+        }
+
+        const int docStringStart = getDocStringStart(line);
+        if (docStringStart > -1) {
+            if (docStringStart == line) {
+                return -1;
+            }
+            return m_document.firstVirtualColumn(line) + m_document.firstVirtualColumn(docStringStart) - indentWidth;
+        }
+
+        const int multiLineStringStart = getMultiLineStringStart(line);
+        if (multiLineStringStart > -1) {
+            if (multiLineStringStart == line) {
+                return -1;
+            }
+            return -2;
+        }
+
+        if (indent == -1) {
+            const int prevMultiLineStringEnd = getPrevMultiLineStringEnd(line);
+            if (prevMultiLineStringEnd > -1) {
+                return m_document.firstVirtualColumn(getMultiLineStringStart(prevMultiLineStringEnd));
+            }
+            const int prevDocStringEnd = getPrevDocStringEnd(line);
+            if (prevDocStringEnd > -1) {
+                return m_document.firstVirtualColumn(getDocStringStart(prevDocStringEnd));
+            }
+        }
+
+        // continue, pass, raise, return etc. should unindent
+        if (indent == -1 && shouldUnindent(line)) {
+            indent = qMax(0, virtcol - indentWidth);
+        }
+        return indent;
+    }
+};
+// END PythonIndenter
+
+// BEGIN CStyleIndenter
+/**
+ * Port of the cstyle.js indentation script, with its default configuration:
+ * case and namespace contents are indented, '*' is inserted in C comments and
+ * a typed '/' closes them, no '//' is inserted in C++ comments and access
+ * modifiers are on the level of the class.
+ */
+class CStyleIndenter : public KateNativeIndenter
+{
+public:
+    using KateNativeIndenter::KateNativeIndenter;
+
+    QString triggerCharacters() const override
+    {
+        return QStringLiteral("{})/:;#");
+    }
+
+    QPair<int, int> indent(KTextEditor::ViewPrivate *view, const KTextEditor::Cursor position, QChar typedChar, int indentWidth) override
+    {
+        m_view = view;
+        m_indentWidth = indentWidth;
+        const int line = position.line();
+        m_mode = m_doc->highlightingModeAt(KTextEditor::Cursor(line, m_document.lineLength(line)));
+
+        const bool alignOnly = typedChar.isNull();
+        const int indentation = (typedChar != QLatin1Char('\n') && !alignOnly) ? processChar(line, typedChar) : indentLine(line, alignOnly);
+        m_view = nullptr;
+        return qMakePair(indentation, -2);
+    }
+
+private:
+    // maximum number of lines we look backwards/forward to find out the indentation level
+    static constexpr int lineDelimiter = 50;
+
+    QChar charAt(int line, int column) const
+    {
+        return m_doc->characterAt(KTextEditor::Cursor(line, column));
+    }
+
+    QChar firstChar(int line)
+    {
+        const QString c = m_document.firstChar(line);
+        return c.isEmpty() ? QChar() : c.at(0);
+    }
+
+    QChar lastChar(int line)
+    {
+        const QString c = m_document.lastChar(line);
+        return c.isEmpty() ? QChar() : c.at(0);
+    }
+
+    int cursorColumn() const
+    {
+        return m_view ? m_view->cursorPosition().column() : 0;
+    }
+
+    void setCursorPosition(int line, int column)
+    {
+        if (m_view) {
+            m_view->setCursorPosition(KTextEditor::Cursor(line, column));
+        }
+    }
+
+    /**
+     * Search for a corresponding '{' and return its indentation level, -1 if not found.
+     */
+    int findLeftBrace(int line, int column)
+    {
+        KTextEditor::Cursor cursor = m_document.anchorInternal(line, column, QLatin1Char('{'));
+        if (!cursor.isValid()) {
+            return -1;
+        }
+        const KTextEditor::Cursor parenthesisCursor = tryParenthesisBeforeBrace(cursor.line(), cursor.column());
+        if (parenthesisCursor.isValid()) {
+            cursor = parenthesisCursor;
+        }
+        return m_document.firstVirtualColumn(cursor.line());
+    }
+
+    /**
+     * Find last non-empty line that is not inside a comment or preprocessor.
+     */
+    int lastNonEmptyLine(int line)
+    {
+        while (true) {
+            line = m_document.prevNonEmptyLine(line);
+            if (line == -1) {
+                return -1;
+            }
+            const QString string = ltrim(m_document.line(line));
+            if (string.startsWith(QLatin1String("//")) || string.startsWith(QLatin1Char('#'))) {
+                --line;
+                continue;
+            }
+            return line;
+        }
+    }
+
+    /**
+     * Character at (line, column) has to be a '{', if it is preceded by a ')'
+     * return the matching '('.
+     */
+    KTextEditor::Cursor tryParenthesisBeforeBrace(int line, int column)
+    {
+        const int firstColumn = m_document.firstColumn(line);
+        while (column > firstColumn && m_document.isSpace(line, --column)) { }
+        if (charAt(line, column) == QLatin1Char(')')) {
+            return m_document.anchorInternal(line, column, QLatin1Char('('));
+        }
+        return KTextEditor::Cursor::invalid();
+    }
+
+    /**
+     * Check for default and case keywords and return the indentation of the
+     * previous default, case or switch.
+     */
+    int trySwitchStatement(int line)
+    {
+        static const QRegularExpression caseRegex(QStringLiteral("^\\s*(default\\s*|case\\b.*):"));
+        static const QRegularExpression switchRegex(QStringLiteral("^\\s*switch\\b"));
+
+        if (!m_document.line(line).contains(caseRegex)) {
+            return -1;
+        }
+
+        int indentation = -1;
+        int delimiter = lineDelimiter;
+        int currentLine = line;
+        while (currentLine > 0 && delimiter > 0) {
+            --currentLine;
+            --delimiter;
+            if (m_document.firstColumn(currentLine) == -1) {
+                continue;
+            }
+
+            const QString currentString = m_document.line(currentLine);
+            if (currentString.contains(caseRegex)) {
+                indentation = m_document.firstVirtualColumn(currentLine);
+                break;
+            } else if (currentString.contains(switchRegex)) {
+                indentation = m_document.firstVirtualColumn(currentLine) + m_indentWidth;
+                break;
+            }
+        }
+        return indentation;
+    }
+
+    /**
+     * Check for private, protected, public, signals etc. and return the
+     * indentation of the enclosing class.
+     */
+    int tryAccessModifiers(int line)
+    {
+        static const QRegularExpression accessRegex(QStringLiteral("^\\s*((public|protected|private)\\s*(slots|Q_SLOTS)?|(signals|Q_SIGNALS)\\s*):\\s*$"));
+        if (!m_document.line(line).contains(accessRegex)) {
+            return -1;
+        }
+
+        const KTextEditor::Cursor cursor = m_document.anchorInternal(line, 0, QLatin1Char('{'));
+        if (!cursor.isValid()) {
+            return -1;
+        }
+        return m_document.firstVirtualColumn(cursor.line());
+    }
+
+    /**
+     * Don't indent inside a multi-line string literal continued with '\'.
+     */
+    int tryString(int line)
+    {
+        // go line up as long as the previous line ends with an escape character '\'
+        int currentLine = line;
+        while (currentLine >= 0) {
+            if (::charAt(m_document.line(currentLine - 1), m_document.lastColumn(currentLine - 1)) != QLatin1Char('\\')) {
+                break;
+            }
+            --currentLine;
+        }
+
+        // iterate through all lines and toggle insideString for every quote
+        bool insideString = false;
+        for (; currentLine < line; ++currentLine) {
+            const QString currentString = m_document.line(currentLine);
+            for (int i = 0; i < currentString.size(); ++i) {
+                const QChar c = currentString.at(i);
+                if (c == QLatin1Char('\\')) {
+                    // skip escaped character
+                    ++i;
+                } else if (c == QLatin1Char('"')) {
+                    insideString = !insideString;
+                }
+            }
+        }
+        return insideString ? 0 : -1;
+    }
+
+    /**
+     * C comment checking. Continues an open C comment block and inserts the
+     * leading '*', or aligns on the opening of a just closed comment.
+     */
+    int tryCComment(int line)
+    {
+        const int currentLine = m_document.prevNonEmptyLine(line - 1);
+        if (currentLine < 0) {
+            return -1;
+        }
+
+        // we found a */, search the opening /* and return its indentation level
+        if (m_document.endsWith(currentLine, QStringLiteral("*/"), true)) {
+            const KTextEditor::Cursor cursor = m_document.rfindInternal(currentLine, m_document.lastColumn(currentLine), QStringLiteral("/*"));
+            if (cursor.isValid() && cursor.column() == m_document.firstColumn(cursor.line())) {
+                return m_document.firstVirtualColumn(cursor.line());
+            }
+            return -1;
+        }
+
+        // inbetween was an empty line, so do not copy the "*" character
+        if (currentLine != line - 1) {
+            return -1;
+        }
+
+        int indentation = -1;
+        const int firstPos = m_document.firstColumn(currentLine);
+        const QChar char1 = charAt(currentLine, firstPos);
+        const QChar char2 = charAt(currentLine, firstPos + 1);
+
+        if (char1 == QLatin1Char('/') && char2 == QLatin1Char('*') && !m_document.line(currentLine).contains(QLatin1String("*/"))) {
+            indentation = m_document.firstVirtualColumn(currentLine) + 1;
+            // only add '*', if there is none yet.
+            if (firstChar(line) != QLatin1Char('*')) {
+                m_document.insertText(line, cursorColumn(), QStringLiteral("*"));
+            }
+            if (!m_document.isSpace(line, m_document.firstColumn(line) + 1) && !m_document.endsWith(line, QStringLiteral("*/"), true)) {
+                m_document.insertText(line, m_document.firstColumn(line) + 1, QStringLiteral(" "));
+            }
+        } else if (char1 == QLatin1Char('*')) {
+            int commentLine = currentLine;
+            while (commentLine >= 0 && firstChar(commentLine) == QLatin1Char('*') && !m_document.endsWith(commentLine, QStringLiteral("*/"), true)) {
+                --commentLine;
+            }
+            if (commentLine < 0) {
+                indentation = m_document.firstVirtualColumn(currentLine);
+            } else if (m_document.startsWith(commentLine, QStringLiteral("/*"), true) && !m_document.endsWith(commentLine, QStringLiteral("*/"), true)) {
+                // found a /*, and all succeeding lines start with a *, so it's a comment block
+                indentation = m_document.firstVirtualColumn(currentLine);
+
+                // only add '*', if there is none yet.
+                if (firstChar(line) != QLatin1Char('*')) {
+                    m_document.insertText(line, cursorColumn(), QStringLiteral("*"));
+                    if (!m_document.isSpace(line, m_document.firstColumn(line) + 1)) {
+                        m_document.insertText(line, m_document.firstColumn(line) + 1, QStringLiteral(" "));
+                    }
+                }
+            }
+        }
+        return indentation;
+    }
+
+    /**
+     * If the last non-empty line ends with a { or [, take its indentation level
+     * (or the one found by tryParenthesisBeforeBrace()) and increase it.
+     */
+    int tryBrace(int line)
+    {
+        static const QRegularExpression braceRegex(QStringLiteral("\\{[^\\}]*$"));
+
+        const int currentLine = lastNonEmptyLine(line - 1);
+        if (currentLine < 0) {
+            return -1;
+        }
+
+        const QString currentString = m_document.line(currentLine);
+        int matchColumn = currentString.indexOf(braceRegex);
+        // line ends with [, e.g., array in js or dart
+        if (matchColumn == -1 && currentString.endsWith(QLatin1Char('['))) {
+            matchColumn = currentString.size() - 1;
+        }
+        if (matchColumn == -1 || !m_document.isCode(currentLine, matchColumn)) {
+            return -1;
+        }
+
+        const KTextEditor::Cursor cursor = tryParenthesisBeforeBrace(currentLine, m_document.lastColumn(currentLine));
+        if (cursor.isValid()) {
+            return m_document.firstVirtualColumn(cursor.line()) + m_indentWidth;
+        }
+        return m_document.firstVirtualColumn(currentLine) + m_indentWidth;
+    }
+
+    /**
+     * Check for if, else, while, do, switch, private, public, protected, signals,
+     * default, case etc. keywords, as we want to indent then. If @p isBrace is
+     * true, the indentation is not increased.
+     */
+    int tryCKeywords(int line, bool isBrace)
+    {
+        static const QRegularExpression keywordRegex(
+            QStringLiteral("^\\s*(if\\b|for(each)?|do\\b|while|switch|[}]?\\s*else(if)?|((private|public|protected|case|default|signals|Q_SIGNALS).*:))"));
+        static const QRegularExpression conditionRegex(QStringLiteral("^\\s*(if\\b|for(each)?|do\\b|while|switch|[}]?\\s*else(if)?)"));
+
+        int currentLine = lastNonEmptyLine(line - 1);
+        if (currentLine < 0) {
+            return -1;
+        }
+
+        // if line ends with ')', find the '(' and check this line then.
+        int lastPos = m_document.lastColumn(currentLine);
+        KTextEditor::Cursor cursor = KTextEditor::Cursor::invalid();
+        if (charAt(currentLine, lastPos) == QLatin1Char(')')) {
+            cursor = m_document.anchorInternal(currentLine, lastPos, QLatin1Char('('));
+        }
+        if (cursor.isValid()) {
+            currentLine = cursor.line();
+        }
+
+        QString currentString = m_document.line(currentLine);
+        if (!currentString.contains(keywordRegex)) {
+            return -1;
+        }
+        lastPos = m_document.lastColumn(currentLine);
+        QChar lastChar = ::charAt(currentString, lastPos);
+
+        // ignore trailing comments see: https://bugs.kde.org/show_bug.cgi?id=189339
+        const int commentPos = currentString.indexOf(QLatin1String("//"));
+        if (commentPos != -1) {
+            currentString = rtrim(currentString.left(commentPos));
+            lastChar = ::charAt(currentString, currentString.size() - 1);
+        }
+
+        int indentation = -1;
+        // try to ignore lines like: if (a) b; or if (a) { b; }
+        if (lastChar != QLatin1Char(';') && lastChar != QLatin1Char('}')) {
+            // take its indentation and add one indentation level
+            indentation = m_document.firstVirtualColumn(currentLine);
+            if (!isBrace) {
+                indentation += m_indentWidth;
+            }
+        } else if (lastChar == QLatin1Char(';')) {
+            // stuff like:
+            // for(int b;
+            //     b < 10;
+            //     --b)
+            cursor = m_document.anchorInternal(currentLine, lastPos, QLatin1Char('('));
+            if (cursor.isValid()) {
+                // same line, we know there is a keyword here, otherwise check
+                // that the cursor's line contains a keyword and isn't a func call
+                if (cursor.line() == line || m_document.line(cursor.line()).contains(conditionRegex)) {
+                    indentation = m_document.toVirtualColumn(cursor.line(), cursor.column() + 1);
+                }
+            }
+        }
+        return indentation;
+    }
+
+    /**
+     * Is this line a single statement of a condition without braces.
+     */
+    bool isSingleStmtCondition(int line)
+    {
+        static const QRegularExpression conditionRegex(QStringLiteral("^\\s*(if\\b|[}]?\\s*else(if)?\\b|do\\b|while\\b|for(each)?\\b)"));
+        if (line > 1) {
+            const QString prevText = m_document.line(lastNonEmptyLine(line - 1));
+            return prevText.contains(conditionRegex) && !prevText.contains(QLatin1Char('{'));
+        }
+        return false;
+    }
+
+    /**
+     * Search for if, do, while, for, ... as we want to indent then.
+     */
+    int tryCondition(int line)
+    {
+        static const QRegularExpression conditionRegex(QStringLiteral("^\\s*(if\\b|[}]?\\s*else(if)?\\b|do\\b|while\\b|for(each)?\\b)"));
+        static const QRegularExpression openConditionRegex(QStringLiteral("^\\s*(if\\b|[}]?\\s*else(if)?|do\\b|while\\b|for(each)?)[^{]*$"));
+
+        int currentLine = lastNonEmptyLine(line - 1);
+        if (currentLine < 0) {
+            return -1;
+        }
+
+        const QString currentString = m_document.line(currentLine);
+        if (::charAt(currentString, m_document.lastColumn(currentLine)) != QLatin1Char(';') || currentString.contains(conditionRegex)) {
+            return -1;
+        }
+
+        // idea: we had something like:
+        //   if/while/for (expression)
+        //       statement();  <-- we catch this trailing ';'
+        // Now, look for a line that starts with if/for/while, that has one
+        // indent level less.
+        const int currentIndentation = m_document.firstVirtualColumn(currentLine);
+        if (currentIndentation == 0) {
+            return -1;
+        }
+
+        // is this a condition with only one statement in it
+        if (isSingleStmtCondition(currentLine)) {
+            const int leftBrace = findLeftBrace(currentLine, 0);
+            if (leftBrace != -1) {
+                return leftBrace + m_indentWidth;
+            }
+        }
+
+        int delimiter = 10;
+        while (currentLine > 0 && delimiter > 0) {
+            --currentLine;
+            --delimiter;
+            const int firstPosVirtual = m_document.firstVirtualColumn(currentLine);
+            if (firstPosVirtual == -1) {
+                continue;
+            }
+
+            if (firstPosVirtual < currentIndentation) {
+                return m_document.line(currentLine).contains(openConditionRegex) ? firstPosVirtual : -1;
+            } else if (currentLine == 0 || delimiter == 0) {
+                return -1;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * If the non-empty line ends with ); or ',', then search for '(' and return
+     * its indentation; also try to ignore trailing comments.
+     */
+    int tryStatement(int line)
+    {
+        static const QRegularExpression statementRegex(QStringLiteral("^(.*)(,|\"|'|\\))(;?)\\s*[\\.+]?\\s*(\\/\\/.*|\\/\\*.*\\*\\/\\s*)?$"));
+        static const QRegularExpression includeRegex(QStringLiteral("^#include"));
+
+        int currentLine = lastNonEmptyLine(line - 1);
+        if (currentLine < 0) {
+            return -1;
+        }
+
+        int indentation = -1;
+        QString currentString = m_document.line(currentLine);
+        if (currentString.endsWith(QLatin1Char('('))) {
+            // increase indent level
+            return m_document.firstVirtualColumn(currentLine) + m_indentWidth;
+        }
+
+        const QRegularExpressionMatch result = statementRegex.match(currentString);
+        if (!result.hasMatch()) {
+            if (rtrim(currentString).endsWith(QLatin1Char(';'))) {
+                indentation = m_document.firstVirtualColumn(currentLine);
+            }
+            return indentation;
+        }
+
+        // align on strings "..."\n => below the opening quote
+        const bool alignOnSingleQuote = m_mode == QLatin1String("PHP/PHP") || m_mode == QLatin1String("JavaScript");
+        const int prefixLength = result.capturedLength(1);
+        const QChar terminator = result.captured(2).at(0);
+        const bool isQuote = terminator == QLatin1Char('"') || terminator == QLatin1Char('\'');
+        const bool alignOnAnchor = result.capturedLength(3) == 0 && terminator != QLatin1Char(')');
+
+        // search for opening ", ' or (
+        KTextEditor::Cursor cursor = KTextEditor::Cursor::invalid();
+        if (terminator == QLatin1Char('"') || (alignOnSingleQuote && terminator == QLatin1Char('\''))) {
+            while (true) {
+                // start from matched closing ' or ", this keeps the column of
+                // the first line when going up, like the script does
+                int i = prefixLength - 1;
+                // find string opener
+                for (; i >= 0; --i) {
+                    // make sure it's not escaped
+                    if (::charAt(currentString, i) == terminator && (i == 0 || ::charAt(currentString, i - 1) != QLatin1Char('\\'))) {
+                        // also make sure that this is not a line like '#include "..."' <-- we don't want to indent here
+                        if (currentString.contains(includeRegex) || currentString.contains(QLatin1String("'use strict'"))) {
+                            return indentation;
+                        }
+                        cursor = KTextEditor::Cursor(currentLine, i);
+                        break;
+                    }
+                }
+                if (alignOnAnchor || currentLine == 0) {
+                    break;
+                }
+
+                // when we finished the statement (;) we need to get the first line and use its indentation
+                // i.e.: $foo = "asdf"; -> align on $
+                --i; // skip " or '
+                // skip whitespaces and stuff like + or . (for PHP, JavaScript, ...)
+                for (; i >= 0; --i) {
+                    const QChar c = ::charAt(currentString, i);
+                    if (c != QLatin1Char(' ') && c != QLatin1Char('\t') && c != QLatin1Char('.') && c != QLatin1Char('+')) {
+                        break;
+                    }
+                }
+                if (i > 0) {
+                    // there's something in this line, use its indentation
+                    break;
+                }
+                // go to previous line
+                --currentLine;
+                currentString = m_document.line(currentLine);
+            }
+        } else if (terminator == QLatin1Char(',') && !currentString.contains(QLatin1Char('('))) {
+            // assume a function call: check for '(' brace
+            // - if not found, use previous indentation
+            // - if found, compare the indentation depth of current line and open brace line
+            //   - if current indentation depth is smaller, use that
+            //   - otherwise, use the '(' indentation + following white spaces
+            const int currentIndentation = m_document.firstVirtualColumn(currentLine);
+            const KTextEditor::Cursor braceCursor = m_document.anchorInternal(currentLine, prefixLength, QLatin1Char('('));
+            if (!braceCursor.isValid() || currentIndentation < braceCursor.column()) {
+                indentation = currentIndentation;
+            } else {
+                indentation = braceCursor.column() + 1;
+                while (m_document.isSpace(braceCursor.line(), indentation)) {
+                    ++indentation;
+                }
+            }
+        } else if (m_mode == QLatin1String("Dart") && terminator == QLatin1Char(',') && currentString.contains(QLatin1Char('('))
+                   && currentString.contains(QLatin1Char(')'))) {
+            // Dart has a lot of stuff and function calls inside ctors
+            // and code is not aligned at the opening paren hence:
+            // do nothing
+        } else {
+            cursor = m_document.anchorInternal(currentLine, prefixLength, QLatin1Char('('));
+        }
+
+        if (cursor.isValid()) {
+            currentLine = cursor.line();
+            if (alignOnAnchor) {
+                int column = cursor.column();
+                bool inc = false;
+                if (!isQuote) {
+                    // place one column after the opening parens
+                    ++column;
+                    inc = true;
+                }
+                const int lastColumn = m_document.lastColumn(currentLine);
+                while (column < lastColumn && m_document.isSpace(currentLine, column)) {
+                    ++column;
+                    inc = true;
+                }
+                indentation = inc ? m_document.toVirtualColumn(currentLine, column) : m_document.firstVirtualColumn(currentLine);
+            } else {
+                indentation = m_document.firstVirtualColumn(currentLine);
+            }
+        }
+        return indentation;
+    }
+
+    /**
+     * Find out whether we pressed return in something like {} or () or [] and
+     * indent properly, moving the closing anchor to the next line.
+     */
+    int tryMatchedAnchor(int line, bool alignOnly)
+    {
+        const QChar c = firstChar(line);
+        if (c != QLatin1Char('}') && c != QLatin1Char(')') && c != QLatin1Char(']')) {
+            return -1;
+        }
+        // we pressed enter in e.g. ()
+        const KTextEditor::Cursor closingAnchor = m_document.anchorInternal(line, 0, c);
+        if (!closingAnchor.isValid()) {
+            // nothing found, continue with other cases
+            return -1;
+        }
+        if (alignOnly) {
+            // when aligning only, don't be too smart and just take the indent level of the open anchor
+            return m_document.firstVirtualColumn(closingAnchor.line());
+        }
+
+        const QChar last = lastChar(line - 1);
+        const bool charsMatch = (last == QLatin1Char('(') && c == QLatin1Char(')')) || (last == QLatin1Char('{') && c == QLatin1Char('}'))
+            || (last == QLatin1Char('[') && c == QLatin1Char(']'));
+        const int anchorColumn = m_document.toVirtualColumn(closingAnchor.line(), closingAnchor.column());
+        if (!charsMatch && c != QLatin1Char('}')) {
+            // otherwise check whether the last line has the expected
+            // indentation, if not use it instead and place the closing
+            // anchor on the level of the opening anchor
+            const int expectedIndentation = m_document.firstVirtualColumn(closingAnchor.line()) + m_indentWidth;
+            const int actualIndentation = m_document.firstVirtualColumn(line - 1);
+            if (expectedIndentation <= actualIndentation) {
+                if (last == QLatin1Char(',') && c != QLatin1Char(')')) {
+                    // use indentation of last line instead and place closing anchor
+                    // in same column of the opening anchor
+                    m_document.insertText(line, m_document.firstColumn(line), QStringLiteral("\n"));
+                    setCursorPosition(line, actualIndentation);
+                    // indent closing anchor
+                    m_doc->indent(KTextEditor::Range(line + 1, 0, line + 1, 1), anchorColumn / m_indentWidth);
+                    // make sure we add spaces to align perfectly on closing anchor,
+                    // the script inserts them at the start of the line
+                    const int padding = anchorColumn % m_indentWidth;
+                    if (padding > 0) {
+                        m_document.insertText(line + 1, 0, QString(padding, QLatin1Char(' ')));
+                    }
+                    return actualIndentation;
+                } else if (expectedIndentation == actualIndentation) {
+                    // otherwise don't add a new line, just use indentation of closing anchor line
+                    return m_document.firstVirtualColumn(closingAnchor.line());
+                }
+                // otherwise don't add a new line, just align on closing anchor
+                return anchorColumn + 1;
+            } else if (last == QLatin1Char(',')) {
+                return anchorColumn + 1;
+            }
+        }
+
+        // otherwise we i.e. pressed enter between (), [] or when we enter before curly brace
+        // increase indentation and place closing anchor on the next line
+        const int indentation = m_document.firstVirtualColumn(closingAnchor.line());
+        m_document.insertText(line, m_document.firstColumn(line), QStringLiteral("\n"));
+        setCursorPosition(line, indentation);
+        // indent closing brace
+        m_doc->indent(KTextEditor::Range(line + 1, 0, line + 1, 1), indentation / m_indentWidth);
+        return indentation + m_indentWidth;
+    }
+
+    /**
+     * Keep the indentation inside C++ raw string literals.
+     * Returns -2 for raw strings without delimiter, the script bails out with
+     * an exception for those and leaves the line alone.
+     */
+    int tryMultiLineStringLiteral(int line)
+    {
+        // the algorithm in this function is only valid for C++, don't waste time for other languages
+        if (!m_mode.contains(QLatin1String("C++"))) {
+            return -1;
+        }
+
+        static const QRegularExpression startRegex(QStringLiteral("R\"(.+)?\\("));
+
+        // go line up until we find something of form R"[delim](, but not too far
+        int currentLine = line;
+        QString delim;
+        bool found = false;
+        for (int limit = 0; currentLine >= 0; ++limit) {
+            const QRegularExpressionMatch startMatch = startRegex.match(m_document.line(currentLine - 1));
+            if (startMatch.hasMatch()) {
+                found = true;
+                delim = startMatch.captured(1);
+                --currentLine;
+                break;
+            }
+            --currentLine;
+            if (limit >= 25) {
+                break;
+            }
+        }
+
+        if (!found) {
+            return -1;
+        }
+        if (delim.isEmpty()) {
+            return -2;
+        }
+
+        // check whether the literal ended before this line
+        const QString endMarker = QLatin1Char(')') + delim + QLatin1Char('"');
+        for (; currentLine < line; ++currentLine) {
+            if (m_document.line(currentLine).contains(endMarker)) {
+                return -1;
+            }
+        }
+        return m_document.firstVirtualColumn(line);
+    }
+
+    int indentLine(int line, bool alignOnly)
+    {
+        int filler = tryMatchedAnchor(line, alignOnly);
+        if (filler == -1) {
+            filler = tryCComment(line);
+        }
+        if (filler == -1) {
+            filler = tryMultiLineStringLiteral(line);
+        }
+        if (filler == -1) {
+            filler = tryString(line);
+        }
+        if (filler == -1) {
+            filler = trySwitchStatement(line);
+        }
+        if (filler == -1) {
+            filler = tryAccessModifiers(line);
+        }
+        if (filler == -1) {
+            filler = tryBrace(line);
+        }
+        if (filler == -1) {
+            filler = tryCKeywords(line, firstChar(line) == QLatin1Char('{'));
+        }
+        if (filler == -1) {
+            filler = tryCondition(line);
+        }
+        if (filler == -1) {
+            filler = tryStatement(line);
+        }
+        return filler;
+    }
+
+    int processChar(int line, QChar c)
+    {
+        if (c == QLatin1Char(';') || !triggerCharacters().contains(c) || !m_view) {
+            return -2;
+        }
+
+        const int column = m_view->cursorPosition().column();
+        const int firstPos = m_document.firstColumn(line);
+        const int prevFirstPos = m_document.firstColumn(line - 1);
+        const int lastPos = m_document.lastColumn(line);
+
+        if (firstPos == column - 1 && c == QLatin1Char('{')) {
+            int filler = tryBrace(line);
+            if (filler == -1) {
+                filler = tryCKeywords(line, true);
+            }
+            if (filler == -1) {
+                filler = tryCComment(line); // checks, whether we had a "*/"
+            }
+            if (filler == -1) {
+                filler = tryStatement(line);
+            }
+            return filler == -1 ? -2 : filler;
+        } else if (firstPos == column - 1 && c == QLatin1Char('}') && charAt(line, column - 1) == QLatin1Char('}')) {
+            // unindent after closing brace, but not when brace is auto inserted (i.e., behind cursor)
+            const int indentation = findLeftBrace(line, firstPos);
+            return indentation == -1 ? -2 : indentation;
+        } else if (firstPos == column - 1 && c == QLatin1Char('}') && firstPos > prevFirstPos) {
+            // align indentation to previous line when creating new block with auto brackets enabled
+            // prevents over-indentation for if blocks and loops
+            return m_document.toVirtualColumn(line - 1, prevFirstPos);
+        } else if (c == QLatin1Char('/') && lastPos == column - 1) {
+            // try to snap the string "* /" to "*/"
+            static const QRegularExpression snapRegex(QStringLiteral("^(\\s*)\\*\\s+\\/\\s*$"));
+            const QRegularExpressionMatch match = snapRegex.match(m_document.line(line));
+            if (match.hasMatch()) {
+                const QString currentString = match.captured(1) + QLatin1String("*/");
+                m_document.editBegin();
+                m_document.removeLine(line);
+                m_document.insertLine(line, currentString);
+                setCursorPosition(line, currentString.size());
+                m_document.editEnd();
+            }
+            return -2;
+        } else if (c == QLatin1Char(':')) {
+            int filler = trySwitchStatement(line);
+            if (filler == -1) {
+                filler = tryAccessModifiers(line);
+            }
+            return filler == -1 ? -2 : filler;
+        } else if (c == QLatin1Char(')') && firstPos == column - 1) {
+            // align on start of identifier of function call
+            const KTextEditor::Cursor openParen = m_document.anchorInternal(line, column - 1, QLatin1Char('('));
+            if (openParen.isValid()) {
+                static const QRegularExpression identifierRegex(QStringLiteral("\\b(\\w+)\\s*$"));
+                // strip starting from opening paren
+                const QString callLine = m_document.line(openParen.line()).left(qMax(0, openParen.column() - 1));
+                const int indentation = callLine.indexOf(identifierRegex);
+                if (indentation != -1) {
+                    return m_document.toVirtualColumn(openParen.line(), indentation);
+                }
+            }
+        } else if (firstPos == column - 1 && c == QLatin1Char('#')
+                   && (m_mode == QLatin1String("C") || m_mode == QLatin1String("C++") || m_mode == QLatin1String("ISO C++"))) {
+            // always put preprocessor stuff upfront
+            return 0;
+        }
+        return -2;
+    }
+
+    KTextEditor::ViewPrivate *m_view = nullptr;
+    int m_indentWidth = 4;
+    QString m_mode;
+};
+// END CStyleIndenter
+
+struct NativeIndenterEntry {
+    const char *name;
+    std::unique_ptr<KateNativeIndenter> (*create)(KTextEditor::DocumentPrivate *doc);
+};
+
+template<typename Indenter>
+std::unique_ptr<KateNativeIndenter> createIndenter(KTextEditor::DocumentPrivate *doc)
+{
+    return std::make_unique<Indenter>(doc);
+}
+
+// the registry, keyed by the base name of the indentation script that is replaced
+const NativeIndenterEntry nativeIndenters[] = {
+    {"cstyle", &createIndenter<CStyleIndenter>},
+    {"python", &createIndenter<PythonIndenter>},
+};
+}
+
+KateNativeIndenter::KateNativeIndenter(KTextEditor::DocumentPrivate *doc)
+    : m_doc(doc)
+    , m_document(nullptr)
+{
+    m_document.setDocument(doc);
+}
+
+KateNativeIndenter::~KateNativeIndenter() = default;
+
+std::unique_ptr<KateNativeIndenter> KateNativeIndenter::create(const QString &name, KTextEditor::DocumentPrivate *doc)
+{
+    for (const auto &entry : nativeIndenters) {
+        if (name == QLatin1String(entry.name)) {
+            return entry.create(doc);
+        }
+    }
+    return nullptr;
+}
+
+void KateNativeIndenter::setEnabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+bool KateNativeIndenter::isEnabled()
+{
+    return s_enabled;
+}
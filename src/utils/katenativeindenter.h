@@ -0,0 +1,84 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KATE_NATIVE_INDENTER_H
+#define KATE_NATIVE_INDENTER_H
+
+#include "katescriptdocument.h"
+
+#include <ktexteditor_export.h>
+
+#include <QPair>
+#include <QString>
+
+#include <memory>
+
+namespace KTextEditor
+{
+class DocumentPrivate;
+class ViewPrivate;
+}
+
+/**
+ * Base class for indenters implemented in C++.
+ *
+ * Native indenters are drop-in replacements for the JavaScript indentation
+ * scripts of the same name: the script still provides the mode (name, header,
+ * required style), but KateAutoIndent calls the native implementation instead
+ * of the script engine whenever one is registered for the mode and the script is
+ * the bundled one, user provided scripts of the same name are still used.
+ *
+ * The return value of indent() follows the contract of the indent() function of
+ * the indentation scripts: -2 means do nothing, -1 keeps the indentation of the
+ * previous line, values >= 0 are the new indentation and alignment in characters.
+ */
+class KTEXTEDITOR_EXPORT KateNativeIndenter
+{
+public:
+    explicit KateNativeIndenter(KTextEditor::DocumentPrivate *doc);
+    virtual ~KateNativeIndenter();
+
+    KateNativeIndenter(const KateNativeIndenter &) = delete;
+    KateNativeIndenter &operator=(const KateNativeIndenter &) = delete;
+
+    /**
+     * Create the native indenter registered for the indentation mode @p name.
+     * Only to be used if the mode is provided by the bundled script, the native
+     * indenter implements that one and not overrides installed by the user.
+     * @return the indenter or nullptr if there is none for this mode
+     */
+    static std::unique_ptr<KateNativeIndenter> create(const QString &name, KTextEditor::DocumentPrivate *doc);
+
+    /**
+     * Globally enable or disable the native indenters, the indentation scripts
+     * are used while disabled. Enabled by default, used by the unit tests to
+     * check both implementations against the same data.
+     */
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * Characters that trigger indent() beside the newline.
+     */
+    virtual QString triggerCharacters() const = 0;
+
+    /**
+     * Compute the indentation of the line of @p position.
+     * @param view the view the user is typing in, may be nullptr when aligning
+     * @param typedChar the typed character, null if the line should just be aligned
+     */
+    virtual QPair<int, int> indent(KTextEditor::ViewPrivate *view, const KTextEditor::Cursor position, QChar typedChar, int indentWidth) = 0;
+
+protected:
+    KTextEditor::DocumentPrivate *const m_doc;
+
+    /**
+     * The helpers of the script API, used without script engine.
+     */
+    KateScriptDocument m_document;
+};
+
+#endif
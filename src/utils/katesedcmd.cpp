@@ -11,6 +11,7 @@
 #include "katecmd.h"
 #include "katedocument.h"
 #include "kateglobal.h"
+#include "katelinetransform.h"
 #include "katepartdebug.h"
 #include "kateview.h"
 
@@ -20,6 +21,8 @@
 #include <QRegularExpression>
 #include <QUrl>
 
+#include <atomic>
+
 KateCommands::SedReplace *KateCommands::SedReplace::m_instance = nullptr;
 
 static int backslashString(const QString &haystack, const QString &needle, int index)
@@ -179,7 +182,7 @@ KateCommands::SedReplace::InteractiveSedReplacer::InteractiveSedReplacer(KTextEd
                                                                          int startLine,
                                                                          int endLine)
     : m_findPattern(findPattern)
-    , m_replacePattern(replacePattern)
+    , m_replacement(replacePattern)
     , m_onlyOnePerLine(onlyOnePerLine)
     , m_endLine(endLine)
     , m_doc(doc)
@@ -257,12 +260,133 @@ void KateCommands::SedReplace::InteractiveSedReplacer::replaceCurrentMatch()
 void KateCommands::SedReplace::InteractiveSedReplacer::replaceAllRemaining()
 {
     m_doc->editBegin();
-    while (currentMatch().isValid()) {
-        replaceCurrentMatch();
+    if (!replaceAllRemainingInLines()) {
+        while (currentMatch().isValid()) {
+            replaceCurrentMatch();
+        }
     }
     m_doc->editEnd();
 }
 
+// the pattern only depends on the text of the line behind the search position, so matching
+// the unchanged line finds the same as searching again behind each replacement
+static bool matchesIndependentOfReplacements(const QString &pattern)
+{
+    for (int i = 0; i + 1 < pattern.size(); ++i) {
+        if (pattern.at(i) == QLatin1Char('\\')) {
+            // word boundaries and \K look at the text in front of the position
+            const QChar next = pattern.at(++i);
+            if (next == QLatin1Char('b') || next == QLatin1Char('B') || next == QLatin1Char('G') || next == QLatin1Char('K')) {
+                return false;
+            }
+        } else if (QStringView(pattern).mid(i).startsWith(QLatin1String("(?<=")) || QStringView(pattern).mid(i).startsWith(QLatin1String("(?<!"))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool KateCommands::SedReplace::InteractiveSedReplacer::replaceAllRemainingInLines()
+{
+    const int lastLine = m_doc->lines() - 1;
+    const int startLine = m_currentSearchPos.line();
+    const int endLine = qMin(m_endLine, lastLine);
+    if (startLine > endLine || !matchesIndependentOfReplacements(m_findPattern)) {
+        return false;
+    }
+
+    // like KateRegExpSearch::search() for a pattern matching within one line
+    QRegularExpression::PatternOptions options = QRegularExpression::UseUnicodePropertiesOption;
+    if (m_caseSensitive == Qt::CaseInsensitive) {
+        options |= QRegularExpression::CaseInsensitiveOption;
+    }
+    if (!QRegularExpression(m_findPattern, options).isValid()) {
+        return false;
+    }
+    bool multiLine = false;
+    const QString pattern = KateRegExpSearch::repairPattern(m_findPattern, multiLine);
+    if (multiLine) {
+        return false;
+    }
+
+    struct Replacement {
+        int start;
+        int end;
+        QString text;
+    };
+
+    // a replacement with a line break would move the following matches to another line
+    std::atomic<bool> lineBreakInserted{false};
+    const int startColumn = m_currentSearchPos.column();
+    const bool onlyOnePerLine = m_onlyOnePerLine;
+    // build() is const, all chunks share the parsed replacement
+    const KateRegExpSearch::ReplacementTemplate &replacementTemplate = m_replacement;
+    const auto makeTransform = [&]() {
+        return [&, regularExpression = QRegularExpression(pattern, options)](int line, const QString &text) {
+            std::vector<Replacement> replacements;
+            int offset = (line == startLine) ? startColumn : 0;
+            while (offset <= text.size() && !lineBreakInserted) {
+                // the search range ends with the document, it is empty at the end of the last line
+                if (line == lastLine && offset >= text.size()) {
+                    break;
+                }
+
+                const QRegularExpressionMatch match = regularExpression.match(text, offset);
+                if (!match.hasMatch()) {
+                    break;
+                }
+
+                // unmatched groups are empty, like the invalid capture ranges of fullCurrentMatch()
+                QStringList captureTexts;
+                captureTexts.reserve(regularExpression.captureCount() + 1);
+                for (int capture = 0; capture <= regularExpression.captureCount(); ++capture) {
+                    captureTexts << match.captured(capture);
+                }
+                const QString replacement = replacementTemplate.build(captureTexts, 0);
+                if (replacement.contains(QLatin1Char('\n'))) {
+                    lineBreakInserted = true;
+                    break;
+                }
+                replacements.push_back({int(match.capturedStart()), int(match.capturedEnd()), replacement});
+                if (onlyOnePerLine) {
+                    break;
+                }
+
+                // like replaceCurrentMatch(), step over empty matches
+                offset = match.capturedEnd() + (match.capturedLength() == 0 ? 1 : 0);
+            }
+            return replacements;
+        };
+    };
+    const std::vector<std::vector<Replacement>> replacementsOfLines =
+        KateLineTransform::transformLines<std::vector<Replacement>>(m_doc, startLine, endLine, makeTransform);
+    if (lineBreakInserted) {
+        return false;
+    }
+
+    // apply all replacements in order, the counting is the one of replaceCurrentMatch()
+    for (size_t i = 0; i < replacementsOfLines.size(); ++i) {
+        const int line = startLine + int(i);
+        int shift = 0;
+        for (const Replacement &replacement : replacementsOfLines[i]) {
+            const KTextEditor::Range range(line, replacement.start + shift, line, replacement.end + shift);
+            m_doc->removeText(range);
+            m_doc->insertText(range.start(), replacement.text);
+            shift += replacement.text.size() - (replacement.end - replacement.start);
+
+            m_numReplacementsDone++;
+            if (m_lastChangedLineNum != line) {
+                m_numLinesTouched++;
+            }
+            m_lastChangedLineNum = m_onlyOnePerLine ? line + 1 : line;
+        }
+    }
+
+    // nothing left to find
+    m_currentSearchPos = KTextEditor::Cursor(endLine + 1, 0);
+    return true;
+}
+
 QString KateCommands::SedReplace::InteractiveSedReplacer::currentMatchReplacementConfirmationMessage()
 {
     return i18n("replace with %1?", replacementTextForCurrentMatch().replace(QLatin1Char('\n'), QLatin1String("\\n")));
@@ -298,6 +422,6 @@ QString KateCommands::SedReplace::InteractiveSedReplacer::replacementTextForCurr
     for (KTextEditor::Range captureRange : captureRanges) {
         captureTexts << m_doc->text(captureRange);
     }
-    const QString replacementText = m_regExpSearch.buildReplacement(m_replacePattern, captureTexts, 0);
+    const QString replacementText = m_replacement.build(captureTexts, 0);
     return replacementText;
 }
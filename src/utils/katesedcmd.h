@@ -114,7 +114,8 @@ public:
 
     private:
         const QString m_findPattern;
-        const QString m_replacePattern;
+        // parsed once, used for every match
+        const KateRegExpSearch::ReplacementTemplate m_replacement;
         bool m_onlyOnePerLine;
         int m_endLine;
         KTextEditor::DocumentPrivate *m_doc;
@@ -128,6 +129,13 @@ public:
         KTextEditor::Cursor m_currentSearchPos;
         const QVector<KTextEditor::Range> fullCurrentMatch();
         QString replacementTextForCurrentMatch();
+
+        /**
+         * Replace all remaining matches by computing the replacements of all lines up front, in parallel for many lines.
+         * Only done if the result is the same as replacing match by match, e.g. not for patterns spanning lines.
+         * @return false if nothing was done and the matches must be replaced one by one
+         */
+        bool replaceAllRemainingInLines();
     };
 
 protected:
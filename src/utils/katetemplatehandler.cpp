@@ -83,6 +83,7 @@ KateTemplateHandler::KateTemplateHandler(KTextEditor::ViewPrivate *view,
         connect(doc(), &KTextEditor::Document::viewCreated, this, &KateTemplateHandler::slotViewCreated);
         connect(doc(), &KTextEditor::DocumentPrivate::textInsertedRange, this, &KateTemplateHandler::updateDependentFields);
         connect(doc(), &KTextEditor::DocumentPrivate::textRemoved, this, &KateTemplateHandler::updateDependentFields);
+        connect(doc(), &KTextEditor::DocumentPrivate::textReplayed, this, &KateTemplateHandler::slotTextReplayed);
         connect(doc(), &KTextEditor::Document::aboutToReload, this, &KateTemplateHandler::deleteLater);
 
     } else {
@@ -388,6 +389,11 @@ const KateTemplateHandler::TemplateField KateTemplateHandler::fieldForRange(KTex
     return {};
 }
 
+void KateTemplateHandler::slotTextReplayed(Document *document, LineRange lineRange)
+{
+    updateDependentFields(document, Range(lineRange.start(), 0, lineRange.end(), doc()->lineLength(lineRange.end())));
+}
+
 void KateTemplateHandler::updateDependentFields(Document *document, Range range)
 {
     Q_ASSERT(document == doc());
@@ -23,6 +23,7 @@ class KateUndoManager;
 namespace KTextEditor
 {
 class DocumentPrivate;
+class LineRange;
 class ViewPrivate;
 class MovingCursor;
 class MovingRange;
@@ -184,6 +185,11 @@ private Q_SLOTS:
      */
     void updateDependentFields(KTextEditor::Document *document, KTextEditor::Range oldRange);
 
+    /**
+     * Update the dependent fields after a large undo or redo, like for an edit of the changed lines.
+     */
+    void slotTextReplayed(KTextEditor::Document *document, KTextEditor::LineRange lineRange);
+
 public:
     KTextEditor::ViewPrivate *view() const;
     KTextEditor::DocumentPrivate *doc() const;
@@ -37,6 +37,7 @@
 #include "katecmd.h"
 #include "kateconfig.h"
 #include "kateglobal.h"
+#include "katereplaceinfiles.h"
 #include "katesyntaxmanager.h"
 
 using namespace KTextEditor;
@@ -137,6 +138,15 @@ const KSyntaxHighlighting::Repository &Editor::repository() const
     return KateHlManager::self()->repository();
 }
 
+QFuture<Editor::ReplaceResult> Editor::replaceInDocuments(const QList<KTextEditor::Document *> &documents,
+                                                          const QStringList &filePaths,
+                                                          const QString &pattern,
+                                                          const QString &replacement,
+                                                          KTextEditor::SearchOptions options)
+{
+    return KateReplaceInFiles::start(documents, filePaths, pattern, replacement, options);
+}
+
 bool View::insertText(const QString &text)
 {
     KTextEditor::Document *doc = document();
@@ -301,6 +301,11 @@ void KateStatusBar::selectionChanged()
 
 void KateStatusBar::viewModeChanged()
 {
+    // updated once the updates are no longer deferred
+    if (m_view->updatesDeferred()) {
+        return;
+    }
+
     // prepend BLOCK for block selection mode
     QString text = m_view->viewModeHuman();
     if (m_view->blockSelection()) {
@@ -312,6 +317,10 @@ void KateStatusBar::viewModeChanged()
 
 void KateStatusBar::cursorPositionChanged()
 {
+    if (m_view->updatesDeferred()) {
+        return;
+    }
+
     KTextEditor::Cursor position(m_view->cursorPositionVirtual());
     const int l = position.line() + 1;
     const int c = position.column() + 1;
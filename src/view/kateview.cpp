@@ -31,6 +31,7 @@
 #include "katekeywordcompletion.h"
 #include "katelayoutcache.h"
 #include "katemessagewidget.h"
+#include "katemultipatternsearch.h"
 #include "katemodemenu.h"
 #include "katepartdebug.h"
 #include "katerenderer.h"
@@ -2468,6 +2469,22 @@ void KTextEditor::ViewPrivate::editSetCursor(const KTextEditor::Cursor cursor)
 {
     m_viewInternal->editSetCursor(cursor);
 }
+
+void KTextEditor::ViewPrivate::startDeferredUpdates()
+{
+    m_deferredUpdates++;
+}
+
+void KTextEditor::ViewPrivate::endDeferredUpdates()
+{
+    Q_ASSERT(m_deferredUpdates > 0);
+    if (--m_deferredUpdates > 0) {
+        return;
+    }
+
+    m_viewInternal->endDeferredUpdates();
+    Q_EMIT viewModeChanged(this, viewMode());
+}
 // END
 
 // BEGIN TAG & CLEAR
@@ -3474,7 +3491,7 @@ QList<KTextEditor::CodeCompletionModel *> KTextEditor::ViewPrivate::codeCompleti
 
 bool KTextEditor::ViewPrivate::isAutomaticInvocationEnabled() const
 {
-    return !m_temporaryAutomaticInvocationDisabled && m_config->automaticCompletionInvocation();
+    return !m_temporaryAutomaticInvocationDisabled && !updatesDeferred() && m_config->automaticCompletionInvocation();
 }
 
 void KTextEditor::ViewPrivate::setAutomaticInvocationEnabled(bool enabled)
@@ -4844,9 +4861,6 @@ void KTextEditor::ViewPrivate::createHighlights()
     attr->setForeground(fgColor);
     attr->setBackground(bgColor);
 
-    KTextEditor::Cursor start(visibleRange().start());
-    KTextEditor::Range searchRange;
-
     // only add word boundary if we can find the text then
     // fixes $lala hl
     QString pattern = QRegularExpression::escape(m_currentTextForHighlights);
@@ -4858,24 +4872,18 @@ void KTextEditor::ViewPrivate::createHighlights()
         pattern += QLatin1String("\\b");
     }
 
-    QVector<KTextEditor::Range> matches;
-    do {
-        searchRange.setRange(start, visibleRange().end());
-
-        matches = doc()->searchText(searchRange, pattern, KTextEditor::Regex);
-
-        if (matches.first().isValid()) {
-            if (matches.first() != selectionRange()) {
-                std::unique_ptr<KTextEditor::MovingRange> mr(doc()->newMovingRange(matches.first()));
-                mr->setZDepth(-90000.0); // Set the z-depth to slightly worse than the selection
-                mr->setAttribute(attr);
-                mr->setView(this);
-                mr->setAttributeOnlyForViews(true);
-                m_rangesForHighlights.push_back(std::move(mr));
-            }
-            start = matches.first().end();
+    // all matches in one pass over the visible lines
+    const auto matches = KateMultiPatternSearch(doc(), {pattern}, KTextEditor::Regex).search(visibleRange());
+    for (const auto &match : matches) {
+        if (match.range != selectionRange()) {
+            std::unique_ptr<KTextEditor::MovingRange> mr(doc()->newMovingRange(match.range));
+            mr->setZDepth(-90000.0); // Set the z-depth to slightly worse than the selection
+            mr->setAttribute(attr);
+            mr->setView(this);
+            mr->setAttributeOnlyForViews(true);
+            m_rangesForHighlights.push_back(std::move(mr));
         }
-    } while (matches.first().isValid());
+    }
 }
 
 KateAbstractInputMode *KTextEditor::ViewPrivate::currentInputMode() const
@@ -463,6 +463,19 @@ public:
     void editEnd(int editTagLineStart, int editTagLineEnd, bool tagFrom);
 
     void editSetCursor(const KTextEditor::Cursor cursor);
+
+    /**
+     * Don't repaint scrolled contents, update the status bar or start automatic completion
+     * until the matching endDeferredUpdates(), e.g. while a vi macro is replayed.
+     * The start line still follows the cursor, for motions relative to the window.
+     * The view is updated once at the end, calls can be nested.
+     */
+    void startDeferredUpdates();
+    void endDeferredUpdates();
+    bool updatesDeferred() const
+    {
+        return m_deferredUpdates > 0;
+    }
     // END
 
     // BEGIN TAG & CLEAR
@@ -1205,6 +1218,11 @@ private:
      */
     bool m_temporaryAutomaticInvocationDisabled;
 
+    /**
+     * nesting level of startDeferredUpdates()
+     */
+    int m_deferredUpdates = 0;
+
 public:
     /**
      * Returns the attribute for the default style \p defaultStyle.
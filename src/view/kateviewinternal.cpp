@@ -516,6 +516,14 @@ void KateViewInternal::scrollPos(KTextEditor::Cursor &c, bool force, bool called
     // set false here but reversed if we return to makeVisible
     m_madeVisible = false;
 
+    // keep the start line and the layout cache up-to-date for motions relative to the window,
+    // but repaint and emit the signals once the updates are no longer deferred
+    if (view()->updatesDeferred()) {
+        updateView(false, viewLinesScrolledUsable ? viewLinesScrolled : 0);
+        m_scrolledWhileDeferred = true;
+        return;
+    }
+
     if (viewLinesScrolledUsable) {
         int lines = linesDisplayed();
         if (view()->textFolding().visibleLines() < lines) {
@@ -574,15 +582,19 @@ void KateViewInternal::scrollColumns(int x)
     int dx = startX() - x;
     m_startX = x;
 
-    if (qAbs(dx) < width()) {
-        // scroll excluding child widgets (floating notifications)
-        scroll(dx, 0, rect());
+    if (view()->updatesDeferred()) {
+        m_scrolledWhileDeferred = true;
     } else {
-        update();
-    }
+        if (qAbs(dx) < width()) {
+            // scroll excluding child widgets (floating notifications)
+            scroll(dx, 0, rect());
+        } else {
+            update();
+        }
 
-    Q_EMIT view()->horizontalScrollPositionChanged(m_view);
-    Q_EMIT view()->displayRangeChanged(m_view);
+        Q_EMIT view()->horizontalScrollPositionChanged(m_view);
+        Q_EMIT view()->displayRangeChanged(m_view);
+    }
 
     bool blocked = m_columnScroll->blockSignals(true);
     m_columnScroll->setValue(startX());
@@ -2747,6 +2759,7 @@ void KateViewInternal::updateCursor(const KTextEditor::Cursor newCursor, bool fo
     m_displayCursor = toVirtualCursor(newCursor);
     m_cursor.setPosition(newCursor);
 
+    // while updates are deferred, this only moves the start line, see scrollPos()
     if (m_view == doc()->activeView() && scroll) {
         makeVisible(m_displayCursor, m_displayCursor.column(), false, center, calledExternally);
     }
@@ -2788,6 +2801,23 @@ void KateViewInternal::updateCursor(const KTextEditor::Cursor newCursor, bool fo
     Q_EMIT view()->cursorPositionChanged(m_view, m_cursor);
 }
 
+void KateViewInternal::endDeferredUpdates()
+{
+    // scroll to the final cursor position, this updates the status bar, too
+    updateCursor(m_cursor, true);
+
+    if (!m_scrolledWhileDeferred) {
+        return;
+    }
+    m_scrolledWhileDeferred = false;
+
+    update();
+    m_leftBorder->update();
+    Q_EMIT view()->verticalScrollPositionChanged(m_view, startPos());
+    Q_EMIT view()->horizontalScrollPositionChanged(m_view);
+    Q_EMIT view()->displayRangeChanged(m_view);
+}
+
 void KateViewInternal::updateBracketMarkAttributes()
 {
     KTextEditor::Attribute::Ptr bracketFill = KTextEditor::Attribute::Ptr(new KTextEditor::Attribute());
@@ -2814,9 +2844,9 @@ void KateViewInternal::updateBracketMarkAttributes()
 
 void KateViewInternal::updateBracketMarks()
 {
-    // add some limit to this, this is really endless on big files without limit
-    const int maxLines = 5000;
-    const KTextEditor::Range newRange = doc()->findMatchingBracket(m_cursor, maxLines);
+    // no line limit needed, the buffer skips blocks without a match using their bracket summaries,
+    // only the highlighting of not yet highlighted lines is bounded
+    const KTextEditor::Range newRange = doc()->findMatchingBracket(m_cursor, -1, KTextEditor::DocumentPrivate::InteractiveBracketHighlightLimit);
 
     // new range valid, then set ranges to it
     if (newRange.isValid()) {
@@ -2974,13 +3004,15 @@ void KateViewInternal::paintCursor()
         updateDirty(); // paintText (0,0,width(), height(), true);
     }
 
+    // the cursors are sorted, only look at the ones around the displayed lines
     const int s = view()->firstDisplayedLine();
     const int e = view()->lastDisplayedLine();
-    for (const auto &c : view()->m_secondaryCursors) {
-        auto p = c.cursor();
-        if (p.line() >= s - 1 && p.line() <= e + 1) {
-            tagLines(p, p, true);
-        }
+    const auto &secondaryCursors = view()->m_secondaryCursors;
+    for (auto it = std::lower_bound(secondaryCursors.begin(), secondaryCursors.end(), KTextEditor::Cursor(qMax(0, s - 1), 0));
+         it != secondaryCursors.end() && it->cursor().line() <= e + 1;
+         ++it) {
+        const auto p = it->cursor();
+        tagLines(p, p, true);
     }
 
     updateDirty(); // paintText (0,0,width(), height(), true);
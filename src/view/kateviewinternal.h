@@ -312,6 +312,11 @@ private:
     void moveCursorToSelectionEdge(bool scroll = true);
     KTEXTEDITOR_NO_EXPORT
     void updateCursor(const KTextEditor::Cursor newCursor, bool force = false, bool center = false, bool calledExternally = false, bool scroll = true);
+    /**
+     * Repaint and emit the scroll signals skipped while the updates of the view were deferred.
+     */
+    KTEXTEDITOR_NO_EXPORT
+    void endDeferredUpdates();
     KTEXTEDITOR_NO_EXPORT
     void updateBracketMarks();
     KTEXTEDITOR_NO_EXPORT
@@ -401,6 +406,8 @@ private:
     // This is set to false on resize or scroll (other than that called by makeVisible),
     // so that makeVisible is again called when a key is pressed and the cursor is in the same spot
     bool m_madeVisible;
+    // The view scrolled while its updates were deferred, see endDeferredUpdates()
+    bool m_scrolledWhileDeferred = false;
     bool m_shiftKeyPressed;
 
     // How many lines to should be kept visible above/below the cursor when possible
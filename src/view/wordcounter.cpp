@@ -8,6 +8,8 @@
 #include "katedocument.h"
 #include "kateview.h"
 
+#include <algorithm>
+
 WordCounter::WordCounter(KTextEditor::ViewPrivate *view)
     : QObject(view)
     , m_wordsInDocument(0)
@@ -19,6 +21,7 @@ WordCounter::WordCounter(KTextEditor::ViewPrivate *view)
 {
     connect(view->doc(), &KTextEditor::DocumentPrivate::textInsertedRange, this, &WordCounter::textInserted);
     connect(view->doc(), &KTextEditor::DocumentPrivate::textRemoved, this, &WordCounter::textRemoved);
+    connect(view->doc(), &KTextEditor::DocumentPrivate::textReplayed, this, &WordCounter::textReplayed);
     connect(view->doc(), &KTextEditor::DocumentPrivate::loaded, this, &WordCounter::recalculate);
     connect(view, &KTextEditor::View::selectionChanged, this, &WordCounter::selectionChanged);
 
@@ -65,6 +68,13 @@ void WordCounter::textRemoved(KTextEditor::Document *, KTextEditor::Range range,
     }
 }
 
+void WordCounter::textReplayed(KTextEditor::Document *, KTextEditor::LineRange lineRange)
+{
+    // the line count is unchanged, just recount the lines
+    std::fill(m_countByLine.begin() + lineRange.start(), m_countByLine.begin() + lineRange.end() + 1, -1);
+    m_timer.start();
+}
+
 void WordCounter::recalculate(KTextEditor::Document *)
 {
     m_countByLine = std::vector<int>(m_document->lines(), -1);
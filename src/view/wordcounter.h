@@ -18,6 +18,7 @@ class Document;
 class View;
 class ViewPrivate;
 class Range;
+class LineRange;
 }
 
 class WordCounter : public QObject
@@ -33,6 +34,7 @@ Q_SIGNALS:
 private Q_SLOTS:
     void textInserted(KTextEditor::Document *document, KTextEditor::Range range);
     void textRemoved(KTextEditor::Document *document, KTextEditor::Range range, const QString &oldText);
+    void textReplayed(KTextEditor::Document *document, KTextEditor::LineRange lineRange);
     void recalculate(KTextEditor::Document *document);
     void selectionChanged(KTextEditor::View *view);
     void recalculateLines();
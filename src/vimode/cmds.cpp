@@ -10,18 +10,26 @@
 
 #include "globalstate.h"
 #include "katecmd.h"
+#include "katedocument.h"
 #include "kateview.h"
 #include "kateviinputmode.h"
 #include "marks.h"
 #include <vimode/emulatedcommandbar/emulatedcommandbar.h>
+#include <vimode/emulatedcommandbar/searchmode.h>
 #include <vimode/inputmodemanager.h>
+#include <vimode/keyparser.h>
 #include <vimode/modes/normalvimode.h>
 #include <vimode/searcher.h>
 
 #include <KLocalizedString>
 
+#include <KTextEditor/MovingRange>
+
 #include <QRegularExpression>
 
+#include <memory>
+#include <vector>
+
 using namespace KateVi;
 
 // BEGIN ViCommands
@@ -38,6 +46,15 @@ bool Commands::exec(KTextEditor::View *view, const QString &_cmd, QString &msg,
         return false;
     }
 
+    static const QRegularExpression globalCommand(QStringLiteral("^(?:g|global|v|vglobal)(?:\\W|$)"));
+    if (globalCommand.match(_cmd).hasMatch()) {
+        return global(v, _cmd, msg, range);
+    }
+    static const QRegularExpression normalCommand(QStringLiteral("^norm(?:al)?(?:[\\s!]|$)"));
+    if (normalCommand.match(_cmd).hasMatch()) {
+        return normal(v, _cmd, msg, range);
+    }
+
     // create a list of args
     QStringList args(_cmd.split(QRegularExpression(QStringLiteral("\\s+")), Qt::SkipEmptyParts));
     QString cmd(args.takeFirst());
@@ -169,13 +186,172 @@ bool Commands::exec(KTextEditor::View *view, const QString &_cmd, QString &msg,
     return false;
 }
 
+bool Commands::global(KTextEditor::ViewPrivate *view, const QString &cmd, QString &msg, KTextEditor::Range range)
+{
+    // [range]g[lobal][!]/{pattern}/{command}, g! and v[global] run the command on the lines not matching
+    static const QRegularExpression re(QStringLiteral("^(g|global|v|vglobal)(!?)\\s*([^\\w\\s\"|\\\\])"));
+    const QRegularExpressionMatch match = re.match(cmd);
+    if (!match.hasMatch()) {
+        msg = i18n("Missing pattern. Usage: %1/<pattern>/<command>", cmd.section(QLatin1Char('/'), 0, 0));
+        return false;
+    }
+    if (m_globalRunning) {
+        msg = i18n("Cannot use :%1 recursively", match.captured(1));
+        return false;
+    }
+
+    const bool invert = match.captured(1).startsWith(QLatin1Char('v')) || !match.captured(2).isEmpty();
+    const QChar delimiter = match.captured(3).at(0);
+    QString pattern;
+    int i = match.capturedEnd();
+    for (; i < cmd.size() && cmd.at(i) != delimiter; i++) {
+        if (cmd.at(i) == QLatin1Char('\\') && i + 1 < cmd.size()) {
+            // an escaped delimiter is part of the pattern
+            if (cmd.at(i + 1) != delimiter) {
+                pattern.append(cmd.at(i));
+            }
+            i++;
+        }
+        pattern.append(cmd.at(i));
+    }
+    const QString command = cmd.mid(i + 1).trimmed();
+    if (command.isEmpty()) {
+        msg = i18n("Missing command. Usage: %1/<pattern>/<command>", match.captured(1) + match.captured(2));
+        return false;
+    }
+
+    // an empty pattern repeats the last search, like n
+    Searcher::SearchParams searchParams;
+    if (pattern.isEmpty()) {
+        searchParams.pattern = m_viInputModeManager->searcher()->getLastSearchPattern();
+    } else {
+        searchParams.pattern = vimRegexToQtRegexPattern(pattern);
+        searchParams.isCaseSensitive = searchParams.pattern.toLower() != searchParams.pattern;
+        searchParams.pattern = withCaseSensitivityMarkersStripped(searchParams.pattern);
+    }
+
+    int startLine = 0;
+    int endLine = view->doc()->lastLine();
+    if (range.isValid()) {
+        startLine = qMin(range.start().line(), range.end().line());
+        endLine = qMax(range.start().line(), range.end().line());
+    }
+
+    // mark all lines first, the command may change the lines after the current one
+    const QVector<int> lines = m_viInputModeManager->searcher()->findMatchingLines(searchParams, startLine, endLine, invert);
+    if (lines.isEmpty()) {
+        msg = i18n("Pattern not found: %1", pattern.isEmpty() ? searchParams.pattern : pattern);
+        return false;
+    }
+
+    EmulatedCommandBar *commandBar = m_viInputModeManager->inputAdapter()->viModeEmulatedCommandBar();
+    QString response;
+    m_globalRunning = true;
+    forEachLine(view, lines, [commandBar, &command, &response]() {
+        response = commandBar->executeCommand(command);
+    });
+    m_globalRunning = false;
+
+    msg = response;
+    return true;
+}
+
+bool Commands::normal(KTextEditor::ViewPrivate *view, const QString &cmd, QString &msg, KTextEditor::Range range)
+{
+    // [range]norm[al][!] {keys}, the keys are typed in normal mode at the start of each line
+    static const QRegularExpression re(QStringLiteral("^norm(?:al)?!?\\s(.+)$"));
+    const QRegularExpressionMatch match = re.match(cmd);
+    if (!match.hasMatch()) {
+        msg = i18n("Missing argument. Usage: %1 <keys>", cmd.trimmed());
+        return false;
+    }
+    const QString keys = KeyParser::self()->encodeKeySequence(match.captured(1));
+    const QString escape = KeyParser::self()->encodeKeySequence(QStringLiteral("<esc>"));
+
+    int startLine = view->cursorPosition().line();
+    int endLine = startLine;
+    if (range.isValid()) {
+        startLine = qMin(range.start().line(), range.end().line());
+        endLine = qMax(range.start().line(), range.end().line());
+    }
+    QVector<int> lines;
+    lines.reserve(endLine - startLine + 1);
+    for (int line = startLine; line <= endLine; line++) {
+        lines.append(line);
+    }
+
+    // the keys must go to the view, not to the command bar executing this command
+    EmulatedCommandBar *commandBar = m_viInputModeManager->inputAdapter()->viModeEmulatedCommandBar();
+    if (commandBar->isActive()) {
+        Q_EMIT commandBar->hideMe();
+    }
+    view->setFocus();
+
+    InputModeManager *viInputModeManager = m_viInputModeManager;
+    forEachLine(view, lines, [viInputModeManager, commandBar, &keys, &escape]() {
+        viInputModeManager->feedKeyPresses(keys);
+
+        // an incomplete command is aborted, like with escape, a pending one like the d of :norm d too
+        while (commandBar->isActive() || viInputModeManager->getCurrentViMode() != ViMode::NormalMode) {
+            viInputModeManager->feedKeyPresses(escape);
+        }
+        viInputModeManager->getViNormalMode()->reset();
+    });
+
+    msg.clear();
+    return true;
+}
+
+void Commands::forEachLine(KTextEditor::ViewPrivate *view, const QVector<int> &lines, const std::function<void()> &function)
+{
+    KTextEditor::DocumentPrivate *doc = view->doc();
+
+    // like in vim, a line deleted or joined into another one by the function is skipped: a range covers each line
+    // with its line break, it gets empty on deletion and starts behind column 0 once joined into the previous line,
+    // the last line has no line break, it can only be tracked by its start
+    struct Mark {
+        std::unique_ptr<KTextEditor::MovingRange> range;
+        bool lastLine;
+    };
+    std::vector<Mark> marks;
+    marks.reserve(lines.size());
+    for (const int line : lines) {
+        const bool lastLine = line == doc->lastLine();
+        const KTextEditor::Range range = lastLine ? KTextEditor::Range(line, 0, line, doc->lineLength(line)) : KTextEditor::Range(line, 0, line + 1, 0);
+        const auto emptyBehavior = lastLine ? KTextEditor::MovingRange::AllowEmpty : KTextEditor::MovingRange::InvalidateIfEmpty;
+        marks.push_back({std::unique_ptr<KTextEditor::MovingRange>(doc->newMovingRange(range, KTextEditor::MovingRange::ExpandLeft, emptyBehavior)), lastLine});
+    }
+
+    // one undo step, the view scrolls and repaints once at the end
+    view->startDeferredUpdates();
+    doc->editBegin();
+    for (const Mark &mark : marks) {
+        const KTextEditor::Range range = mark.range->toRange();
+        if (!range.isValid() || range.start().column() != 0) {
+            continue;
+        }
+        view->setCursorPosition(KTextEditor::Cursor(mark.lastLine ? range.end().line() : range.end().line() - 1, 0));
+        function();
+    }
+    doc->editEnd();
+    view->endDeferredUpdates();
+    m_viInputModeManager->searcher()->highlightDeferredResults();
+}
+
 bool Commands::supportsRange(const QString &range)
 {
     static QStringList l;
 
     if (l.isEmpty()) {
         l << QStringLiteral("d") << QStringLiteral("delete") << QStringLiteral("j") << QStringLiteral("c") << QStringLiteral("change") << QStringLiteral("<")
-          << QStringLiteral(">") << QStringLiteral("y") << QStringLiteral("yank") << QStringLiteral("ma") << QStringLiteral("mark") << QStringLiteral("k");
+          << QStringLiteral(">") << QStringLiteral("y") << QStringLiteral("yank") << QStringLiteral("ma") << QStringLiteral("mark") << QStringLiteral("k")
+          << QStringLiteral("norm") << QStringLiteral("normal") << QStringLiteral("norm!") << QStringLiteral("normal!");
+    }
+
+    // :global has no space between the name and the pattern
+    static const QRegularExpression globalCommand(QStringLiteral("^(?:g|global|v|vglobal)(?:\\W|$)"));
+    if (globalCommand.match(range).hasMatch()) {
+        return true;
     }
 
     return l.contains(range.split(QLatin1Char(' ')).at(0));
@@ -15,10 +15,14 @@
 #include <vimode/commandinterface.h>
 
 #include <QStringList>
+#include <QVector>
+
+#include <functional>
 
 namespace KTextEditor
 {
 class DocumentPrivate;
+class ViewPrivate;
 }
 class KCompletion;
 
@@ -33,7 +37,8 @@ class Commands : public KTextEditor::Command, public KateViCommandInterface
         : KTextEditor::Command(QStringList() << mappingCommands() << QStringLiteral("d") << QStringLiteral("delete") << QStringLiteral("j")
                                              << QStringLiteral("c") << QStringLiteral("change") << QStringLiteral("<") << QStringLiteral(">")
                                              << QStringLiteral("y") << QStringLiteral("yank") << QStringLiteral("ma") << QStringLiteral("mark")
-                                             << QStringLiteral("k"))
+                                             << QStringLiteral("k") << QStringLiteral("g") << QStringLiteral("global") << QStringLiteral("v")
+                                             << QStringLiteral("vglobal") << QStringLiteral("norm") << QStringLiteral("normal"))
     {
     }
     static Commands *m_instance;
@@ -76,9 +81,22 @@ public:
     }
 
 private:
+    bool global(KTextEditor::ViewPrivate *view, const QString &cmd, QString &msg, KTextEditor::Range range);
+    bool normal(KTextEditor::ViewPrivate *view, const QString &cmd, QString &msg, KTextEditor::Range range);
+
+    /**
+     * Call @p function with the cursor at the start of each of @p lines, in one edit transaction and with
+     * deferred view updates. The lines are tracked while @p function adds or removes lines, lines it
+     * deletes or joins into others are skipped.
+     */
+    void forEachLine(KTextEditor::ViewPrivate *view, const QVector<int> &lines, const std::function<void()> &function);
+
     static const QStringList &mappingCommands();
     static Mappings::MappingMode modeForMapCommand(const QString &mapCommand);
     static bool isMapCommandRecursive(const QString &mapCommand);
+
+    // the command of :global can't be another :global
+    bool m_globalRunning = false;
 };
 
 /**
@@ -19,6 +19,7 @@
 
 #include "katecmds.h"
 #include "katecommandlinescript.h"
+#include "kateglobal.h"
 #include "katescriptmanager.h"
 #include "kateview.h"
 
@@ -49,7 +50,7 @@ CommandMode::CommandMode(EmulatedCommandBar *emulatedCommandBar,
     cmds.push_back(SedReplace::self());
     cmds.push_back(BufferCommands::self());
 
-    for (KTextEditor::Command *cmd : KateScriptManager::self()->commandLineScripts()) {
+    for (KTextEditor::Command *cmd : KTextEditor::EditorPrivate::self()->scriptManager()->commandLineScripts()) {
         cmds.push_back(cmd);
     }
 
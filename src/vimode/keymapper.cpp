@@ -85,16 +85,9 @@ bool KeyMapper::handleKeypress(QChar key)
         bool isFullMapping = false;
         m_fullMappingMatch.clear();
         const auto mappingMode = Mappings::mappingModeForCurrentViMode(m_viInputModeManager->inputAdapter());
-        const auto mappings = m_viInputModeManager->globalState()->mappings()->getAll(mappingMode, false, true);
-        for (const QString &mapping : mappings) {
-            if (mapping.startsWith(m_mappingKeys)) {
-                if (mapping == m_mappingKeys) {
-                    isFullMapping = true;
-                    m_fullMappingMatch = mapping;
-                } else {
-                    isPartialMapping = true;
-                }
-            }
+        m_viInputModeManager->globalState()->mappings()->match(mappingMode, m_mappingKeys, isFullMapping, isPartialMapping);
+        if (isFullMapping) {
+            m_fullMappingMatch = m_mappingKeys;
         }
         if (isFullMapping && !isPartialMapping) {
             // Great - m_mappingKeys is a mapping, and one that can't be extended to
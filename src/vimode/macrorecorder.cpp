@@ -8,9 +8,11 @@
 #include "completionrecorder.h"
 #include "completionreplayer.h"
 #include "globalstate.h"
+#include "katedocument.h"
 #include "kateview.h"
 #include "lastchangerecorder.h"
 #include "macros.h"
+#include "searcher.h"
 #include <vimode/inputmodemanager.h>
 #include <vimode/keymapper.h>
 
@@ -68,23 +70,33 @@ void MacroRecorder::dropLast()
     }
 }
 
-void MacroRecorder::replay(const QChar &macroRegister)
+void MacroRecorder::replay(const QChar &macroRegister, unsigned int count)
 {
     const QChar reg = (macroRegister == LastPlayedRegister) ? m_lastPlayedMacroRegister : macroRegister;
 
     m_lastPlayedMacroRegister = reg;
     const QString macroAsFeedableKeypresses = m_viInputModeManager->globalState()->macros()->get(reg);
+    const CompletionList completions = m_viInputModeManager->globalState()->macros()->getCompletions(reg);
 
-    std::shared_ptr<KeyMapper> mapper(new KeyMapper(m_viInputModeManager, m_viInputModeManager->view()->doc()));
-    CompletionList completions = m_viInputModeManager->globalState()->macros()->getCompletions(reg);
+    // All repetitions are one edit transaction, and the view doesn't scroll, update the status bar
+    // or highlight search results for each key press: update it once at the end.
+    KTextEditor::ViewPrivate *view = m_viInputModeManager->view();
+    view->startDeferredUpdates();
+    view->doc()->editBegin();
+    for (unsigned int i = 0; i < count; i++) {
+        std::shared_ptr<KeyMapper> mapper(new KeyMapper(m_viInputModeManager, view->doc()));
 
-    m_macrosBeingReplayedCount++;
-    m_viInputModeManager->completionReplayer()->start(completions);
-    m_viInputModeManager->pushKeyMapper(mapper);
-    m_viInputModeManager->feedKeyPresses(macroAsFeedableKeypresses);
-    m_viInputModeManager->popKeyMapper();
-    m_viInputModeManager->completionReplayer()->stop();
-    m_macrosBeingReplayedCount--;
+        m_macrosBeingReplayedCount++;
+        m_viInputModeManager->completionReplayer()->start(completions);
+        m_viInputModeManager->pushKeyMapper(mapper);
+        m_viInputModeManager->feedKeyPresses(macroAsFeedableKeypresses);
+        m_viInputModeManager->popKeyMapper();
+        m_viInputModeManager->completionReplayer()->stop();
+        m_macrosBeingReplayedCount--;
+    }
+    view->doc()->editEnd();
+    view->endDeferredUpdates();
+    m_viInputModeManager->searcher()->highlightDeferredResults();
 }
 
 bool MacroRecorder::isReplaying() const
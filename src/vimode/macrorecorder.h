@@ -30,7 +30,7 @@ public:
     void record(const QKeyEvent &event);
     void dropLast();
 
-    void replay(const QChar &macroRegister);
+    void replay(const QChar &macroRegister, unsigned int count = 1);
     bool isReplaying() const;
 
 private:
@@ -13,8 +13,18 @@
 
 #include <KConfigGroup>
 
+#include <algorithm>
+
 using namespace KateVi;
 
+template<typename Children>
+static auto findChild(Children &children, QChar key)
+{
+    return std::lower_bound(children.begin(), children.end(), key, [](const std::pair<QChar, int> &child, QChar value) {
+        return child.first < value;
+    });
+}
+
 void Mappings::readConfig(const KConfigGroup &config)
 {
     readMappings(config, QStringLiteral("Normal"), NormalModeMapping);
@@ -88,6 +98,9 @@ void Mappings::add(MappingMode mode, const QString &from, const QString &to, Map
     Mapping mapping = {encodedTo, (recursion == Recursive), false};
 
     // Add this mapping as is.
+    if (!m_mappings[mode].contains(encodedMapping)) {
+        addToTrie(mode, encodedMapping);
+    }
     m_mappings[mode][encodedMapping] = mapping;
 
     // In normal mode replace the <leader> with its value.
@@ -97,6 +110,9 @@ void Mappings::add(MappingMode mode, const QString &from, const QString &to, Map
         other = KeyParser::self()->encodeKeySequence(other);
         if (other != encodedMapping) {
             mapping.temporary = true;
+            if (!m_mappings[mode].contains(other)) {
+                addToTrie(mode, other);
+            }
             m_mappings[mode][other] = mapping;
         }
     }
@@ -105,12 +121,54 @@ void Mappings::add(MappingMode mode, const QString &from, const QString &to, Map
 void Mappings::remove(MappingMode mode, const QString &from)
 {
     const QString &encodedMapping = KeyParser::self()->encodeKeySequence(from);
-    m_mappings[mode].remove(encodedMapping);
+    if (m_mappings[mode].remove(encodedMapping)) {
+        removeFromTrie(mode, encodedMapping);
+    }
 }
 
 void Mappings::clear(MappingMode mode)
 {
     m_mappings[mode].clear();
+    m_tries[mode].clear();
+}
+
+void Mappings::addToTrie(MappingMode mode, const QString &encodedMapping)
+{
+    auto &trie = m_tries[mode];
+    if (trie.empty()) {
+        trie.emplace_back();
+    }
+
+    int node = 0;
+    trie[node].mappings++;
+    for (const QChar key : encodedMapping) {
+        auto &children = trie[node].children;
+        auto it = findChild(children, key);
+        if (it == children.end() || it->first != key) {
+            // trie might reallocate, don't use children after this
+            const int child = trie.size();
+            children.insert(it, {key, child});
+            trie.emplace_back();
+            node = child;
+        } else {
+            node = it->second;
+        }
+        trie[node].mappings++;
+    }
+    trie[node].isMapping = true;
+}
+
+void Mappings::removeFromTrie(MappingMode mode, const QString &encodedMapping)
+{
+    // the mapping is known to be in the trie, nodes without mappings are kept until clear()
+    auto &trie = m_tries[mode];
+    int node = 0;
+    trie[node].mappings--;
+    for (const QChar key : encodedMapping) {
+        node = findChild(trie[node].children, key)->second;
+        trie[node].mappings--;
+    }
+    trie[node].isMapping = false;
 }
 
 QString Mappings::get(MappingMode mode, const QString &from, bool decode, bool includeTemporary) const
@@ -160,6 +218,30 @@ bool Mappings::isRecursive(MappingMode mode, const QString &from) const
     return m_mappings[mode][from].recursive;
 }
 
+void Mappings::match(MappingMode mode, QStringView keys, bool &isFullMapping, bool &isPartialMapping) const
+{
+    isFullMapping = false;
+    isPartialMapping = false;
+
+    const auto &trie = m_tries[mode];
+    if (trie.empty() || keys.isEmpty()) {
+        return;
+    }
+
+    int node = 0;
+    for (const QChar key : keys) {
+        const auto &children = trie[node].children;
+        const auto it = findChild(children, key);
+        if (it == children.end() || it->first != key) {
+            return;
+        }
+        node = it->second;
+    }
+
+    isFullMapping = trie[node].isMapping;
+    isPartialMapping = trie[node].mappings > (isFullMapping ? 1 : 0);
+}
+
 void Mappings::setLeader(const QChar &leader)
 {
     m_leader = leader;
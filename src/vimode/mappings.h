@@ -8,8 +8,11 @@
 #define KATEVI_MAPPINGS_H
 
 #include <QHash>
+#include <QStringView>
 #include <ktexteditor_export.h>
 
+#include <vector>
+
 class KConfigGroup;
 class KateViInputMode;
 
@@ -34,6 +37,13 @@ public:
     QStringList getAll(MappingMode mode, bool decode = false, bool includeTemporary = false) const;
     bool isRecursive(MappingMode mode, const QString &from) const;
 
+    /**
+     * Look up the encoded, pending keys @p keys in the mappings for @p mode, temporary mappings included.
+     * @p isFullMapping is set if @p keys is a mapping, @p isPartialMapping if it is the start of a longer one.
+     * This takes time linear in the length of @p keys, independent of the number of mappings.
+     */
+    void match(MappingMode mode, QStringView keys, bool &isFullMapping, bool &isPartialMapping) const;
+
     void setLeader(const QChar &leader);
 
 public:
@@ -48,6 +58,10 @@ private:
     void writeMappings(KConfigGroup &config, const QString &mappingModeName, MappingMode mappingMode) const;
     KTEXTEDITOR_NO_EXPORT
     void readMappings(const KConfigGroup &config, const QString &mappingModeName, MappingMode mappingMode);
+    KTEXTEDITOR_NO_EXPORT
+    void addToTrie(MappingMode mode, const QString &encodedMapping);
+    KTEXTEDITOR_NO_EXPORT
+    void removeFromTrie(MappingMode mode, const QString &encodedMapping);
 
 private:
     typedef struct {
@@ -64,6 +78,19 @@ private:
     typedef QHash<QString, Mapping> MappingList;
 
     MappingList m_mappings[4];
+
+    // Prefix tree of the encoded keys in m_mappings, per mode, node 0 is the root.
+    struct TrieNode {
+        // Sorted by key.
+        std::vector<std::pair<QChar, int>> children;
+
+        // Number of mappings starting with the keys leading to this node, including itself.
+        int mappings = 0;
+
+        // True if the keys leading to this node are a mapping.
+        bool isMapping = false;
+    };
+    std::vector<TrieNode> m_tries[4];
     QChar m_leader;
 };
 
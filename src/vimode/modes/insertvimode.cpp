@@ -46,6 +46,7 @@ InsertViMode::InsertViMode(InputModeManager *viInputModeManager, KTextEditor::Vi
     m_isExecutingCompletion = false;
 
     connect(doc(), &KTextEditor::DocumentPrivate::textInsertedRange, this, &InsertViMode::textInserted);
+    connect(doc(), &KTextEditor::DocumentPrivate::textReplayed, this, &InsertViMode::textReplayed);
 }
 
 InsertViMode::~InsertViMode() = default;
@@ -584,3 +585,9 @@ void InsertViMode::textInserted(KTextEditor::Document *document, KTextEditor::Ra
         m_textInsertedByCompletionEndPos = range.end();
     }
 }
+
+void InsertViMode::textReplayed(KTextEditor::Document *document, KTextEditor::LineRange lineRange)
+{
+    // a large undo or redo of changes within lines, the single insertions are unknown, take the changed lines
+    textInserted(document, KTextEditor::Range(lineRange.start(), 0, lineRange.end(), document->lineLength(lineRange.end())));
+}
@@ -14,6 +14,7 @@
 
 namespace KTextEditor
 {
+class LineRange;
 class ViewPrivate;
 }
 class KateViewInternal;
@@ -94,6 +95,8 @@ protected:
 private:
     KTEXTEDITOR_NO_EXPORT
     void textInserted(KTextEditor::Document *document, KTextEditor::Range range);
+    KTEXTEDITOR_NO_EXPORT
+    void textReplayed(KTextEditor::Document *document, KTextEditor::LineRange lineRange);
 };
 }
 
@@ -448,6 +448,7 @@ void NormalViMode::beginMonitoringDocumentChanges()
 {
     connect(doc(), &KTextEditor::DocumentPrivate::textInsertedRange, this, &NormalViMode::textInserted);
     connect(doc(), &KTextEditor::DocumentPrivate::textRemoved, this, &NormalViMode::textRemoved);
+    connect(doc(), &KTextEditor::DocumentPrivate::textReplayed, this, &NormalViMode::textReplayed);
 }
 
 void NormalViMode::executeCommand(const Command *cmd)
@@ -1900,11 +1901,7 @@ bool NormalViMode::commandReplayMacro()
     const QChar reg = m_keys[m_keys.size() - 1];
     const unsigned int count = getCount();
     resetParser();
-    doc()->editBegin();
-    for (unsigned int i = 0; i < count; i++) {
-        m_viInputModeManager->macroRecorder()->replay(reg);
-    }
-    doc()->editEnd();
+    m_viInputModeManager->macroRecorder()->replay(reg, count);
     return true;
 }
 
@@ -3911,6 +3908,19 @@ void NormalViMode::textInserted(KTextEditor::Document *document, KTextEditor::Ra
     }
 }
 
+void NormalViMode::textReplayed(KTextEditor::Document *document, KTextEditor::LineRange lineRange)
+{
+    if (m_viInputModeManager->view()->viewInputMode() != KTextEditor::View::ViInputMode) {
+        return;
+    }
+
+    Q_UNUSED(document);
+    // a large undo or redo of changes within lines, mark the changed lines like an undo of single line changes
+    m_viInputModeManager->marks()->setStartEditYanked(KTextEditor::Cursor(lineRange.start(), 0));
+    m_viInputModeManager->marks()->setFinishEditYanked(KTextEditor::Cursor(lineRange.end(), 0));
+    m_viInputModeManager->marks()->setLastChange(KTextEditor::Cursor(lineRange.end(), 0));
+}
+
 void NormalViMode::textRemoved(KTextEditor::Document *document, KTextEditor::Range range)
 {
     if (m_viInputModeManager->view()->viewInputMode() != KTextEditor::View::ViInputMode) {
@@ -383,6 +383,8 @@ private:
     KTEXTEDITOR_NO_EXPORT
     void textRemoved(KTextEditor::Document *, KTextEditor::Range);
     KTEXTEDITOR_NO_EXPORT
+    void textReplayed(KTextEditor::Document *, KTextEditor::LineRange lineRange);
+    KTEXTEDITOR_NO_EXPORT
     void undoBeginning();
     KTEXTEDITOR_NO_EXPORT
     void undoEnded();
@@ -8,11 +8,14 @@
 #include "globalstate.h"
 #include "history.h"
 #include "katedocument.h"
+#include "kateregexpsearch.h"
 #include "katerenderer.h"
 #include "kateview.h"
 #include <vimode/inputmodemanager.h>
 #include <vimode/modes/modebase.h>
 
+#include <QRegularExpression>
+
 using namespace KateVi;
 
 Searcher::Searcher(InputModeManager *manager)
@@ -32,6 +35,7 @@ Searcher::~Searcher()
 {
     disconnectSignals();
     clearHighlights();
+    qDeleteAll(m_unusedHlRanges);
 }
 
 const QString Searcher::getLastSearchPattern() const
@@ -145,11 +149,42 @@ KTextEditor::Range Searcher::findPattern(const SearchParams &searchParams, const
     return r;
 }
 
+QVector<int> Searcher::findMatchingLines(const SearchParams &searchParams, int startLine, int endLine, bool invert) const
+{
+    QVector<int> lines;
+
+    // one expression for all lines, searching them one by one with searchText() would compile it per line
+    QRegularExpression::PatternOptions options = QRegularExpression::UseUnicodePropertiesOption;
+    if (!searchParams.isCaseSensitive) {
+        options |= QRegularExpression::CaseInsensitiveOption;
+    }
+    const QRegularExpression regex(searchParams.pattern, options);
+    if (!regex.isValid()) {
+        return lines;
+    }
+
+    const KTextEditor::DocumentPrivate *doc = m_view->doc();
+    const int lastLine = qMin(endLine, doc->lastLine());
+    for (int line = qMax(0, startLine); line <= lastLine; line++) {
+        if (regex.match(doc->line(line)).hasMatch() != invert) {
+            lines.append(line);
+        }
+    }
+    return lines;
+}
+
 void Searcher::highlightVisibleResults(const SearchParams &searchParams, bool force)
 {
     if (newPattern && searchParams.pattern.isEmpty())
         return;
 
+    // the visible range is only known once the view scrolled to the cursor again
+    if (m_view->updatesDeferred()) {
+        m_hasDeferredHighlight = true;
+        m_deferredHlSearchConfig = searchParams;
+        return;
+    }
+
     auto vr = m_view->visibleRange();
 
     const SearchParams &l = searchParams;
@@ -159,47 +194,159 @@ void Searcher::highlightVisibleResults(const SearchParams &searchParams, bool fo
         return;
     }
 
+    // the matches found so far are only valid for the same pattern in the same text
+    const qint64 revision = m_view->doc()->revision();
+    if (l.pattern != r.pattern || l.isCaseSensitive != r.isCaseSensitive || revision != m_hlMatchesRevision) {
+        clearHighlights();
+        m_hlMatchesOfLine.clear();
+        m_hlMatchesRevision = revision;
+
+        QRegularExpression::PatternOptions options = QRegularExpression::UseUnicodePropertiesOption;
+        if (!searchParams.isCaseSensitive) {
+            options |= QRegularExpression::CaseInsensitiveOption;
+        }
+        m_hlMultiLine = false;
+        m_hlRegex = QRegularExpression(searchParams.pattern, options);
+        if (m_hlRegex.isValid()) {
+            m_hlRegex.setPattern(KateRegExpSearch::repairPattern(searchParams.pattern, m_hlMultiLine));
+        }
+    }
+
     m_lastHlSearchConfig = searchParams;
     m_lastHlSearchRange = vr;
+    m_lastSearchWrapped = false;
 
-    clearHighlights();
+    if (!vr.isValid()) {
+        return;
+    }
+    const int startLine = vr.start().line();
+    const int endLine = vr.end().line();
+
+    // lines scrolled out of view give their ranges back
+    for (auto it = m_hlRangesOfLine.begin(); it != m_hlRangesOfLine.end();) {
+        if (it.key() < startLine || it.key() > endLine) {
+            releaseHighlightRanges(it.value());
+            it = m_hlRangesOfLine.erase(it);
+        } else {
+            ++it;
+        }
+    }
 
-    KTextEditor::SearchOptions flags = KTextEditor::Regex;
-    m_lastSearchWrapped = false;
+    // only the lines not searched before are searched, the lines still visible keep their ranges
+    searchHighlightLines(startLine, endLine);
+    for (int line = startLine; line <= endLine; ++line) {
+        if (m_hlRangesOfLine.contains(line)) {
+            continue;
+        }
+        const QVector<KTextEditor::Range> matches = m_hlMatchesOfLine.value(line);
+        if (matches.isEmpty()) {
+            continue;
+        }
+        QVector<KTextEditor::MovingRange *> &ranges = m_hlRangesOfLine[line];
+        ranges.reserve(matches.size());
+        for (const KTextEditor::Range &match : matches) {
+            ranges.append(highlightRange(match));
+        }
+    }
+}
 
-    const QString &pattern = searchParams.pattern;
+void Searcher::searchHighlightLines(int startLine, int endLine)
+{
+    // bound the memory for a long scroll through a huge document
+    static constexpr int maxCachedLines = 100000;
+    if (m_hlMatchesOfLine.size() > maxCachedLines) {
+        m_hlMatchesOfLine.clear();
+    }
 
-    if (!searchParams.isCaseSensitive) {
+    const KTextEditor::DocumentPrivate *doc = m_view->doc();
+    KTextEditor::SearchOptions flags = KTextEditor::Regex;
+    if (!m_lastHlSearchConfig.isCaseSensitive) {
         flags |= KTextEditor::CaseInsensitive;
     }
 
-    KTextEditor::Range match;
-    KTextEditor::Cursor current(vr.start());
-
-    do {
-        match = m_view->doc()->searchText(KTextEditor::Range(current, vr.end()), pattern, flags).first();
-        if (match.isValid()) {
-            if (match.isEmpty())
-                match = KTextEditor::Range(match.start(), 1);
+    for (int line = startLine; line <= endLine; ++line) {
+        if (m_hlMatchesOfLine.contains(line)) {
+            continue;
+        }
 
-            auto highlight = m_view->doc()->newMovingRange(match, Kate::TextRange::DoNotExpand);
-            highlight->setView(m_view);
-            highlight->setAttributeOnlyForViews(true);
-            highlight->setZDepth(-10000.0);
-            highlight->setAttribute(highlightMatchAttribute);
-            m_hlRanges.append(highlight);
+        // an empty pattern matches nothing, like in the document search
+        QVector<KTextEditor::Range> &matches = m_hlMatchesOfLine[line];
+        if (!m_hlRegex.isValid() || m_lastHlSearchConfig.pattern.isEmpty()) {
+            continue;
+        }
 
-            current = match.end();
+        if (!m_hlMultiLine) {
+            auto it = m_hlRegex.globalMatch(doc->line(line));
+            while (it.hasNext()) {
+                const QRegularExpressionMatch match = it.next();
+                matches.append(KTextEditor::Range(KTextEditor::Cursor(line, match.capturedStart()), qMax(1, int(match.capturedLength()))));
+            }
+            continue;
         }
-    } while (match.isValid() && current < vr.end());
+
+        // matches spanning lines are found with the document search, they belong to the line they start in
+        const KTextEditor::Cursor lineEnd(line, doc->lineLength(line));
+        KTextEditor::Cursor current(line, 0);
+        KTextEditor::Range match;
+        do {
+            match = doc->searchText(KTextEditor::Range(current, doc->documentEnd()), m_lastHlSearchConfig.pattern, flags).first();
+            if (match.isValid() && match.start() <= lineEnd) {
+                if (match.isEmpty())
+                    match = KTextEditor::Range(match.start(), 1);
+                matches.append(match);
+                current = match.end();
+            }
+        } while (match.isValid() && match.start() <= lineEnd && current <= lineEnd);
+    }
+}
+
+KTextEditor::MovingRange *Searcher::highlightRange(KTextEditor::Range range)
+{
+    if (!m_unusedHlRanges.isEmpty()) {
+        KTextEditor::MovingRange *highlight = m_unusedHlRanges.takeLast();
+        highlight->setRange(range);
+        return highlight;
+    }
+
+    auto highlight = m_view->doc()->newMovingRange(range, Kate::TextRange::DoNotExpand);
+    highlight->setView(m_view);
+    highlight->setAttributeOnlyForViews(true);
+    highlight->setZDepth(-10000.0);
+    highlight->setAttribute(highlightMatchAttribute);
+    return highlight;
+}
+
+void Searcher::releaseHighlightRanges(QVector<KTextEditor::MovingRange *> &ranges)
+{
+    // invalid ranges are not rendered and cost nothing on edits
+    for (KTextEditor::MovingRange *highlight : std::as_const(ranges)) {
+        highlight->setRange(KTextEditor::Range::invalid());
+        m_unusedHlRanges.append(highlight);
+    }
+    ranges.clear();
+}
+
+void Searcher::highlightDeferredResults()
+{
+    if (!m_hasDeferredHighlight || m_view->updatesDeferred()) {
+        return;
+    }
+
+    m_hasDeferredHighlight = false;
+    if (m_hlMode == HighlightMode::Enable) {
+        highlightVisibleResults(m_deferredHlSearchConfig, true);
+    }
 }
 
 void Searcher::clearHighlights()
 {
-    if (!m_hlRanges.empty()) {
-        qDeleteAll(m_hlRanges);
-        m_hlRanges.clear();
+    for (auto &ranges : m_hlRangesOfLine) {
+        releaseHighlightRanges(ranges);
     }
+    m_hlRangesOfLine.clear();
+
+    // nothing is highlighted, the next highlight request must not be skipped
+    m_lastHlSearchRange = KTextEditor::Range::invalid();
 }
 
 void Searcher::hideCurrentHighlight()
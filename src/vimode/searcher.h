@@ -11,7 +11,10 @@
 #include "ktexteditor/range.h"
 #include <vimode/range.h>
 
+#include <QHash>
+#include <QRegularExpression>
 #include <QString>
+#include <QVector>
 
 namespace KTextEditor
 {
@@ -48,6 +51,12 @@ public:
     };
     KTextEditor::Range findPattern(const SearchParams &searchParams, const KTextEditor::Cursor startFrom, int count, bool addToSearchHistory = true);
 
+    /**
+     * The lines in [startLine, endLine] with a match of @p searchParams, or without one if @p invert is set,
+     * e.g. for :global. Matches can't span lines.
+     */
+    QVector<int> findMatchingLines(const SearchParams &searchParams, int startLine, int endLine, bool invert) const;
+
     const QString getLastSearchPattern() const;
     bool lastSearchWrapped() const;
     void setLastSearchParams(const SearchParams &searchParams);
@@ -58,12 +67,16 @@ public:
     void updateHighlightColors();
     void clearHighlights();
     void patternDone(bool wasAborted);
+    void highlightDeferredResults();
 
 private:
     Range findPatternForMotion(const SearchParams &searchParams, const KTextEditor::Cursor startFrom, int count = 1);
     KTextEditor::Range findPatternWorker(const SearchParams &searchParams, const KTextEditor::Cursor startFrom, int count);
 
     void highlightVisibleResults(const SearchParams &searchParams, bool force = false);
+    void searchHighlightLines(int startLine, int endLine);
+    KTextEditor::MovingRange *highlightRange(KTextEditor::Range range);
+    void releaseHighlightRanges(QVector<KTextEditor::MovingRange *> &ranges);
     void disconnectSignals();
     void connectSignals();
 
@@ -81,13 +94,27 @@ private:
     bool m_lastSearchWrapped;
 
     HighlightMode m_hlMode{HighlightMode::Enable};
-    QList<KTextEditor::MovingRange *> m_hlRanges;
     SearchParams m_lastHlSearchConfig;
     KTextEditor::Range m_lastHlSearchRange;
+
+    // the highlights of the visible lines, scrolling reuses the ranges of the lines no longer visible
+    QHash<int, QVector<KTextEditor::MovingRange *>> m_hlRangesOfLine;
+    QVector<KTextEditor::MovingRange *> m_unusedHlRanges;
+
+    // the matches of m_lastHlSearchConfig in all lines searched so far, valid for m_hlMatchesRevision
+    QHash<int, QVector<KTextEditor::Range>> m_hlMatchesOfLine;
+    qint64 m_hlMatchesRevision{-1};
+    QRegularExpression m_hlRegex;
+    bool m_hlMultiLine{false};
+
     KTextEditor::Attribute::Ptr highlightMatchAttribute;
     QMetaObject::Connection m_displayRangeChangedConnection;
     QMetaObject::Connection m_textChangedConnection;
     bool newPattern{true};
+
+    // highlighting requested while the view updates were deferred, e.g. during a macro
+    bool m_hasDeferredHighlight{false};
+    SearchParams m_deferredHlSearchConfig;
 };
 }
 